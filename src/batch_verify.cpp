@@ -0,0 +1,73 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include <variant>
+
+#include "analysis_context.hpp"
+#include "batch_verify.hpp"
+#include "crab_utils/thread_pool.hpp"
+#include "ir/unmarshal.hpp"
+#include "verifier.hpp"
+
+namespace prevail {
+
+static ProgramVerification verify_one(const RawProgram& raw_prog, const VerifierOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    // Release this worker's SplitDBM scratch between programs.
+    ThreadLocalGuard clear_thread_local_state;
+
+    ProgramVerification res{.section_name = raw_prog.section_name, .function_name = raw_prog.function_name};
+    try {
+        auto start = Clock::now();
+        auto prog_or_error = unmarshal(raw_prog, options);
+        res.timings.unmarshal = Clock::now() - start;
+        if (const auto error = std::get_if<std::string>(&prog_or_error)) {
+            res.load_error = "unmarshaling error at " + *error;
+            return res;
+        }
+
+        start = Clock::now();
+        Program prog = Program::from_sequence(std::get<InstructionSeq>(prog_or_error), raw_prog.info, options);
+        res.timings.cfg = Clock::now() - start;
+
+        start = Clock::now();
+        const AnalysisContext context{std::move(prog), options};
+        const AnalysisResult result = analyze(context);
+        res.timings.analysis = Clock::now() - start;
+
+        res.failed = result.failed;
+        res.first_error = result.find_first_error();
+        res.max_loop_count = result.max_loop_count;
+        res.tier = result.tier;
+        res.interruption = result.interruption;
+    } catch (const InternalError& e) {
+        res.load_error = e.what();
+        res.internal_error = true;
+    } catch (const std::exception& e) {
+        res.load_error = e.what();
+    }
+    return res;
+}
+
+std::vector<ProgramVerification> verify_all(ElfObject& elf, const VerifierOptions& options, size_t jobs) {
+    // ElfObject is not thread-safe: load every program on the calling thread first.
+    const std::vector<RawProgram>& raw_progs = elf.get_programs();
+
+    VerifierOptions analysis_options = options;
+    analysis_options.retain_invariants = false;
+
+    if (jobs == 0) {
+        jobs = ThreadPool::default_concurrency();
+    }
+    std::vector<ProgramVerification> results(raw_progs.size());
+    ThreadPool pool{std::min(jobs, raw_progs.size())};
+    for (size_t i = 0; i < raw_progs.size(); ++i) {
+        pool.submit([&, i] { results[i] = verify_one(raw_progs[i], analysis_options); });
+    }
+    pool.wait();
+    return results;
+}
+
+} // namespace prevail
@@ -0,0 +1,59 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "config.hpp"
+#include "crab/ebpf_domain.hpp"
+#include "io/elf_loader.hpp"
+#include "result.hpp"
+
+namespace prevail {
+
+/// Outcome of verifying one program of an object with verify_all().
+///
+/// Only plain values are kept: abstract states name their variables through
+/// the registry of the worker thread that analyzed them, so a full
+/// AnalysisResult would be meaningless once handed back to the caller.
+struct ProgramVerification {
+    std::string section_name;
+    std::string function_name;
+
+    /// Set when the program could not be analyzed at all (unmarshaling error,
+    /// invalid control flow, ...). Such a program counts as failed.
+    std::optional<std::string> load_error;
+    /// True if `load_error` came from an InternalError, i.e., a verifier bug.
+    bool internal_error{};
+
+    bool failed = true;
+    std::optional<VerificationError> first_error;
+    int max_loop_count{};
+    AnalysisTier tier = AnalysisTier::zones;
+    /// Set if the analysis was stopped by one of VerifierOptions::limits.
+    std::optional<AnalysisInterruption> interruption;
+
+    struct Timings {
+        std::chrono::nanoseconds unmarshal{};
+        std::chrono::nanoseconds cfg{};
+        std::chrono::nanoseconds analysis{};
+    };
+    Timings timings;
+};
+
+/// Unmarshal, build the CFG of and analyze every loadable program of `elf`,
+/// running up to `jobs` programs concurrently (0 means one per hardware thread).
+/// Results are in the order of `elf.get_programs()`, whatever the completion
+/// order. A program that fails to load or analyze does not stop the others.
+/// Analyses run in verdict mode (see VerifierOptions::retain_invariants) since
+/// their invariants are not returned. VerifierOptions::limits apply to each
+/// analysis separately, except that cancelling the token stops all of them.
+///
+/// @throws RuntimeInputError if the object has no loadable program.
+std::vector<ProgramVerification> verify_all(ElfObject& elf, const VerifierOptions& options, size_t jobs = 0);
+
+} // namespace prevail
@@ -6,8 +6,11 @@
  * a CFG to interface with the fixpoint iterators.
  */
 #include <map>
+#include <memory>
+#include <optional>
 #include <ranges>
 #include <set>
+#include <span>
 #include <vector>
 
 #include "cfg/label.hpp"
@@ -15,60 +18,82 @@
 
 namespace prevail {
 
-/// Control-Flow Graph
-class Cfg final {
-    friend struct CfgBuilder;
+/// Dense index of a label within one Cfg. Ids are assigned in Label order, so walking
+/// ids 0..size()-1 visits labels in the same order as an ordered map keyed by Label.
+using LabelId = uint32_t;
 
-    // the choice to use set means that unmarshaling a conditional jump to the same target may be different
-    using LabelVec = std::set<Label>;
+/// Immutable, sorted list of the labels of one Cfg. Shared between copies of the Cfg
+/// and the analysis results computed over it, so mapping a LabelId back to its Label
+/// never needs the Program to be alive.
+class LabelIndex final {
+    std::vector<Label> m_labels;
 
-    struct Adjacent final {
-        LabelVec parents;
-        LabelVec children;
+  public:
+    explicit LabelIndex(std::vector<Label> sorted_labels) : m_labels(std::move(sorted_labels)) {}
 
-        [[nodiscard]]
-        size_t in_degree() const {
-            return parents.size();
+    [[nodiscard]]
+    std::optional<LabelId> find(const Label& label) const {
+        const auto it = std::ranges::lower_bound(m_labels, label);
+        if (it == m_labels.end() || *it != label) {
+            return std::nullopt;
         }
+        return gsl::narrow<LabelId>(it - m_labels.begin());
+    }
 
-        [[nodiscard]]
-        size_t out_degree() const {
-            return children.size();
+    [[nodiscard]]
+    LabelId id_of(const Label& label) const {
+        if (const auto id = find(label)) {
+            return *id;
         }
-    };
-
-    std::map<Label, Adjacent> neighbours{{Label::entry, Adjacent{}}, {Label::exit, Adjacent{}}};
+        CRAB_ERROR("Label ", to_string(label), " not found in the CFG: ");
+    }
 
-    // Helpers
     [[nodiscard]]
-    bool has_one_child(const Label& label) const {
-        return out_degree(label) == 1;
+    const Label& label_of(const LabelId id) const {
+        return m_labels[id];
     }
 
     [[nodiscard]]
-    bool has_one_parent(const Label& label) const {
-        return in_degree(label) == 1;
+    const std::vector<Label>& labels() const {
+        return m_labels;
     }
 
     [[nodiscard]]
-    Adjacent& get_node(const Label& _label) {
-        const auto it = neighbours.find(_label);
-        if (it == neighbours.end()) {
-            CRAB_ERROR("Label ", to_string(_label), " not found in the CFG: ");
-        }
-        return it->second;
+    size_t size() const {
+        return m_labels.size();
     }
+};
+
+/// Control-Flow Graph
+///
+/// Every label is interned once to a dense LabelId; adjacency is stored in flat vectors
+/// indexed by that id. The Label-keyed accessors are a binary search followed by the
+/// id-keyed one and are meant for callers outside the fixpoint iterator.
+class Cfg final {
+    friend struct CfgBuilder;
+
+    struct Adjacent final {
+        // Sorted by id, hence by Label.
+        std::vector<LabelId> parents;
+        std::vector<LabelId> children;
+    };
+
+    std::shared_ptr<const LabelIndex> m_index;
+    std::vector<Adjacent> m_nodes;
+    LabelId m_entry{};
+    LabelId m_exit{};
 
     [[nodiscard]]
-    const Adjacent& get_node(const Label& _label) const {
-        const auto it = neighbours.find(_label);
-        if (it == neighbours.end()) {
-            CRAB_ERROR("Label ", to_string(_label), " not found in the CFG: ");
-        }
-        return it->second;
+    auto to_labels(const std::span<const LabelId> ids) const {
+        return ids | std::views::transform([index = m_index.get()](const LabelId id) -> const Label& {
+                   return index->label_of(id);
+               });
     }
 
   public:
+    // The graph with only entry and exit, unconnected. Anything larger is built by CfgBuilder.
+    Cfg();
+
     [[nodiscard]]
     Label exit_label() const {
         return Label::exit;
@@ -80,60 +105,97 @@ class Cfg final {
     }
 
     [[nodiscard]]
-    const LabelVec& children_of(const Label& _label) const {
-        return get_node(_label).children;
+    LabelId exit_id() const {
+        return m_exit;
+    }
+
+    [[nodiscard]]
+    LabelId entry_id() const {
+        return m_entry;
+    }
+
+    [[nodiscard]]
+    const std::shared_ptr<const LabelIndex>& label_index() const {
+        return m_index;
+    }
+
+    [[nodiscard]]
+    LabelId id_of(const Label& label) const {
+        return m_index->id_of(label);
+    }
+
+    [[nodiscard]]
+    const Label& label_of(const LabelId id) const {
+        return m_index->label_of(id);
+    }
+
+    [[nodiscard]]
+    std::span<const LabelId> children_of(const LabelId id) const {
+        return m_nodes[id].children;
+    }
+
+    [[nodiscard]]
+    std::span<const LabelId> parents_of(const LabelId id) const {
+        return m_nodes[id].parents;
+    }
+
+    [[nodiscard]]
+    auto children_of(const Label& _label) const {
+        return to_labels(children_of(id_of(_label)));
     }
 
     [[nodiscard]]
-    const LabelVec& parents_of(const Label& _label) const {
-        return get_node(_label).parents;
+    auto parents_of(const Label& _label) const {
+        return to_labels(parents_of(id_of(_label)));
     }
 
-    //! return a view of the labels, including entry and exit
+    //! return the labels in id order, including entry and exit
     [[nodiscard]]
-    auto labels() const {
-        return std::views::keys(neighbours);
+    const std::vector<Label>& labels() const {
+        return m_index->labels();
     }
 
     [[nodiscard]]
     size_t size() const {
-        return neighbours.size();
+        return m_nodes.size();
     }
 
     [[nodiscard]]
     Label get_child(const Label& label) const {
-        if (!has_one_child(label)) {
+        const auto children = children_of(id_of(label));
+        if (children.size() != 1) {
             CRAB_ERROR("Label ", to_string(label), " does not have a single child");
         }
-        return *get_node(label).children.begin();
+        return label_of(children.front());
     }
 
     [[nodiscard]]
     Label get_parent(const Label& label) const {
-        if (!has_one_parent(label)) {
+        const auto parents = parents_of(id_of(label));
+        if (parents.size() != 1) {
             CRAB_ERROR("Label ", to_string(label), " does not have a single parent");
         }
-        return *get_node(label).parents.begin();
+        return label_of(parents.front());
     }
 
     [[nodiscard]]
     bool contains(const Label& label) const {
-        return neighbours.contains(label);
+        return m_index->find(label).has_value();
     }
 
     [[nodiscard]]
     int num_siblings(const Label& label) const {
-        return get_node(get_parent(label)).out_degree();
+        return out_degree(get_parent(label));
     }
 
     [[nodiscard]]
     int in_degree(const Label& label) const {
-        return get_node(label).in_degree();
+        return gsl::narrow<int>(parents_of(id_of(label)).size());
     }
 
     [[nodiscard]]
     int out_degree(const Label& label) const {
-        return get_node(label).out_degree();
+        return gsl::narrow<int>(children_of(id_of(label)).size());
     }
 };
 
@@ -67,12 +67,12 @@ enum class VisitTaskType {
 
 struct VisitArgs {
     VisitTaskType type;
-    Label vertex;
+    LabelId vertex;
     WtoPartition& partition;
     std::weak_ptr<WtoCycle> containing_cycle;
 
-    VisitArgs(const VisitTaskType t, Label v, WtoPartition& p, std::weak_ptr<WtoCycle> cc)
-        : type(t), vertex(std::move(v)), partition(p), containing_cycle(std::move(cc)) {}
+    VisitArgs(const VisitTaskType t, const LabelId v, WtoPartition& p, std::weak_ptr<WtoCycle> cc)
+        : type(t), vertex(v), partition(p), containing_cycle(std::move(cc)) {}
 };
 
 struct WtoVertexData {
@@ -90,15 +90,16 @@ class WtoBuilder final {
     const Cfg& _cfg;
 
     // The following members are named to match the names in the paper.
-    std::map<Label, WtoVertexData> _vertex_data;
+    // Indexed by the LabelId of the vertex in _cfg.
+    std::vector<WtoVertexData> _vertex_data;
     int _num; // Highest DFN used so far.
-    std::stack<Label> _stack;
+    std::stack<LabelId> _stack;
 
     std::stack<VisitArgs> _visit_stack;
 
-    void push_successors(const Label& vertex, WtoPartition& partition, const std::weak_ptr<WtoCycle>& containing_cycle);
-    void start_visit(const Label& vertex, WtoPartition& partition, const std::weak_ptr<WtoCycle>& containing_cycle);
-    void continue_visit(const Label& vertex, WtoPartition& partition, const std::weak_ptr<WtoCycle>& containing_cycle);
+    void push_successors(LabelId vertex, WtoPartition& partition, const std::weak_ptr<WtoCycle>& containing_cycle);
+    void start_visit(LabelId vertex, WtoPartition& partition, const std::weak_ptr<WtoCycle>& containing_cycle);
+    void continue_visit(LabelId vertex, WtoPartition& partition, const std::weak_ptr<WtoCycle>& containing_cycle);
 
   public:
     Wto wto;
@@ -108,7 +109,7 @@ class WtoBuilder final {
     explicit WtoBuilder(const Cfg& cfg);
 };
 
-void WtoBuilder::push_successors(const Label& vertex, WtoPartition& partition,
+void WtoBuilder::push_successors(const LabelId vertex, WtoPartition& partition,
                                  const std::weak_ptr<WtoCycle>& containing_cycle) {
     if (_vertex_data[vertex].dfn != 0) {
         // We found an alternate path to a node already visited, so nothing to do.
@@ -120,19 +121,19 @@ void WtoBuilder::push_successors(const Label& vertex, WtoPartition& partition,
     // Schedule the next task for this vertex once we're done with anything else.
     _visit_stack.emplace(VisitTaskType::StartVisit, vertex, partition, containing_cycle);
 
-    for (const Label& succ : std::ranges::reverse_view(_cfg.children_of(vertex))) {
+    for (const LabelId succ : std::ranges::reverse_view(_cfg.children_of(vertex))) {
         if (_vertex_data[succ].dfn == 0) {
             _visit_stack.emplace(VisitTaskType::PushSuccessors, succ, partition, containing_cycle);
         }
     }
 }
 
-void WtoBuilder::start_visit(const Label& vertex, WtoPartition& partition,
+void WtoBuilder::start_visit(const LabelId vertex, WtoPartition& partition,
                              const std::weak_ptr<WtoCycle>& containing_cycle) {
     WtoVertexData& vertex_data = _vertex_data[vertex];
     int head_dfn = vertex_data.dfn;
     bool loop = false;
-    for (const Label& succ : _cfg.children_of(vertex)) {
+    for (const LabelId succ : _cfg.children_of(vertex)) {
         const WtoVertexData& data = _vertex_data[succ];
         int min_dfn = data.dfn;
         if (data.head_dfn != 0 && data.dfn != DFN_INF) {
@@ -149,7 +150,7 @@ void WtoBuilder::start_visit(const Label& vertex, WtoPartition& partition,
 
     if (head_dfn == vertex_data.dfn) {
         vertex_data.dfn = DFN_INF;
-        Label element = _stack.top();
+        LabelId element = _stack.top();
         _stack.pop();
         if (loop) {
             while (element != vertex) {
@@ -168,7 +169,7 @@ void WtoBuilder::start_visit(const Label& vertex, WtoPartition& partition,
 
             // Walk the control flow graph, adding nodes to this cycle.
             // This is the Component() function described in figure 4 of the paper.
-            for (const Label& succ : std::ranges::reverse_view(_cfg.children_of(vertex))) {
+            for (const LabelId succ : std::ranges::reverse_view(_cfg.children_of(vertex))) {
                 if (_vertex_data.at(succ).dfn == 0) {
                     _visit_stack.emplace(VisitTaskType::PushSuccessors, succ, cycle->_components, cycle);
                 }
@@ -176,40 +177,37 @@ void WtoBuilder::start_visit(const Label& vertex, WtoPartition& partition,
             return;
         }
         // Insert a new vertex component vertex into the current partition.
-        partition.emplace_back(vertex);
+        partition.emplace_back(_cfg.label_of(vertex));
 
         // Remember that we put the vertex into the caller's cycle.
-        wto._containing_cycle.emplace(vertex, containing_cycle);
+        wto._containing_cycle.emplace(_cfg.label_of(vertex), containing_cycle);
     }
     vertex_data.head_dfn = head_dfn;
 }
 
-void WtoBuilder::continue_visit(const Label& vertex, WtoPartition& partition,
+void WtoBuilder::continue_visit(const LabelId vertex, WtoPartition& partition,
                                 const std::weak_ptr<WtoCycle>& containing_cycle) {
     // Add the vertex at the start of the cycle
     // (end of the vector which stores the cycle in reverse order).
     auto cycle = containing_cycle.lock();
 
-    cycle->_components.push_back(vertex);
+    cycle->_components.push_back(_cfg.label_of(vertex));
 
     // Insert the component into the current partition.
     partition.emplace_back(cycle);
 
     // Remember that we put the vertex into the new cycle.
-    wto._containing_cycle.emplace(vertex, cycle);
+    wto._containing_cycle.emplace(_cfg.label_of(vertex), cycle);
 }
 
-WtoBuilder::WtoBuilder(const Cfg& cfg) : _cfg(cfg) {
-    // Create a map for holding a "depth-first number (DFN)" for each vertex.
-    for (const Label& label : cfg.labels()) {
-        _vertex_data.emplace(label, 0);
-    }
+WtoBuilder::WtoBuilder(const Cfg& cfg) : _cfg(cfg), _vertex_data(cfg.size()) {
+    // _vertex_data holds a "depth-first number (DFN)" for each vertex, initially 0.
 
     // Initialize the DFN counter.
     _num = 0;
 
     // Push the entry vertex on the stack to process.
-    _visit_stack.emplace(VisitArgs(VisitTaskType::PushSuccessors, cfg.entry_label(), wto._components, {}));
+    _visit_stack.emplace(VisitArgs(VisitTaskType::PushSuccessors, cfg.entry_id(), wto._components, {}));
 
     // Keep processing tasks until we're done.
     while (!_visit_stack.empty()) {
@@ -143,6 +143,25 @@ void wto_for_each_loop_head(const Range& top_level, F&& f) {
 // Check if node is a member of the wto component.
 bool is_component_member(const Label& label, const CycleOrLabel& component);
 
+// Visit every label of a component, including those of nested cycles.
+// Iterative (explicit work-stack) rather than recursive on cycle-nesting depth, so a
+// crafted deeply-nested CFG cannot overflow the C++ stack. The visit order is not specified.
+template <typename F>
+void for_each_component_label(const CycleOrLabel& component, F&& f) {
+    std::vector<const CycleOrLabel*> stack{&component};
+    while (!stack.empty()) {
+        const CycleOrLabel* const current = stack.back();
+        stack.pop_back();
+        if (const auto plabel = std::get_if<Label>(current)) {
+            f(*plabel);
+            continue;
+        }
+        for (const auto& nested_component : *std::get<std::shared_ptr<WtoCycle>>(*current)) {
+            stack.push_back(&nested_component);
+        }
+    }
+}
+
 class Wto final {
     // Top level components, in reverse order.
     WtoPartition _components;
@@ -2,6 +2,11 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <stdexcept>
 #include <string>
 
@@ -92,6 +97,35 @@ struct RuntimeConfig {
     }
 };
 
+/// Cooperative cancellation of a running analysis. Copies share the same flag, so the caller keeps
+/// one copy and hands another to the analysis through AnalysisLimits; cancel() may be called from
+/// any thread.
+class CancellationToken {
+    std::shared_ptr<std::atomic<bool>> m_flag = std::make_shared<std::atomic<bool>>(false);
+
+  public:
+    void cancel() const { m_flag->store(true, std::memory_order_relaxed); }
+
+    [[nodiscard]]
+    bool cancelled() const {
+        return m_flag->load(std::memory_order_relaxed);
+    }
+};
+
+/// Resource limits of one analysis. A zero limit is no limit. An analysis that exceeds one of them
+/// stops like one under `stop_on_first_error` and reports why in AnalysisResult::interruption. The
+/// limits cover all the passes of the analysis (`interval_pre_pass`, `lazy_narrowing`) together.
+struct AnalysisLimits {
+    /// Wall-clock time allowed, measured from the start of the analysis.
+    std::chrono::milliseconds time_limit{0};
+
+    /// Number of transfer-function applications allowed, over all labels and iterations,
+    /// including those of the widening and narrowing iterations of every loop.
+    uint64_t max_steps = 0;
+
+    CancellationToken cancellation;
+};
+
 struct VerifierOptions {
     RuntimeConfig runtime;
     VerbosityOptions verbosity_opts;
@@ -101,6 +135,86 @@ struct VerifierOptions {
 
     // False to use actual map fd's, true to use mock fd's.
     bool mock_map_fds = true;
+
+    /// When false ("verdict mode"), the analyzer releases each label's abstract states as soon as
+    /// the last WTO component that reads them has stabilized, so peak memory follows the analysis
+    /// frontier instead of the program size. `failed`, `find_first_error()`, `find_unreachable()`,
+    /// `max_loop_count`, `exit_value` and the exit invariant are unchanged; every other entry of
+    /// `AnalysisResult::invariants` is left at bottom, so invariant printing, observation checks
+    /// and failure slicing need the default.
+    bool retain_invariants = true;
+
+    /// Worker threads used to analyze one program. With more than one, top-level WTO components
+    /// are analyzed concurrently as soon as the components holding their CFG predecessors have
+    /// stabilized; the result is identical to the sequential engine. 0 means one per hardware thread.
+    size_t analysis_threads = 1;
+
+    /// When true, each inlined call of a local subprogram is analyzed as a unit when the call is
+    /// reached, and its per-label results are cached by callee and calling context. A later call of
+    /// the same subprogram with an equal context reuses them (renamed to its own stack frame)
+    /// instead of iterating over the callee again. Ignored with `runtime.check_for_termination`,
+    /// whose loop counters are distinct for every inlined copy of a loop.
+    bool summarize_local_calls = false;
+
+    /// When true, the analysis stops as soon as an assertion fails, without finishing the fixpoint,
+    /// the termination check or `max_loop_count`. The result has `failed` and `partial` set, and
+    /// `find_first_error()` reports the error that stopped it; every other invariant and error is
+    /// incomplete. Warm-start candidates are not tried, since checking one can raise errors that
+    /// are later withdrawn.
+    bool stop_on_first_error = false;
+
+    /// When true, the fixpoint iterator keeps a worklist of the labels whose parents' post-states
+    /// changed since their last visit, and an iteration over a loop transforms only those (and the
+    /// loop head, which is widened as before). A label whose join of parents is unchanged is not
+    /// transformed either: it keeps its states, which are equal to the ones it would compute, though
+    /// not always written with the same constraints. Labels are still visited in WTO order.
+    /// `AnalysisResult::steps` shows the transfer functions saved.
+    bool incremental_loops = false;
+
+    /// When true, Program::from_sequence computes which registers and stack slots are live at each
+    /// label (see Liveness), and the analysis forgets the dead ones at every join and loop head.
+    /// States at loop heads then only hold live data, which makes joins, widenings and inclusion
+    /// checks cheaper. The verdict is unchanged; the invariants of those labels omit dead variables.
+    bool forget_dead_variables = false;
+
+    /// When true, the states joined, widened or compared by the fixpoint iterator are hash-consed,
+    /// and the results of these operations are kept in an LRU cache keyed by the ids of their
+    /// operands (see StateMemo). An operation on states identical to those of an earlier one
+    /// returns its result. Hashing and comparing the operands costs about as much as an inclusion
+    /// check, so this pays off on programs whose states recur, e.g. many inlined calls of a
+    /// subprogram. `AnalysisResult::memo_hits` counts the cached answers.
+    bool memoize_lattice_operations = false;
+
+    /// When true, the assertions of labels inside a loop are not checked while the loop is iterated,
+    /// only once its outermost loop has stabilized, against the pre-states of the last iteration.
+    /// Widening and narrowing iterations then only transform states. If one of those checks fails,
+    /// the states past the failing label may not be reachable, so the loop is iterated again with
+    /// its checks, as without this option, and the errors of that iteration are reported. A loop
+    /// whose stabilized states pass may hide an error that eager checking would have raised on an
+    /// earlier, larger state. With `analysis_threads` above one, the labels of a stabilized loop
+    /// are checked concurrently.
+    bool defer_loop_checks = false;
+
+    /// When true, the program is first analyzed with intervals only (see ZoneDomain::IntervalsOnly),
+    /// which is cheaper than the full zone domain. If that pass accepts the program, or is stopped by
+    /// one of the limits, its result is returned; otherwise the program is analyzed again with zones,
+    /// since the errors may come from the lost relations. `AnalysisResult::tier` tells which pass
+    /// decided. The invariants of a program accepted by the pre-pass are intervals only.
+    bool interval_pre_pass = false;
+
+    /// When true, loops first stop at the post-fixpoint of their widening sequence, without the
+    /// narrowing iterations that follow it. If the program is accepted, that is the result. Otherwise
+    /// it is analyzed again, narrowing only the loops from which a label with an error of the first
+    /// pass is reachable; that second pass decides. `AnalysisResult::steps` counts both passes.
+    bool lazy_narrowing = false;
+
+    /// When true, an accepted program's AnalysisResult carries an InvariantCertificate: the pre-states
+    /// of its loop heads, which check_certificate() verifies again in a single pass. Verdict mode
+    /// keeps the loop-head pre-states for it.
+    bool emit_certificate = false;
+
+    /// Deadline, step budget and cancellation token of the analysis.
+    AnalysisLimits limits;
 };
 
 struct VerifierStats {
@@ -3,6 +3,8 @@
 #pragma once
 
 #include <optional>
+#include <span>
+#include <vector>
 
 #include "crab/finite_domain.hpp"
 
@@ -64,6 +66,18 @@ class AddBottom final {
         return *dom <= *o.dom;
     }
 
+    [[nodiscard]]
+    bool identical(const AddBottom& o) const {
+        if (!dom || !o.dom) {
+            return !dom && !o.dom;
+        }
+        return dom->identical(*o.dom);
+    }
+    [[nodiscard]]
+    std::size_t hash() const {
+        return dom ? dom->hash() : 0;
+    }
+
     void operator|=(const AddBottom& o) {
         if (!o.dom) {
             return;
@@ -99,6 +113,21 @@ class AddBottom final {
         return AddBottom(std::forward<LDOM>(*left.dom) | std::forward<RDOM>(*right.dom));
     }
 
+    // Join of any number of domains; bottom operands are skipped.
+    static AddBottom join(const std::span<const AddBottom* const> doms) {
+        std::vector<const T*> present;
+        present.reserve(doms.size());
+        for (const AddBottom* d : doms) {
+            if (d->dom) {
+                present.push_back(&*d->dom);
+            }
+        }
+        if (present.empty()) {
+            return bottom();
+        }
+        return AddBottom(T::join(present));
+    }
+
     [[nodiscard]]
     AddBottom widen(const AddBottom& o) const {
         if (!dom) {
@@ -234,6 +263,15 @@ class AddBottom final {
         return true;
     }
 
+    // The index of the first of csts that is not entailed, if any.
+    [[nodiscard]]
+    std::optional<std::size_t> first_not_entailed(const std::span<const LinearConstraint> csts) const {
+        if (dom) {
+            return dom->first_not_entailed(csts);
+        }
+        return std::nullopt;
+    }
+
     friend std::ostream& operator<<(std::ostream& o, const AddBottom& dom) {
         if (dom.dom) {
             return o << *dom.dom;
@@ -248,6 +286,15 @@ class AddBottom final {
         }
         return StringInvariant::bottom();
     }
+
+    /// Empty if bottom.
+    [[nodiscard]]
+    std::vector<LinearConstraint> to_constraints() const {
+        if (dom) {
+            return dom->to_constraints();
+        }
+        return {};
+    }
 }; // class AddBottom
 
 // Numerical abstract domain.
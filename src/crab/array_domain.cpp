@@ -4,11 +4,13 @@
 #include <algorithm>
 #include <optional>
 #include <set>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "boost/endian/conversion.hpp"
+#include <boost/container_hash/hash.hpp>
 #include <gsl/narrow>
 #include <map>
 
@@ -215,6 +217,50 @@ class StackCellRegistry final {
   public:
     offset_map_t& get(const DataKind kind) { return _maps[kind]; }
 
+    // Whether both registries list the same cells of each kind. A kind may be listed without cells.
+    bool operator==(const StackCellRegistry& other) const {
+        const auto covered_by = [](const StackCellRegistry& left, const StackCellRegistry& right) {
+            return std::ranges::all_of(left._maps, [&](const auto& entry) {
+                const auto it = right._maps.find(entry.first);
+                return it == right._maps.end() ? entry.second._map.empty() : it->second._map == entry.second._map;
+            });
+        };
+        return covered_by(*this, other) && covered_by(other, *this);
+    }
+
+    [[nodiscard]]
+    size_t hash() const {
+        // Kinds are summed, since the order of an unordered_map is not part of its value.
+        size_t sum = 0;
+        for (const auto& [kind, omap] : _maps) {
+            if (omap._map.empty()) {
+                continue;
+            }
+            size_t seed = static_cast<size_t>(kind);
+            for (const auto& [offset, cells] : omap._map) {
+                for (const Cell& c : cells) {
+                    boost::hash_combine(seed, offset);
+                    boost::hash_combine(seed, c.size);
+                }
+            }
+            sum += seed;
+        }
+        return sum;
+    }
+
+    [[nodiscard]]
+    std::vector<std::tuple<DataKind, int64_t, unsigned>> list() const {
+        std::vector<std::tuple<DataKind, int64_t, unsigned>> res;
+        for (const auto& [kind, omap] : _maps) {
+            for (const auto& cell_set : omap._map | std::views::values) {
+                for (const Cell& c : cell_set) {
+                    res.emplace_back(kind, c.offset, c.size);
+                }
+            }
+        }
+        return res;
+    }
+
     void merge_from(const StackCellRegistry& other) {
         if (this == &other) {
             return;
@@ -233,7 +279,7 @@ class StackCellRegistry final {
 std::shared_ptr<StackCellRegistry> make_stack_cell_registry() { return std::make_shared<StackCellRegistry>(); }
 
 void ArrayDomain::initialize_numbers(const int lb, const int width) {
-    num_bytes.reset(lb, width);
+    num_bytes.get_mutable().reset(lb, width);
     cells_.get_mutable().get(DataKind::svalues).mk_cell(offset_t{gsl::narrow_cast<Index>(lb)}, width);
 }
 
@@ -298,7 +344,7 @@ void ArrayDomain::split_number_var(NumAbsDomain& inv, const DataKind kind, const
     const std::vector<Cell> overlaps = offset_map.get_overlap_cells(o, size);
     for (const Cell& c : overlaps) {
         const auto [cell_start_index, cell_end_index] = cell_to_interval(c.offset, c.size).pair<int>();
-        if (!this->num_bytes.all_num(cell_start_index, cell_end_index + 1) ||
+        if (!this->num_bytes->all_num(cell_start_index, cell_end_index + 1) ||
             cell_end_index + 1UL < cell_start_index + sizeof(int64_t)) {
             // We can only split numeric cells of size 8 or less.
             continue;
@@ -403,7 +449,7 @@ bool ArrayDomain::all_num_lb_ub(const Interval& lb, const Interval& ub) const {
     }
     const auto [min_lb, max_ub] = *range;
     assert(min_lb < max_ub);
-    return this->num_bytes.all_num(min_lb, max_ub);
+    return this->num_bytes->all_num(min_lb, max_ub);
 }
 
 bool ArrayDomain::all_num_width(const Interval& index, const Interval& width) const {
@@ -413,7 +459,7 @@ bool ArrayDomain::all_num_width(const Interval& index, const Interval& width) co
     }
     const auto [min_lb, max_ub] = *range;
     assert(min_lb < max_ub);
-    return this->num_bytes.all_num(min_lb, max_ub);
+    return this->num_bytes->all_num(min_lb, max_ub);
 }
 
 // Get the number of bytes, starting at offset, that are known to be numbers.
@@ -425,7 +471,7 @@ int ArrayDomain::min_all_num_size(const NumAbsDomain& inv, const Variable offset
     }
     const auto lb = min_lb->narrow<int>();
     const auto ub = max_ub->narrow<int>();
-    return std::max(0, this->num_bytes.all_num_width(lb) - (ub - lb));
+    return std::max(0, this->num_bytes->all_num_width(lb) - (ub - lb));
 }
 
 // Get one byte of a value.
@@ -563,7 +609,7 @@ std::optional<LinearExpression> ArrayDomain::load_type(const Interval& i, const
     if (const std::optional<Number> n = i.singleton()) {
         offset_map_t& offset_map = cells_.get_mutable().get(DataKind::types);
         const int64_t k = n->narrow<int64_t>();
-        auto [only_num, only_non_num] = num_bytes.uniformity(k, width);
+        auto [only_num, only_non_num] = num_bytes->uniformity(k, width);
         if (only_num) {
             return T_NUM;
         }
@@ -597,7 +643,7 @@ std::optional<LinearExpression> ArrayDomain::load_type(const Interval& i, const
             const Number fullwidth = ub.value() - lb.value() + width;
             if (lb->fits<uint32_t>() && fullwidth.fits<uint32_t>()) {
                 auto [only_num, only_non_num] =
-                    num_bytes.uniformity(lb->narrow<uint32_t>(), fullwidth.narrow<uint32_t>());
+                    num_bytes->uniformity(lb->narrow<uint32_t>(), fullwidth.narrow<uint32_t>());
                 if (only_num) {
                     return T_NUM;
                 }
@@ -639,9 +685,9 @@ std::optional<Variable> ArrayDomain::store_type(TypeDomain& inv, const Interval&
         // perform strong update
         auto [offset, size] = *maybe_cell;
         if (is_num) {
-            num_bytes.reset(offset, size);
+            num_bytes.get_mutable().reset(offset, size);
         } else {
-            num_bytes.havoc(offset, size);
+            num_bytes.get_mutable().havoc(offset, size);
         }
         const Cell c = cells_.get_mutable().get(kind).mk_cell(offset, size);
         Variable v = cell_var(kind, c);
@@ -656,7 +702,7 @@ std::optional<Variable> ArrayDomain::store_type(TypeDomain& inv, const Interval&
             // A non-numeric value may overwrite previously numeric bytes,
             // so conservatively mark the range [lb, ub) as non-numeric. havoc's
             // second argument is a width, not an upper bound.
-            num_bytes.havoc(lb, ub - lb);
+            num_bytes.get_mutable().havoc(lb, ub - lb);
         }
         // When is_num is true, the value being stored is numeric. Any byte
         // that gets written will still be numeric, and bytes not written
@@ -675,7 +721,7 @@ void ArrayDomain::havoc_type(TypeDomain& inv, const Interval& idx, const Interva
     if (auto maybe_cell = kill_and_find_var(
             cells_.get_mutable(), [&inv](const Variable v) { inv.havoc_type(v); }, kind, idx, elem_size)) {
         auto [offset, size] = *maybe_cell;
-        num_bytes.havoc(offset, size);
+        num_bytes.get_mutable().havoc(offset, size);
     }
 }
 
@@ -697,61 +743,110 @@ void ArrayDomain::store_numbers(const Interval& _idx, const Interval& _width) {
                   total_stack_size());
         return;
     }
-    num_bytes.reset(idx_n->narrow<int>(), width->narrow<int>());
+    num_bytes.get_mutable().reset(idx_n->narrow<int>(), width->narrow<int>());
+}
+
+void ArrayDomain::set_to_top() { num_bytes.get_mutable().set_to_top(); }
+
+bool ArrayDomain::is_top() const { return num_bytes->is_top(); }
+
+StringInvariant ArrayDomain::to_set() const { return num_bytes->to_set(); }
+
+std::vector<std::pair<int, int>> ArrayDomain::numeric_ranges() const {
+    std::vector<std::pair<int, int>> res;
+    for (int lb = 0; lb < total_stack_size(); ++lb) {
+        if (const int width = num_bytes->all_num_width(lb); width > 0) {
+            res.emplace_back(lb, width);
+            lb += width;
+        }
+    }
+    return res;
 }
 
-void ArrayDomain::set_to_top() { num_bytes.set_to_top(); }
+void ArrayDomain::set_numeric(const int lb, const int width) { num_bytes.get_mutable().reset(lb, width); }
+
+std::vector<std::tuple<DataKind, int64_t, unsigned>> ArrayDomain::cells() const { return cells_->list(); }
 
-bool ArrayDomain::is_top() const { return num_bytes.is_top(); }
+void ArrayDomain::add_cell(const DataKind kind, const int64_t offset, const unsigned size) {
+    (void)cells_.get_mutable().get(kind).mk_cell(offset_t{gsl::narrow_cast<Index>(offset)}, size);
+}
 
-StringInvariant ArrayDomain::to_set() const { return num_bytes.to_set(); }
+bool ArrayDomain::operator<=(const ArrayDomain& other) const {
+    return num_bytes.get() == other.num_bytes.get() || *num_bytes <= *other.num_bytes;
+}
 
-bool ArrayDomain::operator<=(const ArrayDomain& other) const { return num_bytes <= other.num_bytes; }
+bool ArrayDomain::operator==(const ArrayDomain& other) const {
+    return num_bytes.get() == other.num_bytes.get() || *num_bytes == *other.num_bytes;
+}
 
-bool ArrayDomain::operator==(const ArrayDomain& other) const { return num_bytes == other.num_bytes; }
+bool ArrayDomain::identical(const ArrayDomain& other) const {
+    return *this == other && (cells_.get() == other.cells_.get() || *cells_ == *other.cells_);
+}
 
-void ArrayDomain::operator|=(const ArrayDomain& other) {
-    num_bytes |= other.num_bytes;
-    cells_.get_mutable().merge_from(*other.cells_);
+size_t ArrayDomain::hash() const {
+    size_t seed = num_bytes->hash();
+    boost::hash_combine(seed, cells_->hash());
+    return seed;
 }
 
-void ArrayDomain::operator|=(ArrayDomain&& other) {
-    num_bytes |= std::move(other.num_bytes);
-    cells_.get_mutable().merge_from(*other.cells_);
+void ArrayDomain::operator|=(const ArrayDomain& other) {
+    if (num_bytes.get() != other.num_bytes.get()) {
+        num_bytes.get_mutable() |= *other.num_bytes;
+    }
+    if (cells_.get() != other.cells_.get()) {
+        cells_.get_mutable().merge_from(*other.cells_);
+    }
 }
 
+void ArrayDomain::operator|=(ArrayDomain&& other) { *this |= std::as_const(other); }
+
 // Lattice combinators build a fresh ArrayDomain whose cells map is the union of
 // both sides' cells. Cell membership is purely advisory (it enables overlap
 // detection and dedup of mk_cell calls); the underlying numeric domain's join
 // determines abstract values, and it operates on globally-interned Variable
 // names so two domains independently tracking the same cell agree on its name.
 ArrayDomain ArrayDomain::operator|(const ArrayDomain& other) const {
-    ArrayDomain res{num_bytes | other.num_bytes};
+    ArrayDomain res{*num_bytes | *other.num_bytes};
     res.cells_.get_mutable().merge_from(*cells_);
     res.cells_.get_mutable().merge_from(*other.cells_);
     return res;
 }
 
+ArrayDomain ArrayDomain::join(const std::span<const ArrayDomain* const> doms) {
+    const ArrayDomain& first = *doms.front();
+    ArrayDomain res{first};
+    for (const ArrayDomain* dom : doms.subspan(1)) {
+        if (dom->num_bytes.get() != res.num_bytes.get()) {
+            res.num_bytes.get_mutable() |= *dom->num_bytes;
+        }
+        // Registries shared with the first operand are already in res.
+        if (dom->cells_.get() != first.cells_.get() && dom->cells_.get() != res.cells_.get()) {
+            res.cells_.get_mutable().merge_from(*dom->cells_);
+        }
+    }
+    return res;
+}
+
 ArrayDomain ArrayDomain::operator&(const ArrayDomain& other) const {
-    ArrayDomain res{num_bytes & other.num_bytes};
+    ArrayDomain res{*num_bytes & *other.num_bytes};
     res.cells_.get_mutable().merge_from(*cells_);
     res.cells_.get_mutable().merge_from(*other.cells_);
     return res;
 }
 
 ArrayDomain ArrayDomain::widen(const ArrayDomain& other) const {
-    ArrayDomain res{num_bytes | other.num_bytes};
+    ArrayDomain res{*num_bytes | *other.num_bytes};
     res.cells_.get_mutable().merge_from(*cells_);
     res.cells_.get_mutable().merge_from(*other.cells_);
     return res;
 }
 
 ArrayDomain ArrayDomain::narrow(const ArrayDomain& other) const {
-    ArrayDomain res{num_bytes & other.num_bytes};
+    ArrayDomain res{*num_bytes & *other.num_bytes};
     res.cells_.get_mutable().merge_from(*cells_);
     res.cells_.get_mutable().merge_from(*other.cells_);
     return res;
 }
 
-std::ostream& operator<<(std::ostream& o, const ArrayDomain& dom) { return o << dom.num_bytes; }
+std::ostream& operator<<(std::ostream& o, const ArrayDomain& dom) { return o << *dom.num_bytes; }
 } // namespace prevail
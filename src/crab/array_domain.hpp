@@ -25,6 +25,10 @@
 
 #include <memory>
 #include <optional>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "arith/variable.hpp"
 #include "crab/add_bottom.hpp"
@@ -42,19 +46,22 @@ class StackCellRegistry;
 std::shared_ptr<StackCellRegistry> make_stack_cell_registry();
 
 class ArrayDomain final {
-    BitsetDomain num_bytes;
+    // Shared between copies, like the cell registry, until a store or havoc changes it.
+    Cow<BitsetDomain> num_bytes;
     Cow<StackCellRegistry> cells_;
 
   public:
     // Top at the requested size.
-    explicit ArrayDomain(size_t stack_size) : num_bytes(BitsetDomain{stack_size}), cells_(make_stack_cell_registry()) {}
+    explicit ArrayDomain(size_t stack_size)
+        : num_bytes(Cow<BitsetDomain>::make(stack_size)), cells_(make_stack_cell_registry()) {}
 
     [[nodiscard]]
     int total_stack_size() const {
-        return gsl::narrow<int>(num_bytes.size());
+        return gsl::narrow<int>(num_bytes->size());
     }
 
-    explicit ArrayDomain(const BitsetDomain& num_bytes) : num_bytes(num_bytes), cells_(make_stack_cell_registry()) {}
+    explicit ArrayDomain(BitsetDomain num_bytes)
+        : num_bytes(Cow<BitsetDomain>::make(std::move(num_bytes))), cells_(make_stack_cell_registry()) {}
     ArrayDomain(const ArrayDomain& other) = default;
     ArrayDomain(ArrayDomain&& other) noexcept = default;
     ArrayDomain& operator=(const ArrayDomain& other) = default;
@@ -69,11 +76,21 @@ class ArrayDomain final {
 
     bool operator<=(const ArrayDomain& other) const;
     bool operator==(const ArrayDomain& other) const;
+    // Whether both domains have the same bitset and list the same cells. operator== only compares
+    // the bitset, since the numeric domain holds the values of the cells; but the cells a load or
+    // a store finds depend on the registry, so a state cannot stand in for one with other cells.
+    [[nodiscard]]
+    bool identical(const ArrayDomain& other) const;
+    // Hash of what identical() compares.
+    [[nodiscard]]
+    size_t hash() const;
 
     void operator|=(const ArrayDomain& other);
     void operator|=(ArrayDomain&& other);
 
     ArrayDomain operator|(const ArrayDomain& other) const;
+    // Join of one or more domains; cell registries shared between operands are merged once.
+    static ArrayDomain join(std::span<const ArrayDomain* const> doms);
     ArrayDomain operator&(const ArrayDomain& other) const;
     ArrayDomain widen(const ArrayDomain& other) const;
     ArrayDomain narrow(const ArrayDomain& other) const;
@@ -82,6 +99,17 @@ class ArrayDomain final {
     [[nodiscard]]
     StringInvariant to_set() const;
 
+    // The runs of bytes known to hold numbers, as pairs of start and width.
+    [[nodiscard]]
+    std::vector<std::pair<int, int>> numeric_ranges() const;
+    // Mark the `width` bytes from `lb` as numbers, without listing a cell for them.
+    void set_numeric(int lb, int width);
+    // The cells the registry lists, as kind, offset and size.
+    [[nodiscard]]
+    std::vector<std::tuple<DataKind, int64_t, unsigned>> cells() const;
+    // List the cell of `kind` over the `size` bytes from `offset`.
+    void add_cell(DataKind kind, int64_t offset, unsigned size);
+
     [[nodiscard]]
     bool all_num_width(const Interval& index, const Interval& width) const;
     [[nodiscard]]
@@ -53,6 +53,11 @@ class BitsetDomain final {
         return non_numerical_bytes == other.non_numerical_bytes;
     }
 
+    [[nodiscard]]
+    size_t hash() const {
+        return hash_value(non_numerical_bytes);
+    }
+
     void operator|=(const BitsetDomain& other) {
         assert(non_numerical_bytes.size() == other.non_numerical_bytes.size());
         non_numerical_bytes |= other.non_numerical_bytes;
@@ -2,12 +2,28 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <atomic>
 #include <cassert>
 #include <memory>
 #include <utility>
 
 namespace prevail {
 
+/// Make `ptr` the only owner of its object, copying the object if it is shared, and return it.
+/// Requires: ptr is not null.
+template <typename T>
+T& detach_shared(std::shared_ptr<T>& ptr) {
+    assert(ptr);
+    if (ptr.use_count() > 1) {
+        ptr = std::make_shared<T>(*ptr);
+    } else {
+        // use_count() is a relaxed load. When the last other owner dropped its reference on
+        // another thread (parallel analysis), this fence orders that owner's reads before our writes.
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *ptr;
+}
+
 /// Copy-on-write wrapper. Const access (`*`, `->`) is free (shared);
 /// mutable access (`get_mutable()`) detaches when the underlying object
 /// is shared with other Cow instances.
@@ -36,10 +52,7 @@ class Cow final {
 
     [[nodiscard]]
     T& get_mutable() {
-        if (ptr_.use_count() > 1) {
-            ptr_ = std::make_shared<T>(*ptr_);
-        }
-        return *ptr_;
+        return detach_shared(ptr_);
     }
 
     const T* get() const { return ptr_.get(); }
@@ -118,18 +118,17 @@ class EbpfChecker final {
         throw VerificationFailureSignal(msg + " (" + to_string(assertion) + ")");
     }
 
-    // Per-region bounds checks compose two primitives at each call site, so
-    // the floor and ceiling for a given access are spelled out where they
-    // are checked rather than picked by a dispatcher.
-    void require_lower_bound(const LinearExpression& access_lb, const LinearExpression& floor,
-                             const std::string& msg) const {
+    // Per-region bounds checks spell out the floor and ceiling of each access
+    // where they are checked rather than have them picked by a dispatcher.
+    // Both bounds are decided in one batch.
+    void require_bounds(const LinearExpression& access_lb, const LinearExpression& floor, const std::string& lb_msg,
+                        const LinearExpression& access_ub, const LinearExpression& ceiling,
+                        const std::string& ub_msg) const {
         using namespace dsl_syntax;
-        require_value(dom.state, access_lb >= floor, msg);
-    }
-    void require_upper_bound(const LinearExpression& access_ub, const LinearExpression& ceiling,
-                             const std::string& msg) const {
-        using namespace dsl_syntax;
-        require_value(dom.state, access_ub <= ceiling, msg);
+        const std::array csts{access_lb >= floor, access_ub <= ceiling};
+        if (const auto failed = dom.state.values.first_not_entailed(csts)) {
+            throw_fail(*failed == 0 ? lb_msg : ub_msg);
+        }
     }
 
     const Assertion assertion;
@@ -331,17 +330,16 @@ void EbpfChecker::operator()(const ValidMapKeyValue& s) const {
         case T_PACKET: {
             Variable lb = access_reg.packet_offset;
             LinearExpression ub = LinearExpression{lb} + LinearExpression{width};
-            require_lower_bound(lb, variable_registry.meta_offset(), "Lower bound must be at least meta_offset");
-            require_upper_bound(ub, variable_registry.packet_size(), "Upper bound must be at most packet_size");
+            require_bounds(lb, variable_registry.meta_offset(), "Lower bound must be at least meta_offset", ub,
+                           variable_registry.packet_size(), "Upper bound must be at most packet_size");
             // Packet memory is both readable and writable.
             break;
         }
         case T_SHARED: {
             Variable lb = access_reg.shared_offset;
             LinearExpression ub = LinearExpression{lb} + LinearExpression{width};
-            require_lower_bound(lb, LinearExpression{0}, "Lower bound must be at least 0");
-            require_upper_bound(ub, access_reg.shared_region_size,
-                                "Upper bound must be at most " + variable_registry.name(access_reg.shared_region_size));
+            require_bounds(lb, LinearExpression{0}, "Lower bound must be at least 0", ub, access_reg.shared_region_size,
+                           "Upper bound must be at most " + variable_registry.name(access_reg.shared_region_size));
             require_value(dom.state, access_reg.uvalue > 0, "Possible null access");
             // Shared memory is zero-initialized when created so is safe to read and write.
             break;
@@ -386,10 +384,10 @@ void EbpfChecker::operator()(const ValidAccess& s) const {
         switch (type) {
         case T_STACK: {
             const auto [lb, ub] = lb_ub_access_pair(s, reg.stack_offset);
-            require_lower_bound(lb, reg_pack(R10_STACK_POINTER).stack_offset - context.runtime().subprogram_stack_size,
-                                "Lower bound must be at least r10.stack_offset - subprogram_stack_size");
-            require_upper_bound(ub, LinearExpression{context.runtime().total_stack_size()},
-                                "Upper bound must be at most total_stack_size");
+            require_bounds(lb, reg_pack(R10_STACK_POINTER).stack_offset - context.runtime().subprogram_stack_size,
+                           "Lower bound must be at least r10.stack_offset - subprogram_stack_size", ub,
+                           LinearExpression{context.runtime().total_stack_size()},
+                           "Upper bound must be at most total_stack_size");
             // Stack reads must hit known-numeric bytes.
             if (s.access_type == AccessType::read &&
                 !dom.stack->all_num_lb_ub(dom.state.values.eval_interval(lb), dom.state.values.eval_interval(ub))) {
@@ -431,32 +429,31 @@ void EbpfChecker::operator()(const ValidAccess& s) const {
                 }
             }
             const auto ctx_size = desc->size;
-            require_lower_bound(lb, LinearExpression{0}, "Lower bound must be at least 0");
-            require_upper_bound(ub, LinearExpression{ctx_size},
-                                "Upper bound must be at most " + std::to_string(ctx_size));
+            require_bounds(lb, LinearExpression{0}, "Lower bound must be at least 0", ub, LinearExpression{ctx_size},
+                           "Upper bound must be at most " + std::to_string(ctx_size));
             // T_CTX: bounds suffice; non-null when in bounds.
             break;
         }
         case T_PACKET: {
             const auto [lb, ub] = lb_ub_access_pair(s, reg.packet_offset);
-            require_lower_bound(lb, variable_registry.meta_offset(), "Lower bound must be at least meta_offset");
             // Pointer-comparison checks (width == 0) may legitimately reach
             // past the runtime packet_size, so they use the looser
             // max_packet_size ceiling. Real dereferences must be bounded by
             // the runtime packet_size variable.
             if (is_comparison_check) {
                 const auto max = context.runtime().max_packet_size;
-                require_upper_bound(ub, LinearExpression{max}, "Upper bound must be at most " + std::to_string(max));
+                require_bounds(lb, variable_registry.meta_offset(), "Lower bound must be at least meta_offset", ub,
+                               LinearExpression{max}, "Upper bound must be at most " + std::to_string(max));
             } else {
-                require_upper_bound(ub, variable_registry.packet_size(), "Upper bound must be at most packet_size");
+                require_bounds(lb, variable_registry.meta_offset(), "Lower bound must be at least meta_offset", ub,
+                               variable_registry.packet_size(), "Upper bound must be at most packet_size");
             }
             break;
         }
         case T_SHARED: {
             const auto [lb, ub] = lb_ub_access_pair(s, reg.shared_offset);
-            require_lower_bound(lb, LinearExpression{0}, "Lower bound must be at least 0");
-            require_upper_bound(ub, reg.shared_region_size,
-                                "Upper bound must be at most " + variable_registry.name(reg.shared_region_size));
+            require_bounds(lb, LinearExpression{0}, "Lower bound must be at least 0", ub, reg.shared_region_size,
+                           "Upper bound must be at most " + variable_registry.name(reg.shared_region_size));
             if (!is_comparison_check && !s.or_null) {
                 require_value(dom.state, reg.uvalue > 0, "Possible null access");
             }
@@ -469,9 +466,9 @@ void EbpfChecker::operator()(const ValidAccess& s) const {
             }
             const EbpfStructDescriptor& socket_layout = *platform->sock_common_layout;
             const auto [lb, ub] = lb_ub_access_pair(s, reg.socket_offset);
-            require_lower_bound(lb, LinearExpression{0}, "Lower bound must be at least 0");
-            require_upper_bound(ub, LinearExpression{socket_layout.size},
-                                "Upper bound must be at most " + std::to_string(socket_layout.size));
+            require_bounds(lb, LinearExpression{0}, "Lower bound must be at least 0", ub,
+                           LinearExpression{socket_layout.size},
+                           "Upper bound must be at most " + std::to_string(socket_layout.size));
             if (!is_comparison_check) {
                 if (s.access_type == AccessType::write) {
                     throw_fail("Socket memory is read-only");
@@ -496,9 +493,8 @@ void EbpfChecker::operator()(const ValidAccess& s) const {
         }
         case T_ALLOC_MEM: {
             const auto [lb, ub] = lb_ub_access_pair(s, reg.alloc_mem_offset);
-            require_lower_bound(lb, LinearExpression{0}, "Lower bound must be at least 0");
-            require_upper_bound(ub, reg.alloc_mem_size,
-                                "Upper bound must be at most " + variable_registry.name(reg.alloc_mem_size));
+            require_bounds(lb, LinearExpression{0}, "Lower bound must be at least 0", ub, reg.alloc_mem_size,
+                           "Upper bound must be at most " + variable_registry.name(reg.alloc_mem_size));
             if (!is_comparison_check && !s.or_null) {
                 require_value(dom.state, reg.uvalue > 0, "Possible null access");
             }
@@ -3,11 +3,18 @@
 
 // This file is eBPF-specific, not derived from CRAB.
 
+#include <array>
+#include <cctype>
 #include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "boost/endian/conversion.hpp"
+#include <boost/container_hash/hash.hpp>
 
 #include "arith/dsl_syntax.hpp"
 #include "config.hpp"
@@ -15,6 +22,7 @@
 #include "crab/ebpf_domain.hpp"
 #include "crab/var_registry.hpp"
 #include "crab_utils/num_safety.hpp"
+#include "crab_utils/prevail_errors.hpp"
 #include "ir/unmarshal.hpp"
 
 namespace prevail {
@@ -26,6 +34,133 @@ StringInvariant EbpfDomain::to_set() const {
     return state.to_set() + stack->to_set();
 }
 
+// Lines of EbpfDomain::to_text() are fields separated by tabs, the first one naming what the line
+// describes: a class of type variables, a linear constraint, a run of numeric stack bytes, or a cell.
+static constexpr char TEXT_SEPARATOR = '\t';
+
+using ConstraintKindName = std::pair<ConstraintKind, std::string_view>;
+static constexpr std::array<ConstraintKindName, 4> constraint_kind_names{{
+    {ConstraintKind::EQUALS_ZERO, "=0"},
+    {ConstraintKind::LESS_THAN_OR_EQUALS_ZERO, "<=0"},
+    {ConstraintKind::LESS_THAN_ZERO, "<0"},
+    {ConstraintKind::NOT_ZERO, "!=0"},
+}};
+
+static std::vector<std::string> text_fields(const std::string& line) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    for (size_t end = line.find(TEXT_SEPARATOR);; end = line.find(TEXT_SEPARATOR, start)) {
+        fields.push_back(line.substr(start, end - start));
+        if (end == std::string::npos) {
+            return fields;
+        }
+        start = end + 1;
+    }
+}
+
+static Number number_field(const std::string& field) {
+    const size_t sign = field.starts_with('-') ? 1 : 0;
+    if (field.size() == sign || !std::all_of(field.begin() + sign, field.end(), [](const char c) {
+            return std::isdigit(static_cast<unsigned char>(c));
+        })) {
+        throw RuntimeInputError("Not a number in an invariant: " + field);
+    }
+    return Number{field};
+}
+
+std::vector<std::string> EbpfDomain::to_text() const {
+    if (is_bottom()) {
+        return {"bottom"};
+    }
+    std::vector<std::string> lines;
+    for (const auto& [members, types] : state.types.classes()) {
+        std::ostringstream line;
+        line << "types" << TEXT_SEPARATOR;
+        for (bool first = true; const TypeEncoding te : types.to_vector()) {
+            line << (first ? "" : ",") << te;
+            first = false;
+        }
+        for (const Variable v : members) {
+            line << TEXT_SEPARATOR << variable_registry.name(v);
+        }
+        lines.push_back(line.str());
+    }
+    for (const LinearConstraint& cst : state.values.to_constraints()) {
+        const auto kind = std::ranges::find(constraint_kind_names, cst.kind(), &ConstraintKindName::first);
+        std::ostringstream line;
+        line << "value" << TEXT_SEPARATOR << kind->second << TEXT_SEPARATOR << cst.expression().constant_term();
+        for (const auto& [v, coefficient] : cst.expression().variable_terms()) {
+            line << TEXT_SEPARATOR << coefficient << TEXT_SEPARATOR << variable_registry.name(v);
+        }
+        lines.push_back(line.str());
+    }
+    for (const auto& [lb, width] : stack->numeric_ranges()) {
+        lines.push_back("numeric" + std::string{TEXT_SEPARATOR} + std::to_string(lb) + TEXT_SEPARATOR +
+                        std::to_string(width));
+    }
+    for (const auto& [kind, offset, size] : stack->cells()) {
+        lines.push_back("cell" + std::string{TEXT_SEPARATOR} + name_of(kind) + TEXT_SEPARATOR + std::to_string(offset) +
+                        TEXT_SEPARATOR + std::to_string(size));
+    }
+    return lines;
+}
+
+EbpfDomain EbpfDomain::from_text(const std::span<const std::string> lines, const AnalysisContext& context) {
+    if (lines.size() == 1 && lines.front() == "bottom") {
+        return bottom();
+    }
+    // The stack is rebuilt first, since a contradiction in the other lines drops it.
+    std::vector<std::vector<std::string>> types;
+    std::vector<std::vector<std::string>> values;
+    EbpfDomain inv = top(context);
+    for (const std::string& line : lines) {
+        std::vector<std::string> fields = text_fields(line);
+        const std::string& what = fields.front();
+        if (what == "types" && fields.size() >= 3) {
+            types.push_back(std::move(fields));
+        } else if (what == "value" && fields.size() >= 3 && fields.size() % 2 == 1) {
+            values.push_back(std::move(fields));
+        } else if (what == "numeric" && fields.size() == 3) {
+            inv.stack->set_numeric(number_field(fields[1]).narrow<int>(), number_field(fields[2]).narrow<int>());
+        } else if (what == "cell" && fields.size() == 4) {
+            inv.stack->add_cell(regkind(fields[1]), number_field(fields[2]).narrow<int64_t>(),
+                                number_field(fields[3]).narrow<unsigned>());
+        } else {
+            throw RuntimeInputError("Malformed invariant line: " + line);
+        }
+    }
+    for (const auto& fields : types) {
+        TypeSet ts;
+        std::istringstream encodings{fields[1]};
+        for (std::string te; std::getline(encodings, te, ',');) {
+            ts |= TypeSet{string_to_type_encoding(te)};
+        }
+        const Variable first = variable_registry.from_name(fields[2]);
+        inv.restrict_type(first, ts);
+        for (size_t i = 3; i < fields.size(); ++i) {
+            inv.assume_eq_types(first, variable_registry.from_name(fields[i]));
+        }
+    }
+    if (inv.state.types.is_bottom()) {
+        return bottom();
+    }
+    for (const auto& fields : values) {
+        const auto kind = std::ranges::find(constraint_kind_names, fields[1], &ConstraintKindName::second);
+        if (kind == constraint_kind_names.end()) {
+            throw RuntimeInputError("Unknown constraint kind in an invariant: " + fields[1]);
+        }
+        LinearExpression e{number_field(fields[2])};
+        for (size_t i = 3; i < fields.size(); i += 2) {
+            e = e.plus(LinearExpression{number_field(fields[i]), variable_registry.from_name(fields[i + 1])});
+        }
+        inv.add_value_constraint(LinearConstraint{std::move(e), kind->first});
+        if (inv.is_bottom()) {
+            return inv;
+        }
+    }
+    return inv;
+}
+
 std::optional<int64_t> EbpfDomain::get_stack_offset(const Reg& reg) const {
     // Only return an offset when the register is *definitely* a stack pointer,
     // not just possibly one. This ensures we don't misclassify memory deps.
@@ -63,6 +198,41 @@ void EbpfDomain::set_to_bottom() {
 
 bool EbpfDomain::is_bottom() const { return state.is_bottom(); }
 
+void EbpfDomain::rename(const std::vector<std::pair<Variable, Variable>>& renaming) {
+    if (!is_bottom()) {
+        state.rename(renaming);
+    }
+}
+
+void EbpfDomain::havoc_register(const Reg& reg) {
+    if (!is_bottom()) {
+        state.havoc_register(reg);
+    }
+}
+
+void EbpfDomain::havoc_stack(const int64_t start, const int64_t size, const bool big_endian) {
+    if (is_bottom()) {
+        return;
+    }
+    stack->havoc_type(state.types, Interval{start}, Interval{size});
+    for (const DataKind kind : iterate_kinds()) {
+        stack->havoc(state.values, kind, Interval{start}, Interval{size}, big_endian);
+    }
+}
+
+void EbpfDomain::forget(const std::span<const Variable> variables) {
+    if (is_bottom()) {
+        return;
+    }
+    for (const Variable v : variables) {
+        if (variable_registry.is_type(v)) {
+            state.types.havoc_type(v);
+        } else {
+            state.values.havoc(v);
+        }
+    }
+}
+
 bool EbpfDomain::is_top() const { return stack && state.is_top() && stack->is_top(); }
 
 bool EbpfDomain::operator<=(const EbpfDomain& other) const {
@@ -92,6 +262,22 @@ bool EbpfDomain::operator<=(EbpfDomain&& other) const {
     return state <= std::move(other.state);
 }
 
+bool EbpfDomain::identical(const EbpfDomain& other) const {
+    if (is_bottom() || other.is_bottom()) {
+        return is_bottom() && other.is_bottom();
+    }
+    return stack->identical(*other.stack) && state.identical(other.state);
+}
+
+std::size_t EbpfDomain::hash() const {
+    if (is_bottom()) {
+        return 0;
+    }
+    std::size_t seed = state.hash();
+    boost::hash_combine(seed, stack->hash());
+    return seed;
+}
+
 void EbpfDomain::operator|=(EbpfDomain&& other) {
     if (other.is_bottom()) {
         return;
@@ -150,6 +336,30 @@ EbpfDomain EbpfDomain::operator|(const EbpfDomain& other) && {
     return std::move(*this);
 }
 
+EbpfDomain EbpfDomain::join(const std::span<const EbpfDomain* const> doms) {
+    std::vector<const EbpfDomain*> present;
+    for (const EbpfDomain* dom : doms) {
+        if (!dom->is_bottom()) {
+            present.push_back(dom);
+        }
+    }
+    if (present.empty()) {
+        return bottom();
+    }
+    if (present.size() == 1) {
+        return *present.front();
+    }
+    std::vector<const TypeToNumDomain*> states;
+    std::vector<const ArrayDomain*> stacks;
+    states.reserve(present.size());
+    stacks.reserve(present.size());
+    for (const EbpfDomain* dom : present) {
+        states.push_back(&dom->state);
+        stacks.push_back(&*dom->stack);
+    }
+    return EbpfDomain{TypeToNumDomain::join(states), ArrayDomain::join(stacks)};
+}
+
 EbpfDomain EbpfDomain::operator&(const EbpfDomain& other) const {
     if (is_bottom() || other.is_bottom()) {
         return bottom();
@@ -9,6 +9,7 @@
 #include <span>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "analysis_context.hpp"
 #include "arith/variable.hpp"
@@ -69,11 +70,23 @@ class EbpfDomain final {
     bool is_top() const;
     bool operator<=(const EbpfDomain& other) const;
     bool operator<=(EbpfDomain&& other) const;
+    /// Whether both domains have the same representation, up to the internal numbering of their
+    /// components, including the cells the stack lists. Identical domains are equal, and StateMemo
+    /// treats them as interchangeable.
+    [[nodiscard]]
+    bool identical(const EbpfDomain& other) const;
+    /// A hash that agrees with identical().
+    [[nodiscard]]
+    std::size_t hash() const;
     void operator|=(EbpfDomain&& other);
     void operator|=(const EbpfDomain& other);
     EbpfDomain operator|(EbpfDomain&& other) const;
     EbpfDomain operator|(const EbpfDomain& other) const&;
     EbpfDomain operator|(const EbpfDomain& other) &&;
+    /// Join of any number of domains, e.g. the post-states of all the predecessors of a label.
+    /// Bottom operands are skipped. The numeric domains are joined in one pass instead of
+    /// being folded pairwise.
+    static EbpfDomain join(std::span<const EbpfDomain* const> doms);
     EbpfDomain operator&(const EbpfDomain& other) const;
     EbpfDomain widen(const EbpfDomain& other) const;
     EbpfDomain narrow(const EbpfDomain& other) const;
@@ -108,6 +121,26 @@ class EbpfDomain final {
 
     StringInvariant to_set() const;
 
+    /// The domain as lines of text that name its variables instead of numbering them, so that it
+    /// can outlive the thread's VariableRegistry. Unlike to_set(), which is meant for reading, the
+    /// lines keep every constraint and every stack cell, and from_text() rebuilds an equal domain.
+    [[nodiscard]]
+    std::vector<std::string> to_text() const;
+    /// Throws RuntimeInputError if a line is malformed.
+    static EbpfDomain from_text(std::span<const std::string> lines, const AnalysisContext& context);
+
+    /// Rename variables of the type and numeric domains, e.g., to move a state between stack frames.
+    void rename(const std::vector<std::pair<Variable, Variable>>& renaming);
+
+    /// Forget the value and type of `reg`, as a helper call does for r1-r5.
+    void havoc_register(const Reg& reg);
+
+    /// Forget the contents of the stack bytes [start, start + size).
+    void havoc_stack(int64_t start, int64_t size, bool big_endian);
+
+    /// Forget the values of `variables`, and the types of those that are type variables.
+    void forget(std::span<const Variable> variables);
+
     /// Check if a register may be a stack pointer and return its stack offset if known.
     /// Used by failure slicing to detect stack accesses through derived pointers.
     /// @return The concrete stack offset if the register is definitely a stack pointer with a known offset,
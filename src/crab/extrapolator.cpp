@@ -2,37 +2,70 @@
 // SPDX-License-Identifier: MIT
 #include "extrapolator.hpp"
 
+#include <array>
+#include <utility>
+
 #include "analysis_context.hpp"
+#include "crab/state_memo.hpp"
 
 namespace prevail {
 
-Extrapolator::Extrapolator(const AnalysisContext& context, const std::span<const Variable> loop_counters)
+Extrapolator::Extrapolator(const AnalysisContext& context, const std::span<const Variable> loop_counters,
+                           StateMemo* memo)
     : constant_limits_(EbpfDomain::calculate_constant_limits(context, loop_counters)),
-      loop_counters_(loop_counters.begin(), loop_counters.end()) {}
+      loop_counters_(loop_counters.begin(), loop_counters.end()), memo_(memo) {}
+
+bool Extrapolator::leq(const EbpfDomain& left, const EbpfDomain& right) const {
+    return memo_ ? memo_->leq(left, right) : left <= right;
+}
+
+EbpfDomain Extrapolator::join(const EbpfDomain& left, const EbpfDomain& right) const {
+    if (!memo_) {
+        return left | right;
+    }
+    const std::array doms{&left, &right};
+    return memo_->join(doms);
+}
+
+EbpfDomain Extrapolator::widen(const EbpfDomain& left, const EbpfDomain& right) const {
+    return memo_ ? memo_->widen(left, right) : left.widen(right);
+}
 
-EbpfDomain Extrapolator::compute_fixpoint(EbpfDomain invariant, const Step& step) const {
-    // Ascending (widening) sequence.
+EbpfDomain Extrapolator::compute_fixpoint(EbpfDomain initial, const Step& step) const {
+    return refine(ascend(std::move(initial), step, true), step);
+}
+
+EbpfDomain Extrapolator::ascend(EbpfDomain initial, const Step& step) const {
+    return ascend(std::move(initial), step, false);
+}
+
+EbpfDomain Extrapolator::ascend(EbpfDomain invariant, const Step& step, const bool take_last_step) const {
     for (unsigned int iteration = 0;;) {
         EbpfDomain new_pre = step(invariant);
-        if (new_pre <= invariant) {
-            invariant = std::move(new_pre);
+        if (leq(new_pre, invariant)) {
+            if (take_last_step) {
+                invariant = std::move(new_pre);
+            }
             break;
         }
         ++iteration;
         if (iteration < widening_delay_) {
-            invariant = invariant | new_pre;
+            invariant = join(invariant, new_pre);
         } else {
-            invariant = invariant.widen(new_pre);
+            invariant = widen(invariant, new_pre);
             if (iteration == widening_delay_) {
                 invariant = invariant & constant_limits_;
             }
         }
     }
+    return invariant;
+}
 
+EbpfDomain Extrapolator::refine(EbpfDomain invariant, const Step& step) const {
     // Descending (narrowing) sequence.
     for (unsigned int iteration = 0;;) {
         EbpfDomain new_pre = step(invariant);
-        if (invariant <= new_pre) {
+        if (leq(invariant, new_pre)) {
             break;
         }
         if (++iteration > max_descending_iterations_) {
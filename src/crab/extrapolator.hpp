@@ -11,6 +11,7 @@
 namespace prevail {
 
 struct AnalysisContext;
+class StateMemo;
 
 /// Fixpoint acceleration strategy for a single abstract domain.
 ///
@@ -23,7 +24,9 @@ class Extrapolator final {
   public:
     using Step = std::function<EbpfDomain(const EbpfDomain&)>;
 
-    Extrapolator(const AnalysisContext& context, std::span<const Variable> loop_counters);
+    /// With a `memo`, the joins, widenings and inclusion checks of the iteration go through it.
+    Extrapolator(const AnalysisContext& context, std::span<const Variable> loop_counters,
+                 StateMemo* memo = nullptr);
 
     /// Run the ascending (widening) and descending (narrowing) sequences to
     /// convergence. The step function maps an invariant to the new pre-state
@@ -31,14 +34,38 @@ class Extrapolator final {
     [[nodiscard]]
     EbpfDomain compute_fixpoint(EbpfDomain initial, const Step& step) const;
 
+    /// Run only the ascending (widening) sequence, and return the first post-fixpoint it reaches.
+    /// This is the invariant its last step ran from, so the states the step function computed last
+    /// are those of the returned invariant.
+    [[nodiscard]]
+    EbpfDomain ascend(EbpfDomain initial, const Step& step) const;
+
+    /// Run only the descending (narrowing) sequence, starting from a post-fixpoint of the step
+    /// function, i.e., an invariant that is already inductive.
+    [[nodiscard]]
+    EbpfDomain refine(EbpfDomain invariant, const Step& step) const;
+
     [[nodiscard]]
     std::span<const Variable> loop_counters() const {
         return loop_counters_;
     }
 
   private:
+    /// The ascending sequence. With `take_last_step`, returns the result of the last step, which is
+    /// below the post-fixpoint it ran from, instead of that post-fixpoint.
+    [[nodiscard]]
+    EbpfDomain ascend(EbpfDomain invariant, const Step& step, bool take_last_step) const;
+
+    [[nodiscard]]
+    bool leq(const EbpfDomain& left, const EbpfDomain& right) const;
+    [[nodiscard]]
+    EbpfDomain join(const EbpfDomain& left, const EbpfDomain& right) const;
+    [[nodiscard]]
+    EbpfDomain widen(const EbpfDomain& left, const EbpfDomain& right) const;
+
     EbpfDomain constant_limits_;
     std::vector<Variable> loop_counters_;
+    StateMemo* memo_;
 
     static constexpr unsigned int widening_delay_ = 2;
     static constexpr unsigned int max_descending_iterations_ = 2000000;
@@ -3,7 +3,9 @@
 #pragma once
 
 #include <optional>
+#include <span>
 #include <utility>
+#include <vector>
 
 #include "arith/linear_constraint.hpp"
 #include "arith/variable.hpp"
@@ -57,6 +59,15 @@ class FiniteDomain {
 
     bool operator<=(const FiniteDomain& o) const { return dom <= o.dom; }
 
+    [[nodiscard]]
+    bool identical(const FiniteDomain& o) const {
+        return dom.identical(o.dom);
+    }
+    [[nodiscard]]
+    std::size_t hash() const {
+        return dom.hash();
+    }
+
     // FIXME: can be done more efficient
     void operator|=(const FiniteDomain& o) { *this = *this | o; }
     void operator|=(FiniteDomain&& o) { *this = *this | std::move(o); }
@@ -69,6 +80,15 @@ class FiniteDomain {
 
     FiniteDomain operator|(FiniteDomain&& o) const& { return FiniteDomain{dom | std::move(o.dom)}; }
 
+    static FiniteDomain join(const std::span<const FiniteDomain* const> doms) {
+        std::vector<const ZoneDomain*> zones;
+        zones.reserve(doms.size());
+        for (const FiniteDomain* d : doms) {
+            zones.push_back(&d->dom);
+        }
+        return FiniteDomain{ZoneDomain::join(zones)};
+    }
+
     [[nodiscard]]
     FiniteDomain widen(const FiniteDomain& o) const {
         return FiniteDomain{dom.widen(o.dom)};
@@ -181,6 +201,12 @@ class FiniteDomain {
         return dom.entail(rhs);
     }
 
+    // The index of the first of csts that is not entailed, if any.
+    [[nodiscard]]
+    std::optional<std::size_t> first_not_entailed(const std::span<const LinearConstraint> csts) const {
+        return dom.first_not_entailed(csts);
+    }
+
     friend std::ostream& operator<<(std::ostream& o, const FiniteDomain& dom) { return o << dom.dom; }
 
     [[nodiscard]]
@@ -188,6 +214,11 @@ class FiniteDomain {
         return dom.to_set();
     }
 
+    [[nodiscard]]
+    std::vector<LinearConstraint> to_constraints() const {
+        return dom.to_constraints();
+    }
+
     static void clear_thread_local_state() { ZoneDomain::clear_thread_local_state(); }
 
   private:
@@ -2,8 +2,12 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <cstdint>
 #include <limits>
+#include <optional>
 #include <ranges>
 #include <vector>
 
@@ -115,7 +119,90 @@ class TreeSMap final {
     void clear() { map.clear(); }
 };
 
-// Adaptive sparse-set based weighted graph implementation
+// Edge weights of one graph, by slot. Nearly every weight fits in 64 bits, so they are stored as
+// int64_t, half the size of a Weight. The first weight that does not fit promotes the whole store to
+// Weight; it stays promoted until clear(). Reads return a Weight either way, and narrow() the stored
+// int64_t of a store that is not promoted.
+class WeightStore final {
+    std::vector<int64_t> narrow_;
+    std::vector<Weight> wide_;
+    bool is_wide_{};
+
+    void promote() {
+        wide_.assign(narrow_.begin(), narrow_.end());
+        narrow_ = {};
+        is_wide_ = true;
+    }
+
+  public:
+    [[nodiscard]]
+    size_t size() const {
+        return is_wide_ ? wide_.size() : narrow_.size();
+    }
+
+    [[nodiscard]]
+    bool is_wide() const {
+        return is_wide_;
+    }
+
+    Weight operator[](const size_t idx) const { return is_wide_ ? wide_[idx] : Weight{narrow_[idx]}; }
+
+    // The weight as stored. Precondition: !is_wide().
+    [[nodiscard]]
+    int64_t narrow(const size_t idx) const {
+        assert(!is_wide_);
+        return narrow_[idx];
+    }
+
+    void set(const size_t idx, const int64_t w) {
+        if (is_wide_) {
+            wide_[idx] = Weight{w};
+        } else {
+            narrow_[idx] = w;
+        }
+    }
+
+    void set(const size_t idx, const Weight& w) {
+        if (!is_wide_) {
+            if (w.fits<int64_t>()) {
+                narrow_[idx] = w.cast_to<int64_t>();
+                return;
+            }
+            promote();
+        }
+        wide_[idx] = w;
+    }
+
+    void push_back(const int64_t w) {
+        if (is_wide_) {
+            wide_.emplace_back(w);
+        } else {
+            narrow_.push_back(w);
+        }
+    }
+
+    void push_back(const Weight& w) {
+        if (!is_wide_) {
+            if (w.fits<int64_t>()) {
+                narrow_.push_back(w.cast_to<int64_t>());
+                return;
+            }
+            promote();
+        }
+        wide_.push_back(w);
+    }
+
+    void clear() {
+        narrow_.clear();
+        wide_.clear();
+        is_wide_ = false;
+    }
+};
+
+// Adaptive sparse-set based weighted graph implementation.
+// Edges are kept in sparse successor and predecessor maps. While the graph is small and dense, a
+// matrix of weight slots also answers elem, lookup and edge updates in O(1) instead of a binary
+// search. Edges are always iterated through the maps, so both modes give the same results.
 class AdaptGraph final {
   public:
     AdaptGraph() = default;
@@ -147,9 +234,9 @@ class AdaptGraph final {
         using value_type = EdgeRef;
 
         TreeSMap::ValueIterator it{};
-        const std::vector<Weight>* ws{};
+        const WeightStore* ws{};
 
-        EdgeConstIterator(const TreeSMap::ValueIterator& _it, const std::vector<Weight>& _ws) : it(_it), ws(&_ws) {}
+        EdgeConstIterator(const TreeSMap::ValueIterator& _it, const WeightStore& _ws) : it(_it), ws(&_ws) {}
         EdgeConstIterator(const EdgeConstIterator& o) = default;
         EdgeConstIterator& operator=(const EdgeConstIterator& o) = default;
         EdgeConstIterator() = default;
@@ -171,21 +258,21 @@ class AdaptGraph final {
         using iterator = EdgeConstIterator;
 
         const TreeSMap* entries{&empty_entries()};
-        const std::vector<Weight>* ws{&empty_ws()};
+        const WeightStore* ws{&empty_ws()};
 
       private:
         static const TreeSMap& empty_entries() {
             static const TreeSMap instance;
             return instance;
         }
-        static const std::vector<Weight>& empty_ws() {
-            static std::vector<Weight> instance;
+        static const WeightStore& empty_ws() {
+            static const WeightStore instance;
             return instance;
         }
 
       public:
         EdgeConstRange() = default;
-        EdgeConstRange(const TreeSMap& entries, const std::vector<Weight>& ws) : entries{&entries}, ws{&ws} {}
+        EdgeConstRange(const TreeSMap& entries, const WeightStore& ws) : entries{&entries}, ws{&ws} {}
 
         [[nodiscard]]
         EdgeConstIterator begin() const {
@@ -215,6 +302,23 @@ class AdaptGraph final {
         return {_preds[v], _ws};
     }
 
+    // The edges of v with their weights as stored, for algorithms that run on 64-bit weights.
+    // Precondition (for these and the other narrow accessors): !has_wide_weights().
+    struct NarrowEdge {
+        VertId vert{};
+        int64_t val{};
+    };
+    [[nodiscard]]
+    auto narrow_e_succs(const VertId v) const {
+        return _succs[v] |
+               std::views::transform([this](const auto& e) { return NarrowEdge{e.first, _ws.narrow(e.second)}; });
+    }
+    [[nodiscard]]
+    auto narrow_e_preds(const VertId v) const {
+        return _preds[v] |
+               std::views::transform([this](const auto& e) { return NarrowEdge{e.first, _ws.narrow(e.second)}; });
+    }
+
     // Management
     [[nodiscard]]
     bool is_empty() const {
@@ -228,6 +332,16 @@ class AdaptGraph final {
     size_t num_edges() const {
         return edge_count;
     }
+    // Whether some weight did not fit in 64 bits, so that the weights take their full size.
+    [[nodiscard]]
+    bool has_wide_weights() const {
+        return _ws.is_wide();
+    }
+    // Whether the dense matrix of weight slots is kept.
+    [[nodiscard]]
+    bool is_dense() const {
+        return !dense_.empty();
+    }
     VertId new_vertex() {
         VertId v;
         if (!free_id.empty()) {
@@ -246,6 +360,10 @@ class AdaptGraph final {
             is_free.push_back(false);
             _succs.emplace_back();
             _preds.emplace_back();
+            if (is_dense()) {
+                // The row and column of v are free slots, unless v outgrows the matrix.
+                adapt_density();
+            }
         }
 
         return v;
@@ -267,6 +385,7 @@ class AdaptGraph final {
         for (const auto& [key, val] : _succs[v]) {
             free_widx.push_back(val);
             _preds[key].remove(v);
+            clear_slot(v, key);
         }
         edge_count -= _succs[v].size();
         _succs[v].clear();
@@ -277,12 +396,14 @@ class AdaptGraph final {
             // below; failing to reclaim it leaks _ws slots monotonically.
             free_widx.push_back(val);
             _succs[key].remove(v);
+            clear_slot(key, v);
         }
         edge_count -= _preds[v].size();
         _preds[v].clear();
 
         is_free[v] = true;
         free_id.push_back(v);
+        adapt_density();
     }
 
     void clear_edges() {
@@ -295,6 +416,7 @@ class AdaptGraph final {
             _preds[v].clear();
         }
         edge_count = 0;
+        drop_dense();
     }
     void clear() {
         _ws.clear();
@@ -303,62 +425,63 @@ class AdaptGraph final {
         is_free.clear();
         free_id.clear();
         free_widx.clear();
+        drop_dense();
 
         edge_count = 0;
     }
 
     [[nodiscard]]
     bool elem(const VertId s, const VertId d) const {
-        return _succs[s].contains(d);
+        return slot(s, d).has_value();
     }
 
     [[nodiscard]]
-    const Weight& edge_val(const VertId s, const VertId d) const {
-        return _ws[*_succs[s].lookup(d)];
+    Weight edge_val(const VertId s, const VertId d) const {
+        return _ws[*slot(s, d)];
     }
 
-    Weight* lookup(const VertId s, const VertId d) {
-        if (const auto idx = _succs[s].lookup(d)) {
-            return &_ws[*idx];
+    // The weight of the edge s -> d, if any. Weights are changed through set_edge and update_edge.
+    [[nodiscard]]
+    std::optional<Weight> lookup(const VertId s, const VertId d) const {
+        if (const auto idx = slot(s, d)) {
+            return _ws[*idx];
         }
-        return {};
+        return std::nullopt;
     }
 
     [[nodiscard]]
-    const Weight* lookup(const VertId s, const VertId d) const {
-        if (const auto idx = _succs[s].lookup(d)) {
-            return &_ws[*idx];
+    std::optional<int64_t> narrow_lookup(const VertId s, const VertId d) const {
+        if (const auto idx = slot(s, d)) {
+            return _ws.narrow(*idx);
         }
-        return {};
+        return std::nullopt;
     }
 
-    void add_edge(const VertId s, const Weight& w, const VertId d) {
-        size_t idx;
-        if (!free_widx.empty()) {
-            idx = free_widx.back();
-            free_widx.pop_back();
-            _ws[idx] = w;
+    void add_edge(const VertId s, const Weight& w, const VertId d) { insert_edge(s, w, d); }
+
+    // add_edge and set_edge for 64-bit weights, stored without a range check.
+    void add_narrow_edge(const VertId s, const int64_t w, const VertId d) { insert_edge(s, w, d); }
+    void set_narrow_edge(const VertId s, const int64_t w, const VertId d) {
+        if (const auto idx = slot(s, d)) {
+            _ws.set(*idx, w);
         } else {
-            idx = _ws.size();
-            _ws.push_back(w);
+            add_narrow_edge(s, w, d);
         }
-
-        _succs[s].add(d, idx);
-        _preds[d].add(s, idx);
-        edge_count++;
     }
 
     void update_edge(const VertId s, const Weight& w, const VertId d) {
-        if (const auto idx = _succs[s].lookup(d)) {
-            _ws[*idx] = std::min(_ws[*idx], w);
+        if (const auto idx = slot(s, d)) {
+            if (w < _ws[*idx]) {
+                _ws.set(*idx, w);
+            }
         } else {
             add_edge(s, w, d);
         }
     }
 
     void set_edge(const VertId s, const Weight& w, const VertId d) {
-        if (const auto idx = _succs[s].lookup(d)) {
-            _ws[*idx] = w;
+        if (const auto idx = slot(s, d)) {
+            _ws.set(*idx, w);
         } else {
             add_edge(s, w, d);
         }
@@ -388,9 +511,94 @@ class AdaptGraph final {
     }
 
   private:
+    // The dense matrix is kept up to this many vertices, from a quarter of the possible edges
+    // down to an eighth, so that a graph near the threshold does not switch at every edge.
+    static constexpr size_t max_dense_size = 64;
+    static constexpr uint32_t no_slot = std::numeric_limits<uint32_t>::max();
+
+    [[nodiscard]]
+    std::optional<size_t> slot(const VertId s, const VertId d) const {
+        if (is_dense()) {
+            if (const uint32_t idx = dense_[s * dense_stride_ + d]; idx != no_slot) {
+                return idx;
+            }
+            return std::nullopt;
+        }
+        return _succs[s].lookup(d);
+    }
+
+    void clear_slot(const VertId s, const VertId d) {
+        if (is_dense()) {
+            dense_[s * dense_stride_ + d] = no_slot;
+        }
+    }
+
+    // Link a new edge s -> d to a free weight slot holding w, a Weight or an int64_t.
+    template <typename W>
+    void insert_edge(const VertId s, const W& w, const VertId d) {
+        size_t idx;
+        if (!free_widx.empty()) {
+            idx = free_widx.back();
+            free_widx.pop_back();
+            _ws.set(idx, w);
+        } else {
+            idx = _ws.size();
+            _ws.push_back(w);
+        }
+
+        _succs[s].add(d, idx);
+        _preds[d].add(s, idx);
+        edge_count++;
+        if (is_dense()) {
+            assert(idx < no_slot);
+            dense_[s * dense_stride_ + d] = static_cast<uint32_t>(idx);
+        } else {
+            adapt_density();
+        }
+    }
+
+    // Build or drop the dense matrix as the size and the number of edges change.
+    void adapt_density() {
+        const size_t sz = size();
+        if (is_dense()) {
+            if (sz > max_dense_size || edge_count * 8 < sz * sz) {
+                drop_dense();
+            } else if (sz > dense_stride_) {
+                build_dense(sz);
+            }
+            return;
+        }
+        if (sz == 0 || sz > max_dense_size || edge_count * 4 < sz * sz) {
+            return;
+        }
+        build_dense(sz);
+    }
+
+    // Rows have room for a power of two of vertices, so adding vertices one by one rebuilds the
+    // matrix only when their number doubles.
+    void build_dense(const size_t sz) {
+        dense_stride_ = std::min(std::bit_ceil(sz), max_dense_size);
+        dense_.assign(dense_stride_ * dense_stride_, no_slot);
+        for (size_t s = 0; s < sz; ++s) {
+            for (const auto& [d, idx] : _succs[s]) {
+                assert(idx < no_slot);
+                dense_[s * dense_stride_ + d] = static_cast<uint32_t>(idx);
+            }
+        }
+    }
+
+    void drop_dense() {
+        dense_ = {};
+        dense_stride_ = 0;
+    }
+
     std::vector<TreeSMap> _preds{};
     std::vector<TreeSMap> _succs{};
-    std::vector<Weight> _ws{};
+    WeightStore _ws{};
+    // The weight slot of each edge s -> d at dense_[s * dense_stride_ + d], or no_slot; empty when
+    // sparse.
+    std::vector<uint32_t> dense_{};
+    size_t dense_stride_{};
 
     size_t edge_count{};
 
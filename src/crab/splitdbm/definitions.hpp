@@ -9,7 +9,8 @@
 
 namespace splitdbm {
 
-// DBM weights use Number (backed by checked i128 arithmetic).
+// DBM weights use Number (backed by checked i128 arithmetic). Graphs store them in 64 bits while
+// they fit (see WeightStore), and close_over_edge and graph_join compute on those directly.
 using Weight = prevail::Number;
 
 using VertId = uint16_t;
@@ -7,7 +7,12 @@
 // Functions that need temporary storage take a ScratchSpace& parameter.
 
 #include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <ranges>
+#include <type_traits>
 #include <unordered_set>
 
 #include "crab/splitdbm/graph_views.hpp"
@@ -32,7 +37,10 @@ inline auto make_heap(const std::vector<Weight>& dists) {
 // Scratch space needed by graph algorithms. Lazily grows on demand.
 // Intended to be wrapped in a single LazyAllocator<ScratchSpace> at the call site.
 struct ScratchSpace {
-    std::vector<int> edge_marks;
+    // Colour of each edge of the graph closed by close_after_meet: by source vertex, the marks of
+    // its out-edges sorted by destination. Grows with the edges rather than with the square of
+    // the vertices.
+    std::vector<std::vector<std::pair<VertId, int>>> edge_marks;
     std::vector<VertId> dual_queue;
     std::vector<int> vert_marks;
     std::vector<int> stability;
@@ -56,6 +64,14 @@ struct ScratchSpace {
         return make_heap(dists);
     }
 
+    [[nodiscard]]
+    int edge_mark(const VertId src, const VertId dest) const {
+        const auto& marks = edge_marks.at(src);
+        const auto it = std::ranges::lower_bound(marks, dest, {}, &std::pair<VertId, int>::first);
+        assert(it != marks.end() && it->first == dest);
+        return it->second;
+    }
+
     void grow(const size_t sz) {
         if (sz <= scratch_sz) {
             return;
@@ -65,7 +81,7 @@ struct ScratchSpace {
             new_sz *= 2;
         }
 
-        edge_marks.resize(new_sz * new_sz);
+        edge_marks.resize(new_sz);
         dual_queue.resize(2 * new_sz);
         vert_marks.resize(new_sz);
         stability.resize(new_sz);
@@ -81,6 +97,15 @@ struct ScratchSpace {
 // Pure graph construction operations (no scratch needed)
 // ============================================================================
 
+// a + b, if it fits in 64 bits.
+inline std::optional<int64_t> narrow_add(const int64_t a, const int64_t b) {
+    if ((b > 0 && a > std::numeric_limits<int64_t>::max() - b) ||
+        (b < 0 && a < std::numeric_limits<int64_t>::min() - b)) {
+        return std::nullopt;
+    }
+    return a + b;
+}
+
 // Syntactic join.
 Graph graph_join(const ReadableGraph auto& l, const ReadableGraph auto& r) {
     assert(l.size() == r.size());
@@ -89,6 +114,21 @@ Graph graph_join(const ReadableGraph auto& l, const ReadableGraph auto& r) {
     Graph g;
     g.growTo(sz);
 
+    // The max of two 64-bit weights is one of them: join graphs without wide weights on their own.
+    if constexpr (std::same_as<std::remove_cvref_t<decltype(l)>, Graph> &&
+                  std::same_as<std::remove_cvref_t<decltype(r)>, Graph>) {
+        if (!l.has_wide_weights() && !r.has_wide_weights()) {
+            for (const VertId s : l.verts()) {
+                for (const auto& e : l.narrow_e_succs(s)) {
+                    if (const auto pw = r.narrow_lookup(s, e.vert)) {
+                        g.add_narrow_edge(s, std::max(e.val, *pw), e.vert);
+                    }
+                }
+            }
+            return g;
+        }
+    }
+
     for (const VertId s : l.verts()) {
         for (const auto& e : l.e_succs(s)) {
             const VertId d = e.vert;
@@ -119,13 +159,7 @@ Graph graph_meet(const ReadableGraph auto& l, const ReadableGraph auto& r, bool&
 
     for (VertId s : r.verts()) {
         for (const auto& e : r.e_succs(s)) {
-            if (Weight* pw = g.lookup(s, e.vert)) {
-                if (e.val < *pw) {
-                    *pw = e.val;
-                }
-            } else {
-                g.add_edge(s, e.val, e.vert);
-            }
+            g.update_edge(s, e.val, e.vert);
         }
     }
     is_closed = false;
@@ -166,8 +200,83 @@ inline void apply_delta(Graph& g, const EdgeVector& delta) {
     }
 }
 
+// close_over_edge on the weights of g as stored, when g has no wide weight and no sum of weights
+// can overflow 64 bits. Returns false, with g unchanged, otherwise.
+inline bool close_over_edge_narrow(Graph& g, const VertId ii, const VertId jj) {
+    if (g.has_wide_weights()) {
+        return false;
+    }
+    const int64_t c = *g.narrow_lookup(ii, jj);
+
+    // Every sum below lies between the sums of the extreme weights, so only those are checked.
+    // The ranges include 0, which only adds sums that are checked anyway.
+    int64_t pred_min = 0;
+    int64_t pred_max = 0;
+    for (const auto& edge : g.narrow_e_preds(ii)) {
+        if (edge.vert != 0) {
+            pred_min = std::min(pred_min, edge.val);
+            pred_max = std::max(pred_max, edge.val);
+        }
+    }
+    int64_t succ_min = 0;
+    int64_t succ_max = 0;
+    for (const auto& edge : g.narrow_e_succs(jj)) {
+        if (edge.vert != 0) {
+            succ_min = std::min(succ_min, edge.val);
+            succ_max = std::max(succ_max, edge.val);
+        }
+    }
+    const auto low = narrow_add(pred_min, c);
+    const auto high = narrow_add(pred_max, c);
+    if (!low || !high || !narrow_add(*low, succ_min) || !narrow_add(*high, succ_max)) {
+        return false;
+    }
+
+    std::vector<std::pair<VertId, int64_t>> src_dec;
+    for (const auto& edge : g.narrow_e_preds(ii)) {
+        const VertId se = edge.vert;
+        const int64_t wt_sij = edge.val + c;
+        if (se != 0 && se != jj) {
+            if (const auto w = g.narrow_lookup(se, jj); w && *w <= wt_sij) {
+                continue;
+            }
+            g.set_narrow_edge(se, wt_sij, jj);
+            src_dec.emplace_back(se, edge.val);
+        }
+    }
+
+    std::vector<std::pair<VertId, int64_t>> dest_dec;
+    for (const auto& edge : g.narrow_e_succs(jj)) {
+        const VertId de = edge.vert;
+        const int64_t wt_ijd = edge.val + c;
+        if (de != 0 && de != ii) {
+            if (const auto w = g.narrow_lookup(ii, de); w && *w <= wt_ijd) {
+                continue;
+            }
+            g.set_narrow_edge(ii, wt_ijd, de);
+            dest_dec.emplace_back(de, edge.val);
+        }
+    }
+
+    for (const auto& [se, p1] : src_dec) {
+        const int64_t wt_sij = c + p1;
+        for (const auto& [de, p2] : dest_dec) {
+            const int64_t wt_sijd = wt_sij + p2;
+            if (const auto w = g.narrow_lookup(se, de); w && *w <= wt_sijd) {
+                continue;
+            }
+            g.set_narrow_edge(se, wt_sijd, de);
+        }
+    }
+    return true;
+}
+
+// Close g over the edge ii -> jj. Sums that overflow 64 bits are done on Weight, which promotes g.
 inline void close_over_edge(Graph& g, const VertId ii, const VertId jj) {
     assert(ii != 0 && jj != 0);
+    if (close_over_edge_narrow(g, ii, jj)) {
+        return;
+    }
     SubGraph g_excl(g, 0);
 
     const Weight c = g_excl.edge_val(ii, jj);
@@ -179,14 +288,10 @@ inline void close_over_edge(Graph& g, const VertId ii, const VertId jj) {
 
         assert(!std::ranges::empty(g_excl.succs(se)));
         if (se != jj) {
-            if (Weight* pw = g_excl.lookup(se, jj)) {
-                if (*pw <= wt_sij) {
-                    continue;
-                }
-                *pw = wt_sij;
-            } else {
-                g_excl.add_edge(se, wt_sij, jj);
+            if (const auto w = g_excl.lookup(se, jj); w && *w <= wt_sij) {
+                continue;
             }
+            g_excl.set_edge(se, wt_sij, jj);
             src_dec.emplace_back(se, edge.val);
         }
     }
@@ -196,14 +301,10 @@ inline void close_over_edge(Graph& g, const VertId ii, const VertId jj) {
         VertId de = edge.vert;
         Weight wt_ijd = edge.val + c;
         if (de != ii) {
-            if (Weight* pw = g_excl.lookup(ii, de)) {
-                if (*pw <= wt_ijd) {
-                    continue;
-                }
-                *pw = wt_ijd;
-            } else {
-                g_excl.add_edge(ii, wt_ijd, de);
+            if (const auto w = g_excl.lookup(ii, de); w && *w <= wt_ijd) {
+                continue;
             }
+            g_excl.set_edge(ii, wt_ijd, de);
             dest_dec.emplace_back(de, edge.val);
         }
     }
@@ -212,14 +313,10 @@ inline void close_over_edge(Graph& g, const VertId ii, const VertId jj) {
         Weight wt_sij = c + p1;
         for (const auto& [de, p2] : dest_dec) {
             Weight wt_sijd = wt_sij + p2;
-            if (Weight* pw = g.lookup(se, de)) {
-                if (*pw <= wt_sijd) {
-                    continue;
-                }
-                *pw = wt_sijd;
-            } else {
-                g.add_edge(se, wt_sijd, de);
+            if (const auto w = g.lookup(se, de); w && *w <= wt_sijd) {
+                continue;
             }
+            g.set_edge(se, wt_sijd, de);
         }
     }
 }
@@ -297,7 +394,7 @@ void chromatic_dijkstra(ScratchSpace& scratch, const ReadableGraph auto& g, cons
         scratch.dists.at(dest) = p(src) + e.val - p(dest);
         scratch.dist_ts.at(dest) = scratch.ts;
 
-        scratch.vert_marks.at(dest) = scratch.edge_marks.at(sz * src + dest);
+        scratch.vert_marks.at(dest) = scratch.edge_mark(src, dest);
         heap.insert(dest);
     }
 
@@ -323,7 +420,7 @@ void chromatic_dijkstra(ScratchSpace& scratch, const ReadableGraph auto& g, cons
             if (scratch.dist_ts.at(ed) != scratch.ts || v < scratch.dists.at(ed)) {
                 scratch.dists.at(ed) = v;
                 scratch.dist_ts.at(ed) = scratch.ts;
-                scratch.vert_marks.at(ed) = scratch.edge_marks.at(sz * es + ed);
+                scratch.vert_marks.at(ed) = scratch.edge_mark(es, ed);
 
                 if (heap.inHeap(ed)) {
                     heap.decrease(ed);
@@ -331,7 +428,7 @@ void chromatic_dijkstra(ScratchSpace& scratch, const ReadableGraph auto& g, cons
                     heap.insert(ed);
                 }
             } else if (v == scratch.dists.at(ed)) {
-                scratch.vert_marks.at(ed) |= scratch.edge_marks.at(sz * es + ed);
+                scratch.vert_marks.at(ed) |= scratch.edge_mark(es, ed);
             }
         }
     }
@@ -554,6 +651,8 @@ EdgeVector close_after_meet(ScratchSpace& scratch, const ReadableGraph auto& g,
     std::vector<std::vector<VertId>> colour_succs(2 * sz);
 
     for (VertId s : g.verts()) {
+        auto& marks = scratch.edge_marks.at(s);
+        marks.clear();
         for (const auto& e : g.e_succs(s)) {
             int mark = 0;
             const VertId d = e.vert;
@@ -573,7 +672,10 @@ EdgeVector close_after_meet(ScratchSpace& scratch, const ReadableGraph auto& g,
             case E_RIGHT: colour_succs[2 * s + 1].push_back(d); break;
             default: break;
             }
-            scratch.edge_marks.at(sz * s + d) = mark;
+            marks.emplace_back(d, mark);
+        }
+        if (!std::ranges::is_sorted(marks)) {
+            std::ranges::sort(marks);
         }
     }
 
@@ -14,6 +14,7 @@
 //     RIGHT:  std::ranges::empty(v.succs(x))            // single view object
 
 #include <concepts>
+#include <optional>
 #include <ranges>
 
 #include "crab/splitdbm/adapt_sgraph.hpp"
@@ -49,9 +50,9 @@ class GraphPerm {
     }
 
     [[nodiscard]]
-    const Weight* lookup(const VertId x, const VertId y) const {
+    std::optional<Weight> lookup(const VertId x, const VertId y) const {
         if (perm[x] >= g.size() || perm[y] >= g.size()) {
-            return nullptr;
+            return std::nullopt;
         }
         return g.lookup(perm[x], perm[y]);
     }
@@ -120,7 +121,7 @@ concept ReadableGraph = requires(const G& g, VertId v, VertId u) {
     { g.size() } -> std::convertible_to<size_t>;
     { g.elem(v, u) } -> std::convertible_to<bool>;
     { g.edge_val(v, u) } -> std::convertible_to<Weight>;
-    { g.lookup(v, u) } -> std::same_as<const Weight*>;
+    { g.lookup(v, u) } -> std::same_as<std::optional<Weight>>;
     g.verts();
     g.succs(v);
     g.preds(v);
@@ -139,17 +140,10 @@ class SubGraph {
         return x != v_ex && y != v_ex && g.elem(x, y);
     }
 
-    Weight* lookup(VertId x, VertId y) {
-        if (x == v_ex || y == v_ex) {
-            return nullptr;
-        }
-        return g.lookup(x, y);
-    }
-
     [[nodiscard]]
-    const Weight* lookup(VertId x, VertId y) const {
+    std::optional<Weight> lookup(VertId x, VertId y) const {
         if (x == v_ex || y == v_ex) {
-            return nullptr;
+            return std::nullopt;
         }
         return g.lookup(x, y);
     }
@@ -218,9 +212,8 @@ class GraphRev {
         return g.elem(y, x);
     }
 
-    Weight* lookup(VertId x, VertId y) { return g.lookup(y, x); }
     [[nodiscard]]
-    const Weight* lookup(VertId x, VertId y) const {
+    std::optional<Weight> lookup(VertId x, VertId y) const {
         return g.lookup(y, x);
     }
 
@@ -1,6 +1,9 @@
 // Copyright (c) Prevail Verifier contributors.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <algorithm>
+#include <utility>
+
 #include "crab/splitdbm/split_dbm.hpp"
 #include "crab/splitdbm/definitions.hpp"
 
@@ -8,6 +11,21 @@ namespace splitdbm {
 
 namespace {
 
+// Copy the edges of the selected vertices, renumbered, that stay within them or go to vertex 0.
+void copy_edges(const Graph& g, const std::span<const VertId> verts, const std::vector<VertId>& renumber,
+                Graph& out) {
+    for (const VertId v : verts) {
+        for (const auto& e : g.e_succs(v)) {
+            if (e.vert == 0 || renumber[e.vert] != 0) {
+                out.add_edge(renumber[v], e.val, renumber[e.vert]);
+            }
+        }
+        if (const auto w = g.lookup(0, v)) {
+            out.add_edge(0, *w, renumber[v]);
+        }
+    }
+}
+
 // Compute deferred relations: bounds from bound_source applied to relations from rel_source.
 Graph compute_deferred(const ReadableGraph auto& bound_source, ReadableGraph auto& rel_source, const size_t sz) {
     Graph deferred;
@@ -45,7 +63,14 @@ SplitDBM::SplitDBM() {
 
 SplitDBM::SplitDBM(Graph&& g, std::vector<Weight>&& pot, VertSet&& unstable)
     : g_(std::move(g)), potential_(std::move(pot)), unstable_(std::move(unstable)) {
-    normalize();
+    if (!unstable_.empty()) {
+        close_widened();
+    }
+}
+
+void SplitDBM::settle() {
+    unstable_.clear();
+    closure_edits_.clear();
 }
 
 bool SplitDBM::is_top() const { return g_.is_empty(); }
@@ -58,8 +83,9 @@ prevail::ExtendedNumber SplitDBM::get_bound(const VertId v, const Side side) con
     }
 }
 
-// Callers must call normalize() after set_bound() to restore closure.
+// Does not close the graph over the new bound.
 void SplitDBM::set_bound(const VertId v, const Side side, const Weight& bound_value) {
+    settle();
     if (side == Side::LEFT) {
         g_.set_edge(v, -bound_value, 0);
     } else {
@@ -69,6 +95,7 @@ void SplitDBM::set_bound(const VertId v, const Side side, const Weight& bound_va
 }
 
 VertId SplitDBM::new_vertex() {
+    settle();
     const VertId vert = g_.new_vertex();
     if (vert >= potential_.size()) {
         potential_.emplace_back(0);
@@ -78,15 +105,20 @@ VertId SplitDBM::new_vertex() {
     return vert;
 }
 
-void SplitDBM::forget(const VertId v) { g_.forget(v); }
+void SplitDBM::forget(const VertId v) {
+    settle();
+    g_.forget(v);
+}
 
 const Graph& SplitDBM::graph() const { return g_; }
 
 bool SplitDBM::repair_potential(const VertId src, const VertId dest) {
+    settle();
     return splitdbm::repair_potential(*scratch_, g_, potential_, src, dest);
 }
 
 bool SplitDBM::update_bound_if_tighter(const VertId v, const Side side, const Weight& new_bound) {
+    settle();
     if (side == Side::LEFT) {
         if (const auto w = g_.lookup(v, 0)) {
             if (*w <= -new_bound) {
@@ -107,6 +139,7 @@ bool SplitDBM::update_bound_if_tighter(const VertId v, const Side side, const We
 }
 
 bool SplitDBM::add_difference_constraint(const VertId src, const VertId dest, const Weight& k) {
+    settle();
     g_.update_edge(src, k, dest);
     if (!repair_potential(src, dest)) {
         return false;
@@ -116,6 +149,7 @@ bool SplitDBM::add_difference_constraint(const VertId src, const VertId dest, co
 }
 
 void SplitDBM::close_after_bound_updates() {
+    settle();
     apply_delta(close_after_assign(*scratch_, g_, [this](const VertId v) { return potential_[v]; }, 0));
 }
 
@@ -161,6 +195,38 @@ std::size_t SplitDBM::num_edges() const { return g_.num_edges(); }
 
 bool SplitDBM::vertex_has_edges(const VertId v) const { return g_.succs(v).size() > 0 || g_.preds(v).size() > 0; }
 
+const VertSet& SplitDBM::unstable() const { return unstable_; }
+
+std::span<const SplitDBM::ClosureEdit> SplitDBM::closure_edits() const { return closure_edits_; }
+
+bool SplitDBM::is_closed() const {
+    // A path s -> k -> d must be implied by the edge s -> d, or by the bounds of s and d.
+    for (const VertId s : g_.verts()) {
+        for (const auto& first : g_.e_succs(s)) {
+            if (first.vert == 0) {
+                continue;
+            }
+            for (const auto& second : g_.e_succs(first.vert)) {
+                const VertId d = second.vert;
+                if (d == s) {
+                    continue;
+                }
+                const Weight path = first.val + second.val;
+                if (const auto w = g_.lookup(s, d); w && *w <= path) {
+                    continue;
+                }
+                const auto to_zero = g_.lookup(s, 0);
+                const auto from_zero = g_.lookup(0, d);
+                if (s != 0 && d != 0 && to_zero && from_zero && *to_zero + *from_zero <= path) {
+                    continue;
+                }
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 std::vector<VertId> SplitDBM::get_disconnected_vertices() const {
     std::vector<VertId> result;
     for (VertId v : g_.verts()) {
@@ -175,6 +241,7 @@ std::vector<VertId> SplitDBM::get_disconnected_vertices() const {
 }
 
 bool SplitDBM::strengthen_bound(const VertId v, const Side side, const Weight& bound_value) {
+    settle();
     if (side == Side::LEFT) {
         const Weight edge_weight = -bound_value;
         const auto w = g_.lookup(v, 0);
@@ -216,11 +283,7 @@ bool SplitDBM::strengthen_bound(const VertId v, const Side side, const Weight& b
     return true;
 }
 
-void SplitDBM::normalize() {
-    if (unstable_.empty()) {
-        return;
-    }
-
+void SplitDBM::close_widened() {
     // close_after_widen expects an is_stable predicate: returns true iff v is stable.
     // Vertices in unstable_ are NOT stable, so we negate the membership test.
     struct IsStable {
@@ -229,11 +292,51 @@ void SplitDBM::normalize() {
         bool operator[](const VertId v) const { return !unstable.contains(v); }
     };
 
+    const auto record = [this](const EdgeVector& delta) {
+        for (const auto& [s, d, w] : delta) {
+            closure_edits_.push_back({s, d, g_.lookup(s, d)});
+            g_.set_edge(s, w, d);
+        }
+    };
     const auto p = [this](const VertId v) { return potential_[v]; };
-    apply_delta(close_after_widen(*scratch_, SubGraph(g_, 0), p, IsStable(unstable_)));
-    apply_delta(close_after_assign(*scratch_, g_, p, 0));
+    record(close_after_widen(*scratch_, SubGraph(g_, 0), p, IsStable(unstable_)));
+    record(close_after_assign(*scratch_, g_, p, 0));
+
+    // Keep the first edit of each edge, whose weight is the widened one.
+    const auto edge = [](const ClosureEdit& e) { return std::pair{e.src, e.dest}; };
+    std::ranges::stable_sort(closure_edits_, {}, edge);
+    const auto [first, last] = std::ranges::unique(closure_edits_, {}, edge);
+    closure_edits_.erase(first, last);
+}
 
-    unstable_.clear();
+Graph SplitDBM::widened_graph(const std::vector<VertId>& perm) const {
+    const auto edge = [](const ClosureEdit& e) { return std::pair{e.src, e.dest}; };
+    std::vector<VertId> inv(g_.size(), GraphPerm::invalid_vert);
+    for (VertId i = 0; i < perm.size(); ++i) {
+        if (perm[i] < g_.size()) {
+            inv[perm[i]] = i;
+        }
+    }
+    Graph g;
+    g.growTo(perm.size());
+    for (VertId i = 0; i < perm.size(); ++i) {
+        const VertId s = perm[i];
+        if (s >= g_.size()) {
+            continue;
+        }
+        for (const auto& e : g_.e_succs(s)) {
+            if (inv[e.vert] == GraphPerm::invalid_vert) {
+                continue;
+            }
+            const auto it = std::ranges::lower_bound(closure_edits_, std::pair{s, e.vert}, {}, edge);
+            if (it == closure_edits_.end() || it->src != s || it->dest != e.vert) {
+                g.add_edge(i, e.val, inv[e.vert]);
+            } else if (it->before) {
+                g.add_edge(i, *it->before, inv[e.vert]);
+            }
+        }
+    }
+    return g;
 }
 
 void SplitDBM::clear_thread_local_state() { scratch_.clear(); }
@@ -363,13 +466,19 @@ SplitDBM SplitDBM::widen(const AlignedPair& aligned) {
     }
     result_pot[0] = 0;
 
-    // Build aligned views
-    const GraphPerm gx(aligned.left_perm, aligned.left.g_);
-    const GraphPerm gy(aligned.right_perm, aligned.right.g_);
+    // The unstable vertices of the left operand, in the aligned numbering.
+    VertSet result_unstable;
+    for (VertId i = 0; i < sz; ++i) {
+        if (aligned.left.unstable_.contains(aligned.left_perm[i])) {
+            result_unstable.insert(i);
+        }
+    }
 
-    // Perform the widening
-    VertSet result_unstable(aligned.left.unstable_);
-    Graph result_g(graph_widen(gx, gy, result_unstable));
+    // Build aligned views. The left graph is taken as the widening that produced it left it.
+    const GraphPerm gy(aligned.right_perm, aligned.right.g_);
+    Graph result_g = aligned.left.closure_edits_.empty()
+                         ? graph_widen(GraphPerm(aligned.left_perm, aligned.left.g_), gy, result_unstable)
+                         : graph_widen(aligned.left.widened_graph(aligned.left_perm), gy, result_unstable);
 
     return {std::move(result_g), std::move(result_pot), std::move(result_unstable)};
 }
@@ -398,4 +507,45 @@ std::optional<SplitDBM> SplitDBM::meet(AlignedPair& aligned) {
     return SplitDBM(std::move(result_g), std::move(result_pot), VertSet{});
 }
 
+SplitDBM SplitDBM::product(const std::span<const DbmPart> parts) {
+    size_t sz = 1;
+    for (const DbmPart& part : parts) {
+        sz += part.verts.size();
+    }
+    Graph result_g;
+    result_g.growTo(sz);
+    std::vector<Weight> result_pot;
+    result_pot.reserve(sz);
+    result_pot.emplace_back(0);
+    // The widening state of the parts, renumbered.
+    VertSet result_unstable;
+    std::vector<ClosureEdit> result_edits;
+
+    // Potentials are shifted so that vertex 0 has potential 0 in every part.
+    std::vector<VertId> renumber;
+    VertId next = 1;
+    for (const DbmPart& part : parts) {
+        const Graph& g = part.dbm.g_;
+        renumber.assign(g.size(), 0);
+        for (const VertId v : part.verts) {
+            renumber[v] = next++;
+            result_pot.push_back(part.dbm.potential_[v] - part.dbm.potential_[0]);
+            if (part.dbm.unstable_.contains(v)) {
+                result_unstable.insert(renumber[v]);
+            }
+        }
+        copy_edges(g, part.verts, renumber, result_g);
+        for (const auto& [src, dest, before] : part.dbm.closure_edits_) {
+            if ((src == 0 || renumber[src] != 0) && (dest == 0 || renumber[dest] != 0)) {
+                result_edits.push_back({renumber[src], renumber[dest], before});
+            }
+        }
+    }
+    SplitDBM result(std::move(result_g), std::move(result_pot), VertSet{});
+    result.unstable_ = std::move(result_unstable);
+    result.closure_edits_ = std::move(result_edits);
+    std::ranges::sort(result.closure_edits_, {}, [](const ClosureEdit& e) { return std::pair{e.src, e.dest}; });
+    return result;
+}
+
 } // namespace splitdbm
@@ -3,6 +3,7 @@
 #pragma once
 
 #include <optional>
+#include <span>
 #include <vector>
 
 #include "arith/num_extended.hpp"
@@ -27,6 +28,7 @@ enum class Side : bool {
 
 // Forward declaration for SplitDBM's static methods
 struct AlignedPair;
+struct DbmPart;
 
 // =============================================================================
 // SplitDBM: The Split Difference Bound Matrix implementation.
@@ -36,25 +38,44 @@ struct AlignedPair;
 // relative to vertex 0). Has no concept of Variable — only VertId and Side.
 
 class SplitDBM {
+  public:
+    // An edge that closing a widened graph tightened or added, with its weight before (none if added).
+    struct ClosureEdit {
+        VertId src;
+        VertId dest;
+        std::optional<Weight> before;
+    };
+
+  private:
     Graph g_;
     std::vector<Weight> potential_;
+    // The vertices that lost an edge in the widening this graph comes from, and the edits its
+    // closure made, sorted by edge. The next widening starts from the graph as that widening left
+    // it, as in the SAS'16 paper, so unstable vertices accumulate until the graph is updated.
     VertSet unstable_;
+    std::vector<ClosureEdit> closure_edits_;
 
     static inline thread_local prevail::LazyAllocator<ScratchSpace> scratch_;
 
+    // Forget the widening the graph comes from, before updating it.
+    void settle();
     void apply_delta(const EdgeVector& delta);
     void close_after_assign_vertex(VertId v);
+    // Close the unstable vertices of a widened graph (close_after_widen + close_after_assign),
+    // recording the edits.
+    void close_widened();
+    // The graph as the widening it comes from left it, g_ with the closure edits undone, with each
+    // vertex i of the result taken from vertex perm[i].
+    [[nodiscard]]
+    Graph widened_graph(const std::vector<VertId>& perm) const;
 
   public:
     SplitDBM();
 
+    // The graph is closed, unless `unstable` is not empty: then it is a widened graph, whose
+    // unstable vertices are closed here.
     SplitDBM(Graph&& g, std::vector<Weight>&& pot, VertSet&& unstable);
 
-    SplitDBM(const SplitDBM&) = default;
-    SplitDBM(SplitDBM&&) = default;
-    SplitDBM& operator=(const SplitDBM&) = default;
-    SplitDBM& operator=(SplitDBM&&) = default;
-
     [[nodiscard]]
     bool is_top() const;
 
@@ -133,6 +154,18 @@ class SplitDBM {
     [[nodiscard]]
     bool vertex_has_edges(VertId v) const;
 
+    // Whether every path of two edges is implied by an edge or by the bounds of its ends, so that
+    // the bounds and differences read from the graph are exact. For assertions and tests.
+    [[nodiscard]]
+    bool is_closed() const;
+
+    // The widening the graph comes from: its unstable vertices, and the edits closing it made, sorted
+    // by edge. Both are empty once the graph is updated.
+    [[nodiscard]]
+    const VertSet& unstable() const;
+    [[nodiscard]]
+    std::span<const ClosureEdit> closure_edits() const;
+
     // Get all vertices with no edges (excluding vertex 0) for garbage collection
     [[nodiscard]]
     std::vector<VertId> get_disconnected_vertices() const;
@@ -142,16 +175,6 @@ class SplitDBM {
     // Difference: also propagates tighter bound transitively to neighbor bounds.
     bool strengthen_bound(VertId v, Side side, const Weight& bound_value);
 
-    // WARNING: Known bug — eager normalization defeats widening convergence.
-    // normalize() runs close_after_widen + close_after_assign and clears unstable_.
-    // In the original CRAB, normalization was lazy — triggered only at query points
-    // (operator<=, get_interval), not after every mutation. Widened results stayed
-    // non-normalized until needed.
-    //
-    // A proper fix requires lazy normalization (e.g., mutable on SplitDBM internals
-    // or a normalized_ flag checked by const methods). This is non-trivial.
-    void normalize();
-
     // Clear the thread-local scratch space used by graph algorithms.
     static void clear_thread_local_state();
 
@@ -163,6 +186,19 @@ class SplitDBM {
     static SplitDBM widen(const AlignedPair& aligned);
     static std::optional<SplitDBM> meet(AlignedPair& aligned);
     static bool is_subsumed_by(const SplitDBM& left, const SplitDBM& right, const std::vector<VertId>& perm);
+
+    // Build one SplitDBM from the selected vertices of each part, numbered from 1 in order.
+    // Only edges between selected vertices of the same part (and to vertex 0) are kept.
+    static SplitDBM product(std::span<const DbmPart> parts);
+};
+
+// =============================================================================
+// DbmPart: Selected vertices of a SplitDBM, for SplitDBM::product
+// =============================================================================
+
+struct DbmPart {
+    const SplitDBM& dbm;
+    std::span<const VertId> verts;
 };
 
 // =============================================================================
@@ -0,0 +1,129 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#include "crab/state_memo.hpp"
+
+#include <array>
+
+#include <boost/container_hash/hash.hpp>
+
+namespace prevail {
+
+StateMemo::StateMemo(const size_t capacity) : capacity_(capacity) {}
+
+size_t StateMemo::KeyHash::operator()(const Key& key) const {
+    size_t seed = static_cast<size_t>(key.op);
+    boost::hash_range(seed, key.operands.begin(), key.operands.end());
+    return seed;
+}
+
+StateMemo::StateId StateMemo::intern_locked(const EbpfDomain& dom, const size_t hash) {
+    if (const auto it = states_.find(hash); it != states_.end()) {
+        for (const auto& [id, state] : it->second) {
+            if (state.identical(dom)) {
+                return id;
+            }
+        }
+    }
+    if (interned_ >= capacity_) {
+        // Ids handed out before are not reused, so keys that still hold them cannot match.
+        states_.clear();
+        lru_.clear();
+        entries_.clear();
+        interned_ = 0;
+    }
+    states_[hash].emplace_back(next_id_, dom);
+    ++interned_;
+    return next_id_++;
+}
+
+StateMemo::StateId StateMemo::intern(const EbpfDomain& dom) {
+    const size_t hash = dom.hash();
+    const std::lock_guard lock{mutex_};
+    return intern_locked(dom, hash);
+}
+
+StateMemo::Key StateMemo::key_of(const Op op, const std::span<const EbpfDomain* const> doms) {
+    std::vector<size_t> hashes;
+    hashes.reserve(doms.size());
+    for (const EbpfDomain* dom : doms) {
+        hashes.push_back(dom->hash());
+    }
+    Key key{.op = op};
+    key.operands.reserve(doms.size());
+    const std::lock_guard lock{mutex_};
+    for (size_t i = 0; i < doms.size(); ++i) {
+        key.operands.push_back(intern_locked(*doms[i], hashes[i]));
+    }
+    return key;
+}
+
+std::optional<StateMemo::Result> StateMemo::find(const Key& key) {
+    const std::lock_guard lock{mutex_};
+    const auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    ++hits_;
+    return it->second->second;
+}
+
+void StateMemo::insert(Key&& key, Result result) {
+    const std::lock_guard lock{mutex_};
+    if (entries_.contains(key)) {
+        return;
+    }
+    lru_.emplace_front(std::move(key), std::move(result));
+    entries_.emplace(lru_.front().first, lru_.begin());
+    if (lru_.size() > capacity_) {
+        entries_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+}
+
+EbpfDomain StateMemo::join(const std::span<const EbpfDomain* const> doms) {
+    if (doms.size() == 1) {
+        return *doms.front();
+    }
+    Key key = key_of(Op::join, doms);
+    if (auto cached = find(key)) {
+        return std::get<EbpfDomain>(std::move(*cached));
+    }
+    EbpfDomain result = EbpfDomain::join(doms);
+    insert(std::move(key), result);
+    return result;
+}
+
+bool StateMemo::leq(const EbpfDomain& left, const EbpfDomain& right) {
+    const std::array doms{&left, &right};
+    Key key = key_of(Op::leq, doms);
+    if (key.operands[0] == key.operands[1]) {
+        const std::lock_guard lock{mutex_};
+        ++hits_;
+        return true;
+    }
+    if (const auto cached = find(key)) {
+        return std::get<bool>(*cached);
+    }
+    const bool result = left <= right;
+    insert(std::move(key), result);
+    return result;
+}
+
+EbpfDomain StateMemo::widen(const EbpfDomain& left, const EbpfDomain& right) {
+    const std::array doms{&left, &right};
+    Key key = key_of(Op::widen, doms);
+    if (auto cached = find(key)) {
+        return std::get<EbpfDomain>(std::move(*cached));
+    }
+    EbpfDomain result = left.widen(right);
+    insert(std::move(key), result);
+    return result;
+}
+
+uint64_t StateMemo::hits() const {
+    const std::lock_guard lock{mutex_};
+    return hits_;
+}
+
+} // namespace prevail
@@ -0,0 +1,80 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "crab/ebpf_domain.hpp"
+
+namespace prevail {
+
+/// Hash-consing of EbpfDomain states, with an LRU cache of the results of join, inclusion and
+/// widening on them (VerifierOptions::memoize_lattice_operations).
+///
+/// The same states recur during an analysis: the posts of a diamond that does not touch a
+/// register, the head of a loop on its last iterations, the inlined copies of a subprogram.
+/// Each state is interned by EbpfDomain::hash() under an id shared by all identical states
+/// (EbpfDomain::identical), and results are cached by operation and operand ids.
+///
+/// The interned states are kept, so their ids are never reused; once there are more than
+/// `capacity` of them, the table and the cache start over. Thread-safe.
+class StateMemo final {
+  public:
+    using StateId = uint64_t;
+
+    static constexpr size_t default_capacity = 4096;
+
+    explicit StateMemo(size_t capacity = default_capacity);
+
+    /// The id of the states identical to `dom`.
+    StateId intern(const EbpfDomain& dom);
+
+    /// EbpfDomain::join, operator<= and widen, through the cache.
+    EbpfDomain join(std::span<const EbpfDomain* const> doms);
+    bool leq(const EbpfDomain& left, const EbpfDomain& right);
+    EbpfDomain widen(const EbpfDomain& left, const EbpfDomain& right);
+
+    /// Number of operations answered from the cache.
+    [[nodiscard]]
+    uint64_t hits() const;
+
+  private:
+    enum class Op : uint8_t { join, leq, widen };
+
+    struct Key {
+        Op op{};
+        std::vector<StateId> operands;
+        bool operator==(const Key&) const = default;
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+    using Result = std::variant<bool, EbpfDomain>;
+    using Entry = std::pair<Key, Result>;
+
+    StateId intern_locked(const EbpfDomain& dom, size_t hash);
+    Key key_of(Op op, std::span<const EbpfDomain* const> doms);
+    std::optional<Result> find(const Key& key);
+    void insert(Key&& key, Result result);
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+
+    StateId next_id_{0};
+    std::unordered_map<size_t, std::vector<std::pair<StateId, EbpfDomain>>> states_; ///< By hash.
+    size_t interned_{0};
+
+    std::list<Entry> lru_; ///< Most recently used first.
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries_;
+    uint64_t hits_{0};
+};
+
+} // namespace prevail
@@ -3,13 +3,19 @@
 
 // This file is eBPF-specific, not derived from CRAB.
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <map>
 #include <optional>
 #include <set>
+#include <span>
 #include <sstream>
+#include <tuple>
+
+#include <boost/container_hash/hash.hpp>
 
 #include "arith/variable.hpp"
+#include "crab/cow.hpp"
 #include "crab/dsu.hpp"
 #include "crab/type_domain.hpp"
 #include "crab/type_encoding.hpp"
@@ -321,6 +327,9 @@ struct TypeDomain::State {
     bool same_type(Variable a, Variable b) const;
     [[nodiscard]]
     StringInvariant to_set() const;
+    // Each variable, in Variable order, with its TypeSet and the first variable of its class.
+    [[nodiscard]]
+    std::vector<std::tuple<Variable, TypeSet, Variable>> canonical() const;
 
     // Mutations returning false on empty TypeSet (caller sets bottom)
     bool restrict_var(Variable v, TypeSet mask);
@@ -334,7 +343,7 @@ struct TypeDomain::State {
 
     // Lattice
     [[nodiscard]]
-    static State join(const State& a, const State& b);
+    static State join(std::span<const State* const> states);
     [[nodiscard]]
     std::optional<State> meet(const State& other) const;
     [[nodiscard]]
@@ -352,21 +361,16 @@ TypeDomain::State::State() {
 
 // -- Special member functions ------------------------------------------------
 
-TypeDomain::TypeDomain() : state_(std::make_unique<State>()) {}
+TypeDomain::TypeDomain() : state_(std::make_shared<State>()) {}
 
 TypeDomain::~TypeDomain() = default;
 
-TypeDomain::TypeDomain(const TypeDomain& other)
-    : state_(other.state_ ? std::make_unique<State>(*other.state_) : nullptr) {}
+// Copies share the state until one of them modifies it (see mutable_state).
+TypeDomain::TypeDomain(const TypeDomain& other) = default;
 
 TypeDomain::TypeDomain(TypeDomain&& other) noexcept = default;
 
-TypeDomain& TypeDomain::operator=(const TypeDomain& other) {
-    if (this != &other) {
-        state_ = other.state_ ? std::make_unique<State>(*other.state_) : nullptr;
-    }
-    return *this;
-}
+TypeDomain& TypeDomain::operator=(const TypeDomain& other) = default;
 
 TypeDomain& TypeDomain::operator=(TypeDomain&& other) noexcept = default;
 
@@ -466,6 +470,18 @@ StringInvariant TypeDomain::State::to_set() const {
     return StringInvariant{std::move(result)};
 }
 
+std::vector<std::tuple<Variable, TypeSet, Variable>> TypeDomain::State::canonical() const {
+    std::map<size_t, Variable> first_of_class;
+    std::vector<std::tuple<Variable, TypeSet, Variable>> result;
+    result.reserve(var_ids.vars().size());
+    for (const auto& [v, id] : var_ids.vars()) {
+        const size_t rep = dsu.find_const(id);
+        const Variable first = first_of_class.try_emplace(rep, v).first->second;
+        result.emplace_back(v, class_types[rep], first);
+    }
+    return result;
+}
+
 // -- State: mutations (return false → bottom) --------------------------------
 
 bool TypeDomain::State::restrict_var(const Variable v, const TypeSet mask) {
@@ -552,51 +568,49 @@ void TypeDomain::State::assign_encoding(const Variable v, const TypeEncoding te)
 
 // -- State: lattice ----------------------------------------------------------
 
-TypeDomain::State TypeDomain::State::join(const State& a, const State& b) {
+TypeDomain::State TypeDomain::State::join(const std::span<const State* const> states) {
     // With the singleton-merging invariant, all variables with singleton {te}
     // share the same DSU rep (the sentinel) in each operand. So raw DSU reps
     // partition correctly without a special singleton key.
 
-    // Collect all variables from both operands.
+    // Collect all variables from all operands.
     std::set<Variable> all_vars_seen;
-    for (const auto& v : a.var_ids.vars() | std::views::keys) {
-        all_vars_seen.insert(v);
-    }
-    for (const auto& v : b.var_ids.vars() | std::views::keys) {
-        all_vars_seen.insert(v);
+    for (const State* state : states) {
+        for (const auto& v : state->var_ids.vars() | std::views::keys) {
+            all_vars_seen.insert(v);
+        }
     }
 
-    // Compute (rep_left, rep_right) for each variable, group by key pair.
-    // Variables absent from one side get unique keys (not nullopt) to avoid
-    // falsely unifying unrelated variables that happen to share a rep on the
-    // other side.
-    size_t next_unique_a = a.dsu.size();
-    size_t next_unique_b = b.dsu.size();
-    std::map<std::pair<size_t, size_t>, std::vector<Variable>> key_groups;
+    // Compute the rep of each variable in every operand, group by the tuple of reps.
+    // Variables absent from an operand get unique keys (not nullopt) to avoid
+    // falsely unifying unrelated variables that happen to share a rep there.
+    std::vector<size_t> next_unique;
+    for (const State* state : states) {
+        next_unique.push_back(state->dsu.size());
+    }
+    std::map<std::vector<size_t>, std::vector<Variable>> key_groups;
     for (const auto& v : all_vars_seen) {
-        size_t key_a;
-        if (const auto id = a.var_ids.find_id(v)) {
-            key_a = a.dsu.find_const(*id);
-        } else {
-            key_a = next_unique_a++;
-        }
-        size_t key_b;
-        if (const auto id = b.var_ids.find_id(v)) {
-            key_b = b.dsu.find_const(*id);
-        } else {
-            key_b = next_unique_b++;
+        std::vector<size_t> key;
+        key.reserve(states.size());
+        for (size_t i = 0; i < states.size(); ++i) {
+            if (const auto id = states[i]->var_ids.find_id(v)) {
+                key.push_back(states[i]->dsu.find_const(*id));
+            } else {
+                key.push_back(next_unique[i]++);
+            }
         }
-        key_groups[{key_a, key_b}].push_back(v);
+        key_groups[std::move(key)].push_back(v);
     }
 
     // Build result
     State result;
     for (const auto& members : key_groups | std::views::values) {
-        // TypeSet = union of per-variable TypeSets from both operands
+        // TypeSet = union of per-variable TypeSets from all operands
         TypeSet ts{};
         for (const Variable& v : members) {
-            ts |= a.get_typeset(v);
-            ts |= b.get_typeset(v);
+            for (const State* state : states) {
+                ts |= state->get_typeset(v);
+            }
         }
 
         // Register all members in the result, unified
@@ -706,9 +720,11 @@ bool TypeDomain::State::is_subsumed_by(const State& other) const {
 // TypeDomain — thin WithBottom wrappers
 // ============================================================================
 
-void TypeDomain::set_to_top() { state_ = std::make_unique<State>(); }
+void TypeDomain::set_to_top() { state_ = std::make_shared<State>(); }
 void TypeDomain::set_to_bottom() { state_.reset(); }
 
+TypeDomain::State* TypeDomain::mutable_state() { return state_ ? &detach_shared(state_) : nullptr; }
+
 // -- Lattice -----------------------------------------------------------------
 
 TypeDomain TypeDomain::join(const TypeDomain& other) const {
@@ -718,8 +734,32 @@ TypeDomain TypeDomain::join(const TypeDomain& other) const {
     if (!other.state_) {
         return *this;
     }
+    const std::array states{state_.get(), other.state_.get()};
+    TypeDomain result;
+    result.state_ = std::make_shared<State>(State::join(states));
+    return result;
+}
+
+TypeDomain TypeDomain::join(const std::span<const TypeDomain* const> doms) {
+    std::vector<const State*> states;
+    states.reserve(doms.size());
+    for (const TypeDomain* dom : doms) {
+        if (dom->state_) {
+            states.push_back(dom->state_.get());
+        }
+    }
+    if (states.empty()) {
+        TypeDomain result;
+        result.set_to_bottom();
+        return result;
+    }
+    if (states.size() == 1) {
+        TypeDomain result;
+        result.state_ = std::make_shared<State>(*states.front());
+        return result;
+    }
     TypeDomain result;
-    result.state_ = std::make_unique<State>(State::join(*state_, *other.state_));
+    result.state_ = std::make_shared<State>(State::join(states));
     return result;
 }
 
@@ -742,7 +782,7 @@ std::optional<TypeDomain> TypeDomain::meet(const TypeDomain& other) const {
     }
     if (auto result = state_->meet(*other.state_)) {
         TypeDomain td;
-        td.state_ = std::make_unique<State>(std::move(*result));
+        td.state_ = std::make_shared<State>(std::move(*result));
         return td;
     }
     return std::nullopt;
@@ -755,9 +795,35 @@ bool TypeDomain::operator<=(const TypeDomain& other) const {
     if (!other.state_) {
         return false;
     }
+    if (state_ == other.state_) {
+        return true;
+    }
     return state_->is_subsumed_by(*other.state_);
 }
 
+bool TypeDomain::identical(const TypeDomain& other) const {
+    if (state_ == other.state_) {
+        return true;
+    }
+    if (!state_ || !other.state_) {
+        return false;
+    }
+    return state_->canonical() == other.state_->canonical();
+}
+
+std::size_t TypeDomain::hash() const {
+    if (!state_) {
+        return 0;
+    }
+    std::size_t seed = 1;
+    for (const auto& [v, ts, first] : state_->canonical()) {
+        boost::hash_combine(seed, v.hash());
+        boost::hash_combine(seed, ts.hash());
+        boost::hash_combine(seed, first.hash());
+    }
+    return seed;
+}
+
 TypeDomain TypeDomain::narrow(const TypeDomain& other) const {
     if (auto res = meet(other)) {
         return std::move(*res);
@@ -770,7 +836,7 @@ TypeDomain TypeDomain::narrow(const TypeDomain& other) const {
 // -- Assignment --------------------------------------------------------------
 
 void TypeDomain::assign_type(const Reg& lhs, const Reg& rhs) {
-    if (auto* s = state_.get()) {
+    if (auto* s = mutable_state()) {
         s->assign_copy(reg_type(lhs), reg_type(rhs));
     }
 }
@@ -783,7 +849,7 @@ void TypeDomain::assign_type(const Reg& lhs, const std::optional<LinearExpressio
         havoc_type(reg_type(lhs));
         return;
     }
-    if (!state_->assign_from_expr(reg_type(lhs), *rhs)) {
+    if (!mutable_state()->assign_from_expr(reg_type(lhs), *rhs)) {
         set_to_bottom();
     }
 }
@@ -792,13 +858,13 @@ void TypeDomain::assign_type(const std::optional<Variable> lhs, const LinearExpr
     if (!state_ || !lhs) {
         return;
     }
-    if (!state_->assign_from_expr(*lhs, t)) {
+    if (!mutable_state()->assign_from_expr(*lhs, t)) {
         set_to_bottom();
     }
 }
 
 void TypeDomain::assign_type(const Reg& lhs, const TypeEncoding type) {
-    if (auto* s = state_.get()) {
+    if (auto* s = mutable_state()) {
         s->assign_encoding(reg_type(lhs), type);
     }
 }
@@ -806,7 +872,7 @@ void TypeDomain::assign_type(const Reg& lhs, const TypeEncoding type) {
 // -- Constraint handling -----------------------------------------------------
 
 void TypeDomain::restrict_to(const Variable v, const TypeSet mask) {
-    if (auto* s = state_.get()) {
+    if (auto* s = mutable_state()) {
         if (!s->restrict_var(v, mask)) {
             set_to_bottom();
         }
@@ -814,7 +880,7 @@ void TypeDomain::restrict_to(const Variable v, const TypeSet mask) {
 }
 
 void TypeDomain::assume_eq(const Variable v1, const Variable v2) {
-    if (auto* s = state_.get()) {
+    if (auto* s = mutable_state()) {
         if (!s->assume_eq(v1, v2)) {
             set_to_bottom();
         }
@@ -822,7 +888,7 @@ void TypeDomain::assume_eq(const Variable v1, const Variable v2) {
 }
 
 void TypeDomain::remove_type(const Variable v, const TypeEncoding te) {
-    if (auto* s = state_.get()) {
+    if (auto* s = mutable_state()) {
         if (!s->remove_type(v, te)) {
             set_to_bottom();
         }
@@ -832,19 +898,19 @@ void TypeDomain::remove_type(const Variable v, const TypeEncoding te) {
 // -- Havoc -------------------------------------------------------------------
 
 void TypeDomain::havoc_type(const Reg& r) {
-    if (auto* s = state_.get()) {
+    if (auto* s = mutable_state()) {
         s->detach(reg_type(r));
     }
 }
 
 void TypeDomain::havoc_type(const Variable& v) {
-    if (auto* s = state_.get()) {
+    if (auto* s = mutable_state()) {
         s->detach(v);
     }
 }
 
 void TypeDomain::rename(const std::vector<std::pair<Variable, Variable>>& renaming) {
-    if (auto* s = state_.get()) {
+    if (auto* s = mutable_state()) {
         s->var_ids.rename(renaming);
     }
 }
@@ -952,6 +1018,24 @@ bool TypeDomain::is_in_group(const Reg& r, const TypeSet types) const {
 
 // -- Serialization -----------------------------------------------------------
 
+std::vector<std::pair<std::vector<Variable>, TypeSet>> TypeDomain::classes() const {
+    if (!state_) {
+        return {};
+    }
+    std::map<size_t, std::vector<Variable>> members_of;
+    for (const auto& [v, id] : state_->var_ids.vars()) {
+        members_of[state_->dsu.find_const(id)].push_back(v);
+    }
+    std::vector<std::pair<std::vector<Variable>, TypeSet>> res;
+    for (auto& members : members_of | std::views::values) {
+        const TypeSet ts = get_typeset(members[0]);
+        if (members.size() > 1 || ts != TypeSet::all()) {
+            res.emplace_back(std::move(members), ts);
+        }
+    }
+    return res;
+}
+
 StringInvariant TypeDomain::to_set() const {
     if (!state_) {
         return StringInvariant::bottom();
@@ -4,6 +4,8 @@
 
 #include <memory>
 #include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 #include "arith/linear_constraint.hpp"
@@ -66,9 +68,21 @@ class TypeDomain {
 
     TypeDomain operator|(const TypeDomain& other) const;
 
+    /// Join of any number of domains; bottom operands are skipped.
+    static TypeDomain join(std::span<const TypeDomain* const> doms);
+
     [[nodiscard]]
     std::optional<TypeDomain> meet(const TypeDomain& other) const;
     bool operator<=(const TypeDomain& other) const;
+
+    /// Whether both domains have the same classes and TypeSets, whatever the DSU ids. Implies
+    /// equality; equal domains may still differ, e.g. by variables whose TypeSet is top.
+    [[nodiscard]]
+    bool identical(const TypeDomain& other) const;
+    /// A hash that agrees with identical().
+    [[nodiscard]]
+    std::size_t hash() const;
+
     void set_to_top();
     static TypeDomain top() { return TypeDomain{}; }
     [[nodiscard]]
@@ -152,15 +166,23 @@ class TypeDomain {
     [[nodiscard]]
     std::vector<Variable> variables_with_type(TypeEncoding type) const;
 
+    /// The classes of variables known to have the same type, each with its TypeSet. A variable
+    /// alone in its class is listed only if its TypeSet is not top. Empty if bottom.
+    [[nodiscard]]
+    std::vector<std::pair<std::vector<Variable>, TypeSet>> classes() const;
+
     [[nodiscard]]
     StringInvariant to_set() const;
     friend std::ostream& operator<<(std::ostream& o, const TypeDomain& dom);
 
   private:
     struct State;
-    std::unique_ptr<State> state_;
+    // Shared between copies; mutators detach it first.
+    std::shared_ptr<State> state_;
 
     void set_to_bottom();
+    // The state, detached from other copies, or nullptr if bottom.
+    State* mutable_state();
 
     [[nodiscard]]
     TypeSet get_typeset(Variable v) const;
@@ -105,6 +105,11 @@ class TypeSet {
     bool operator==(const TypeSet o) const { return bits_ == o.bits_; }
     bool operator!=(const TypeSet o) const { return bits_ != o.bits_; }
 
+    [[nodiscard]]
+    std::size_t hash() const {
+        return std::hash<std::bitset<NUM_TYPE_ENCODINGS>>{}(bits_);
+    }
+
     /// Whether this set is empty.
     [[nodiscard]]
     bool is_empty() const {
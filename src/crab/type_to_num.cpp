@@ -1,7 +1,12 @@
 // Copyright (c) Prevail Verifier contributors.
 // SPDX-License-Identifier: MIT
+#include <array>
 #include <cassert>
 #include <ranges>
+#include <set>
+#include <span>
+
+#include <boost/container_hash/hash.hpp>
 
 #include "arith/variable.hpp"
 #include "crab/interval.hpp"
@@ -41,6 +46,22 @@ bool TypeToNumDomain::operator<=(const TypeToNumDomain& other) const {
     return values <= tmp.values;
 }
 
+bool TypeToNumDomain::identical(const TypeToNumDomain& other) const {
+    if (is_bottom() || other.is_bottom()) {
+        return is_bottom() && other.is_bottom();
+    }
+    return types.identical(other.types) && values.identical(other.values);
+}
+
+std::size_t TypeToNumDomain::hash() const {
+    if (is_bottom()) {
+        return 0;
+    }
+    std::size_t seed = types.hash();
+    boost::hash_combine(seed, values.hash());
+    return seed;
+}
+
 void TypeToNumDomain::join_selective(const TypeToNumDomain& right) {
     if (is_bottom()) {
         *this = right;
@@ -49,7 +70,8 @@ void TypeToNumDomain::join_selective(const TypeToNumDomain& right) {
     if (right.is_bottom()) {
         return;
     }
-    auto extra_invariants = collect_type_dependent_constraints(right);
+    const std::array doms{static_cast<const TypeToNumDomain*>(this), &right};
+    auto extra_invariants = collect_type_dependent_constraints(doms);
     this->values |= right.values;
     for (const auto& [variable, interval] : extra_invariants) {
         values.set(variable, interval);
@@ -81,6 +103,33 @@ void TypeToNumDomain::operator|=(TypeToNumDomain&& other) {
     this->types |= std::move(other.types);
 }
 
+TypeToNumDomain TypeToNumDomain::join(const std::span<const TypeToNumDomain* const> doms) {
+    std::vector<const TypeToNumDomain*> present;
+    for (const TypeToNumDomain* dom : doms) {
+        if (!dom->is_bottom()) {
+            present.push_back(dom);
+        }
+    }
+    if (present.empty()) {
+        return bottom();
+    }
+    if (present.size() == 1) {
+        return *present.front();
+    }
+
+    std::vector<const NumAbsDomain*> values;
+    std::vector<const TypeDomain*> types;
+    for (const TypeToNumDomain* dom : present) {
+        values.push_back(&dom->values);
+        types.push_back(&dom->types);
+    }
+    TypeToNumDomain result{TypeDomain::join(types), NumAbsDomain::join(values)};
+    for (const auto& [variable, interval] : collect_type_dependent_constraints(present)) {
+        result.values.set(variable, interval);
+    }
+    return result;
+}
+
 TypeToNumDomain TypeToNumDomain::operator&(const TypeToNumDomain& other) const {
     if (auto type_inv = types.meet(other.types)) {
         // TODO: remove unuseful variables from the numeric domain
@@ -114,34 +163,40 @@ std::vector<Variable> TypeToNumDomain::get_nonexistent_kind_variables() const {
 }
 
 std::vector<std::tuple<Variable, Interval>>
-TypeToNumDomain::collect_type_dependent_constraints(const TypeToNumDomain& right) const {
+TypeToNumDomain::collect_type_dependent_constraints(const std::span<const TypeToNumDomain* const> doms) {
     std::vector<std::tuple<Variable, Interval>> result;
 
-    // A variable tracked in only one side can still have differing type info
-    // (the other side treats it as top), so we iterate the union.
+    // A variable tracked in only some operands can still have differing type info
+    // (the others treat it as top), so we iterate the union.
     std::set<Variable> type_vars;
-    for (const Variable v : types.variables()) {
-        type_vars.insert(v);
-    }
-    for (const Variable v : right.types.variables()) {
-        type_vars.insert(v);
+    for (const TypeToNumDomain* dom : doms) {
+        for (const Variable v : dom->types.variables()) {
+            type_vars.insert(v);
+        }
     }
+    std::vector<const TypeToNumDomain*> sources;
     for (const Variable& type_var : type_vars) {
         for (const auto& [type, kinds] : type_to_kinds) {
             if (kinds.empty()) {
                 continue;
             }
-            const bool in_left = types.may_have_type(type_var, type);
-            const bool in_right = right.types.may_have_type(type_var, type);
+            sources.clear();
+            for (const TypeToNumDomain* dom : doms) {
+                if (dom->types.may_have_type(type_var, type)) {
+                    sources.push_back(dom);
+                }
+            }
 
-            // If a type may be present in one domain but not the other, its
+            // If a type may be present in some domains but not the others, its
             // dependent constraints must be explicitly preserved.
-            if (in_left != in_right) {
-                // Identify which domain contains the constraints.
-                const NumAbsDomain& source = in_left ? values : right.values;
+            if (!sources.empty() && sources.size() < doms.size()) {
+                // The constraints come from the domains that may have the type.
                 for (const DataKind kind : kinds) {
                     Variable var = variable_registry.kind_var(kind, type_var);
-                    Interval value = source.eval_interval(var);
+                    Interval value = Interval::bottom();
+                    for (const TypeToNumDomain* source : sources) {
+                        value = value | source->values.eval_interval(var);
+                    }
                     if (!value.is_top()) {
                         result.emplace_back(var, value);
                     }
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <span>
+
 #include "arith/variable.hpp"
 #include "crab/add_bottom.hpp"
 #include "crab/interval.hpp"
@@ -107,11 +109,22 @@ struct TypeToNumDomain {
      */
     bool operator<=(const TypeToNumDomain& other) const;
 
+    /// Whether both domains are bottom, or have identical types and values (see ZoneDomain::identical).
+    [[nodiscard]]
+    bool identical(const TypeToNumDomain& other) const;
+    /// A hash that agrees with identical().
+    [[nodiscard]]
+    std::size_t hash() const;
+
     void join_selective(const TypeToNumDomain& right);
 
     void operator|=(const TypeToNumDomain& other);
     void operator|=(TypeToNumDomain&& other);
 
+    /// Join of any number of domains; bottom operands are skipped. With two or more operands, the
+    /// numeric domains are joined at once and the type-dependent constraints are collected once.
+    static TypeToNumDomain join(std::span<const TypeToNumDomain* const> doms);
+
     TypeToNumDomain operator&(const TypeToNumDomain& other) const;
     TypeToNumDomain operator&(TypeToNumDomain&& other) const;
 
@@ -143,7 +156,7 @@ struct TypeToNumDomain {
     std::vector<Variable> get_nonexistent_kind_variables() const;
 
     /**
-     * @brief Collects type-specific constraints that are present in only one of two domains.
+     * @brief Collects type-specific constraints that are present in only some of the joined domains.
      *
      * @details This function is a helper for the type-aware join operation (`operator|`).
      *
@@ -152,16 +165,18 @@ struct TypeToNumDomain {
      * type is absent, the kind variable is conceptually Bottom.
      *
      * Role in Join: During a join, if one branch has constraints on `packet_offset`
-     * (because the type is `T_PACKET`) and the other doesn't, a naive join would lose
+     * (because the type is `T_PACKET`) and another doesn't, a naive join would lose
      * those constraints. This function identifies such constraints so that the `operator|`
-     * can preserve them, creating a more precise union of the two states.
+     * can preserve them, creating a more precise union of the states. When several branches
+     * may have the type, their intervals are joined.
      *
-     * @param[in] right The other domain of the join.
-     * @return A vector containing the variable, which domain it came from (`true` if left),
-     * and its interval value, for each type-specific constraint to be preserved.
+     * @param[in] doms The domains of the join.
+     * @return A vector containing the variable and its interval value, for each
+     * type-specific constraint to be preserved.
      */
     [[nodiscard]]
-    std::vector<std::tuple<Variable, Interval>> collect_type_dependent_constraints(const TypeToNumDomain& right) const;
+    static std::vector<std::tuple<Variable, Interval>>
+    collect_type_dependent_constraints(std::span<const TypeToNumDomain* const> doms);
 
     /**
      * @brief Applies a transition function for each possible type of a given register.
@@ -4,6 +4,8 @@
  * Factories for variable names.
  */
 
+#include <mutex>
+
 #include "crab/var_registry.hpp"
 #include "arith/variable.hpp"
 #include "cfg/label.hpp"
@@ -11,6 +13,22 @@
 namespace prevail {
 
 Variable VariableRegistry::intern(const std::string& name) const {
+    const bool shared = is_shared();
+    {
+        std::shared_lock lock{names_mutex, std::defer_lock};
+        if (shared) {
+            lock.lock();
+        }
+        if (const auto it = std::ranges::find(names, name); it != names.end()) {
+            return Variable(std::distance(names.begin(), it));
+        }
+    }
+    if (!shared) {
+        names.emplace_back(name);
+        return Variable(names.size() - 1);
+    }
+    std::unique_lock lock{names_mutex};
+    // Look again: a thread sharing this registry may have interned the name in the meantime.
     const auto it = std::ranges::find(names, name);
     if (it == names.end()) {
         names.emplace_back(name);
@@ -140,7 +158,13 @@ static std::vector<std::string> default_variable_names() {
 
 VariableRegistry::VariableRegistry() : names(default_variable_names()) {}
 
+// Set by VariableRegistryBinding. A plain pointer, so it needs no dynamic initialization.
+static thread_local VariableRegistry* bound_registry = nullptr;
+
 VariableRegistry& get_variable_registry() {
+    if (bound_registry != nullptr) {
+        return *bound_registry;
+    }
     // Use function-local thread_local to defer construction until first use,
     // avoiding TLS dynamic-init callbacks that can race with CRT startup
     // (e.g. ASan threads created before CRT debug locks are initialized).
@@ -148,6 +172,18 @@ VariableRegistry& get_variable_registry() {
     return instance;
 }
 
+VariableRegistryBinding::VariableRegistryBinding(VariableRegistry& registry) : previous(bound_registry) {
+    bound_registry = &registry;
+}
+
+VariableRegistryBinding::~VariableRegistryBinding() { bound_registry = previous; }
+
+VariableRegistrySharing::VariableRegistrySharing(VariableRegistry& registry) : registry(registry) {
+    registry.sharings.fetch_add(1, std::memory_order_relaxed);
+}
+
+VariableRegistrySharing::~VariableRegistrySharing() { registry.sharings.fetch_sub(1, std::memory_order_relaxed); }
+
 std::ostream& operator<<(std::ostream& o, const Variable& v) { return o << get_variable_registry().name(v); }
 
 std::ostream& operator<<(std::ostream& o, const DataKind& s) { return o << name_of(s); }
@@ -198,7 +234,15 @@ bool VariableRegistry::is_min_only(const Variable& v) const {
 
 Variable VariableRegistry::loop_counter(const std::string& label) const { return intern("pc[" + label + "]"); }
 
-std::string VariableRegistry::name(const Variable& v) const { return names.at(v._id); }
+Variable VariableRegistry::from_name(const std::string& name) const { return intern(name); }
+
+std::string VariableRegistry::name(const Variable& v) const {
+    std::shared_lock lock{names_mutex, std::defer_lock};
+    if (is_shared()) {
+        lock.lock();
+    }
+    return names.at(v._id);
+}
 
 [[nodiscard]]
 bool VariableRegistry::is_type(const Variable& v) const {
@@ -237,9 +281,13 @@ RegPack VariableRegistry::reg_pack(const int i) const {
 
 std::vector<Variable> VariableRegistry::get_loop_counters() const {
     std::vector<Variable> res;
-    for (const std::string& name : names) {
-        if (name.starts_with("pc")) {
-            res.push_back(intern(name));
+    std::shared_lock lock{names_mutex, std::defer_lock};
+    if (is_shared()) {
+        lock.lock();
+    }
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i].starts_with("pc")) {
+            res.push_back(Variable(i));
         }
     }
     return res;
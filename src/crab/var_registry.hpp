@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <atomic>
+#include <shared_mutex>
 #include <vector>
 
 #include "arith/num_big.hpp"
@@ -35,12 +37,21 @@ struct RegPack {
 // between canonical variable descriptions and ids, and provides the eBPF-specific
 // constructors/classifiers for those descriptions.
 //
-// The registry is stored thread-locally, so `intern`'s append path has no
-// concurrency concerns on the current design. Sharing a registry across
-// threads would require synchronization on `names`.
+// The registry is stored thread-locally. A thread that analyzes part of a
+// program on behalf of another one shares that thread's registry through a
+// VariableRegistryBinding. While a VariableRegistrySharing is alive, `names`
+// is guarded by a reader/writer lock; otherwise only its own thread uses it.
 class VariableRegistry final {
+    friend class VariableRegistrySharing;
+
     Variable intern(const std::string& name) const;
+    [[nodiscard]]
+    bool is_shared() const {
+        return sharings.load(std::memory_order_relaxed) != 0;
+    }
     mutable std::vector<std::string> names;
+    mutable std::shared_mutex names_mutex;
+    std::atomic<int> sharings{0};
 
   public:
     VariableRegistry();
@@ -52,12 +63,21 @@ class VariableRegistry final {
     // Move is fine — it transfers identity rather than duplicating it.
     VariableRegistry(const VariableRegistry&) = delete;
     VariableRegistry& operator=(const VariableRegistry&) = delete;
-    VariableRegistry(VariableRegistry&&) = default;
-    VariableRegistry& operator=(VariableRegistry&&) = default;
+    // The lock is not part of the identity; each registry keeps its own. A
+    // shared registry is not moved.
+    VariableRegistry(VariableRegistry&& other) noexcept : names(std::move(other.names)) {}
+    VariableRegistry& operator=(VariableRegistry&& other) noexcept {
+        names = std::move(other.names);
+        return *this;
+    }
 
     [[nodiscard]]
     std::string name(const Variable& v) const;
 
+    /// The variable that name() calls `name`, e.g. to read back a state written by variable names.
+    [[nodiscard]]
+    Variable from_name(const std::string& name) const;
+
     [[nodiscard]]
     bool is_type(const Variable& v) const;
 
@@ -94,6 +114,40 @@ class VariableRegistry final {
 /// with CRT startup when extra threads are created early, e.g. by ASan).
 VariableRegistry& get_variable_registry();
 
+/// For its lifetime, lets other threads use `registry` through a VariableRegistryBinding: its
+/// names are then read and written under its lock. Constructed by the thread that owns the
+/// registry before it hands the registry to other threads, and destroyed once they are done.
+class VariableRegistrySharing final {
+    VariableRegistry& registry;
+
+  public:
+    explicit VariableRegistrySharing(VariableRegistry& registry);
+    ~VariableRegistrySharing();
+
+    VariableRegistrySharing(const VariableRegistrySharing&) = delete;
+    VariableRegistrySharing& operator=(const VariableRegistrySharing&) = delete;
+    VariableRegistrySharing(VariableRegistrySharing&&) = delete;
+    VariableRegistrySharing& operator=(VariableRegistrySharing&&) = delete;
+};
+
+/// For its lifetime, makes get_variable_registry() on the current thread return
+/// `registry` instead of the thread's own. The registry must be shared (see
+/// VariableRegistrySharing) when the binding is on another thread than its owner. Worker threads analyzing part of a
+/// program bind to the registry of the thread that owns the analysis, since a
+/// `Variable` is only meaningful against the registry that interned it.
+class VariableRegistryBinding final {
+    VariableRegistry* previous;
+
+  public:
+    explicit VariableRegistryBinding(VariableRegistry& registry);
+    ~VariableRegistryBinding();
+
+    VariableRegistryBinding(const VariableRegistryBinding&) = delete;
+    VariableRegistryBinding& operator=(const VariableRegistryBinding&) = delete;
+    VariableRegistryBinding(VariableRegistryBinding&&) = delete;
+    VariableRegistryBinding& operator=(VariableRegistryBinding&&) = delete;
+};
+
 } // namespace prevail
 
 // Backward-compatible alias: all existing code uses `variable_registry.method()`.
@@ -1,8 +1,14 @@
 // Copyright (c) Prevail Verifier contributors.
 // SPDX-License-Identifier: Apache-2.0
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <numeric>
 #include <utility>
 
+#include <boost/container_hash/hash.hpp>
+
+#include "crab/dsu.hpp"
 #include "crab/var_registry.hpp"
 #include "crab/zone_domain.hpp"
 #include "string_constraints.hpp"
@@ -11,65 +17,93 @@ using namespace splitdbm;
 
 namespace prevail {
 
-ZoneDomain::ZoneDomain() : core_(std::make_unique<SplitDBM>()) { rev_map_.emplace_back(std::nullopt); }
+struct ZoneDomain::PackView {
+    const Pack* pack{}; // The only pack, if there is one
+    std::optional<SplitDBM> merged;
+    VertMap merged_map;
+
+    [[nodiscard]]
+    const SplitDBM& core() const {
+        return pack ? pack->core : *merged;
+    }
+
+    [[nodiscard]]
+    const VertMap& vert_map() const {
+        return pack ? pack->vert_map : merged_map;
+    }
+};
+
+struct ZoneDomain::Block {
+    std::vector<Variable> vars;
+    std::vector<std::vector<size_t>> packs; // The packs of each operand
+};
+
+namespace {
+// Set on the threads of an interval pre-pass (ZoneDomain::IntervalsOnly).
+thread_local bool intervals_only = false;
+} // namespace
+
+ZoneDomain::IntervalsOnly::IntervalsOnly(const bool enable) : previous_(intervals_only) { intervals_only = enable; }
+
+ZoneDomain::IntervalsOnly::~IntervalsOnly() { intervals_only = previous_; }
+
+const Cow<ZoneDomain::Partition>& ZoneDomain::empty_partition() {
+    static const Cow<Partition> empty = Cow<Partition>::make();
+    return empty;
+}
+
+ZoneDomain::ZoneDomain() = default;
 
 ZoneDomain::~ZoneDomain() = default;
 
-ZoneDomain::ZoneDomain(const ZoneDomain& o)
-    : core_(std::make_unique<SplitDBM>(*o.core_)), vert_map_(o.vert_map_), rev_map_(o.rev_map_) {}
+ZoneDomain::ZoneDomain(const ZoneDomain& o) = default;
 
 ZoneDomain::ZoneDomain(ZoneDomain&& o) noexcept = default;
 
-ZoneDomain& ZoneDomain::operator=(const ZoneDomain& o) {
-    if (this != &o) {
-        core_ = std::make_unique<SplitDBM>(*o.core_);
-        vert_map_ = o.vert_map_;
-        rev_map_ = o.rev_map_;
-    }
-    return *this;
-}
+ZoneDomain& ZoneDomain::operator=(const ZoneDomain& o) = default;
 
 ZoneDomain& ZoneDomain::operator=(ZoneDomain&& o) noexcept = default;
 
-ZoneDomain::ZoneDomain(VertMap&& vert_map, RevMap&& rev_map, std::unique_ptr<SplitDBM> core)
-    : core_(std::move(core)), vert_map_(std::move(vert_map)), rev_map_(std::move(rev_map)) {
-    normalize();
-}
+void ZoneDomain::set_to_top() { partition_ = empty_partition(); }
 
-void ZoneDomain::set_to_top() {
-    core_ = std::make_unique<SplitDBM>();
-    vert_map_.clear();
-    rev_map_.clear();
-    rev_map_.emplace_back(std::nullopt);
+bool ZoneDomain::is_top() const {
+    return std::ranges::all_of(partition_->packs, [](const Cow<Pack>& pack) { return pack->core.is_top(); });
 }
 
-bool ZoneDomain::is_top() const { return core_->is_top(); }
-
-std::pair<std::size_t, std::size_t> ZoneDomain::size() const { return {core_->graph_size(), core_->num_edges()}; }
-
-std::optional<VertId> ZoneDomain::get_vertid(const Variable x) const {
-    const auto it = vert_map_.find(x);
-    if (it == vert_map_.end()) {
-        return {};
+std::pair<std::size_t, std::size_t> ZoneDomain::size() const {
+    std::size_t vertices = 1;
+    std::size_t edges = 0;
+    for (const Cow<Pack>& pack : partition_->packs) {
+        vertices += pack->core.graph_size() - 1;
+        edges += pack->core.num_edges();
     }
-    return it->second;
+    return {vertices, edges};
 }
 
-Bound ZoneDomain::get_lb(const std::optional<VertId>& v) const {
-    return v ? core_->get_bound(*v, Side::LEFT) : MINUS_INFINITY;
+bool ZoneDomain::is_closed() const {
+    return std::ranges::all_of(partition_->packs, [](const Cow<Pack>& pack) { return pack->core.is_closed(); });
 }
 
-Bound ZoneDomain::get_ub(const std::optional<VertId>& v) const {
-    return v ? core_->get_bound(*v, Side::RIGHT) : PLUS_INFINITY;
+std::optional<std::pair<const ZoneDomain::Pack*, VertId>> ZoneDomain::locate(const Variable v) const {
+    const auto it = partition_->pack_of.find(v);
+    if (it == partition_->pack_of.end()) {
+        return std::nullopt;
+    }
+    const Pack& pack = *partition_->packs[it->second];
+    return std::pair{&pack, pack.vert_map.at(v)};
 }
 
-Bound ZoneDomain::get_lb(const Variable x) const { return get_lb(get_vertid(x)); }
+Bound ZoneDomain::get_lb(const Variable x) const {
+    const auto located = locate(x);
+    return located ? located->first->core.get_bound(located->second, Side::LEFT) : MINUS_INFINITY;
+}
 
 Bound ZoneDomain::get_ub(const Variable x) const {
     if (variable_registry.is_min_only(x)) {
         return PLUS_INFINITY;
     }
-    return get_ub(get_vertid(x));
+    const auto located = locate(x);
+    return located ? located->first->core.get_bound(located->second, Side::RIGHT) : PLUS_INFINITY;
 }
 
 Interval ZoneDomain::get_interval(const Variable x) const { return {get_lb(x), get_ub(x)}; }
@@ -82,26 +116,269 @@ static std::optional<VertId> try_at(const ZoneDomain::VertMap& map, const Variab
     return it->second;
 }
 
-VertId ZoneDomain::get_vert(Variable v) {
-    if (const auto y = try_at(vert_map_, v)) {
+size_t ZoneDomain::pack_for(const std::span<const Variable> vars) {
+    std::vector<size_t> indices;
+    for (const Variable v : vars) {
+        if (const auto it = partition_->pack_of.find(v); it != partition_->pack_of.end()) {
+            indices.push_back(it->second);
+        }
+    }
+    std::ranges::sort(indices);
+    const auto [first, last] = std::ranges::unique(indices);
+    indices.erase(first, last);
+
+    size_t target;
+    if (indices.empty()) {
+        target = partition_->packs.size();
+        mutable_partition().packs.push_back(Cow<Pack>::make());
+    } else if (indices.size() == 1) {
+        target = indices.front();
+    } else {
+        // Renumber the vertices of all packs into one graph, then drop the merged packs from the back
+        // so that removing one does not move another.
+        std::vector<std::vector<VertId>> verts(indices.size());
+        std::vector<DbmPart> parts;
+        Pack merged{.core = SplitDBM{}};
+        for (size_t i = 0; i < indices.size(); ++i) {
+            const Pack& pack = *partition_->packs[indices[i]];
+            for (const auto& [var, vert] : pack.vert_map) {
+                verts[i].push_back(vert);
+                merged.vert_map.emplace(var, gsl::narrow<VertId>(merged.rev_map.size()));
+                merged.rev_map.emplace_back(var);
+            }
+            parts.push_back(DbmPart{pack.core, verts[i]});
+        }
+        merged.core = SplitDBM::product(parts);
+        target = indices.front();
+        Partition& partition = mutable_partition();
+        for (const auto& [var, vert] : merged.vert_map) {
+            partition.pack_of[var] = target;
+        }
+        partition.packs[target] = Cow<Pack>::make(std::move(merged));
+        for (size_t i = indices.size() - 1; i > 0; --i) {
+            remove_pack(indices[i]);
+        }
+    }
+    for (const Variable v : vars) {
+        get_vert(target, v);
+    }
+    return target;
+}
+
+VertId ZoneDomain::get_vert(const size_t pack, const Variable v) {
+    if (const auto y = try_at(partition_->packs[pack]->vert_map, v)) {
         return *y;
     }
+    assert(!partition_->pack_of.contains(v));
 
-    VertId vert = core_->new_vertex();
-    vert_map_.emplace(v, vert);
+    Pack& p = mutable_pack(pack);
+    const VertId vert = p.core.new_vertex();
+    p.vert_map.emplace(v, vert);
     // Initialize rev_map
-    assert(vert <= rev_map_.size());
-    if (vert < rev_map_.size()) {
-        rev_map_[vert] = v;
+    assert(vert <= p.rev_map.size());
+    if (vert < p.rev_map.size()) {
+        p.rev_map[vert] = v;
     } else {
-        rev_map_.emplace_back(v);
+        p.rev_map.emplace_back(v);
     }
+    mutable_partition().pack_of.emplace(v, pack);
 
     assert(vert != 0);
 
     return vert;
 }
 
+void ZoneDomain::forget_vertex(const size_t pack, const Variable v) {
+    Pack& p = mutable_pack(pack);
+    const VertId vert = p.vert_map.at(v);
+    p.core.forget(vert);
+    p.rev_map[vert] = std::nullopt;
+    p.vert_map.erase(v);
+    mutable_partition().pack_of.erase(v);
+}
+
+void ZoneDomain::drop_if_empty(const size_t pack) {
+    if (partition_->packs[pack]->vert_map.empty()) {
+        remove_pack(pack);
+    }
+}
+
+void ZoneDomain::remove_pack(const size_t pack) {
+    Partition& partition = mutable_partition();
+    if (pack + 1 != partition.packs.size()) {
+        partition.packs[pack] = std::move(partition.packs.back());
+        for (const auto& [var, vert] : partition.packs[pack]->vert_map) {
+            partition.pack_of[var] = pack;
+        }
+    }
+    partition.packs.pop_back();
+}
+
+void ZoneDomain::add_components(SplitDBM&& core, const RevMap& rev_map) {
+    const Graph& g = core.graph();
+    DisjointSetUnion components{g.size()};
+    for (const VertId v : g.verts()) {
+        for (const VertId d : g.succs(v)) {
+            if (v != 0 && d != 0) {
+                components.unite(v, d);
+            }
+        }
+    }
+    boost::container::flat_map<size_t, std::vector<VertId>> groups;
+    for (const VertId v : g.verts()) {
+        if (v != 0 && v < rev_map.size() && rev_map[v]) {
+            groups[components.find(v)].push_back(v);
+        }
+    }
+    Partition& partition = mutable_partition();
+    if (groups.size() == 1) {
+        Pack pack{.core = std::move(core), .rev_map = rev_map};
+        for (const VertId v : groups.begin()->second) {
+            pack.vert_map.emplace(*rev_map[v], v);
+            partition.pack_of.emplace(*rev_map[v], partition.packs.size());
+        }
+        partition.packs.push_back(Cow<Pack>::make(std::move(pack)));
+        return;
+    }
+    for (const auto& [root, verts] : groups) {
+        const DbmPart part{core, verts};
+        Pack pack{.core = SplitDBM::product(std::span{&part, 1})};
+        for (const VertId v : verts) {
+            pack.vert_map.emplace(*rev_map[v], gsl::narrow<VertId>(pack.rev_map.size()));
+            pack.rev_map.emplace_back(rev_map[v]);
+            partition.pack_of.emplace(*rev_map[v], partition.packs.size());
+        }
+        partition.packs.push_back(Cow<Pack>::make(std::move(pack)));
+    }
+}
+
+void ZoneDomain::adopt(const Cow<Pack>& pack) {
+    Partition& partition = mutable_partition();
+    for (const auto& [var, vert] : pack->vert_map) {
+        partition.pack_of.emplace(var, partition.packs.size());
+    }
+    partition.packs.push_back(pack);
+}
+
+ZoneDomain::PackView ZoneDomain::view(const ZoneDomain& dom, const std::vector<size_t>& packs) {
+    if (packs.size() == 1) {
+        return PackView{.pack = &*dom.partition_->packs[packs.front()]};
+    }
+    PackView result;
+    std::vector<std::vector<VertId>> verts(packs.size());
+    std::vector<DbmPart> parts;
+    VertId next = 1;
+    for (size_t i = 0; i < packs.size(); ++i) {
+        const Pack& pack = *dom.partition_->packs[packs[i]];
+        for (const auto& [var, vert] : pack.vert_map) {
+            verts[i].push_back(vert);
+            result.merged_map.emplace(var, next++);
+        }
+        parts.push_back(DbmPart{pack.core, verts[i]});
+    }
+    result.merged = SplitDBM::product(parts);
+    return result;
+}
+
+std::vector<ZoneDomain::Block> ZoneDomain::common_blocks(const std::span<const ZoneDomain* const> doms,
+                                                         const bool relate_bounds) {
+    // The packs of all operands are numbered consecutively. A common variable relates its pack in
+    // every operand.
+    std::vector<size_t> first_node;
+    size_t n_nodes = 0;
+    for (const ZoneDomain* dom : doms) {
+        first_node.push_back(n_nodes);
+        n_nodes += dom->partition_->packs.size();
+    }
+    DisjointSetUnion nodes{n_nodes};
+    std::vector<std::pair<Variable, std::vector<size_t>>> common;
+    for (const auto& [var, first] : doms.front()->partition_->pack_of) {
+        std::vector<size_t> packs{first};
+        for (const ZoneDomain* dom : doms.subspan(1)) {
+            const auto it = dom->partition_->pack_of.find(var);
+            if (it == dom->partition_->pack_of.end()) {
+                break;
+            }
+            packs.push_back(it->second);
+        }
+        if (packs.size() < doms.size()) {
+            continue;
+        }
+        for (size_t k = 1; k < doms.size(); ++k) {
+            nodes.unite(first, first_node[k] + packs[k]);
+        }
+        common.emplace_back(var, std::move(packs));
+    }
+
+    if (relate_bounds) {
+        // The join relates every variable whose lower bound moves in one direction to every other
+        // variable whose upper bound moves in the same direction (see SplitDBM::join). When more
+        // than two operands are joined in turn, a bound moves up if it is above that of some earlier
+        // operand, and down if it is below.
+        std::vector<std::pair<Variable, size_t>> lb_up, lb_down, ub_up, ub_down;
+        for (const auto& [var, packs] : common) {
+            const auto moves = [&](const auto& edge_val, auto& up, auto& down) {
+                std::optional<Weight> lowest, highest;
+                bool moved_up = false;
+                bool moved_down = false;
+                for (size_t k = 0; k < doms.size(); ++k) {
+                    const Pack& pack = *doms[k]->partition_->packs[packs[k]];
+                    const std::optional<Weight> w = edge_val(pack.core.graph(), pack.vert_map.at(var));
+                    if (!w) {
+                        continue;
+                    }
+                    moved_up |= lowest && *lowest < *w;
+                    moved_down |= highest && *w < *highest;
+                    lowest = lowest ? std::min(*lowest, *w) : *w;
+                    highest = highest ? std::max(*highest, *w) : *w;
+                }
+                if (moved_up) {
+                    up.emplace_back(var, packs.front());
+                }
+                if (moved_down) {
+                    down.emplace_back(var, packs.front());
+                }
+            };
+            moves([](const Graph& g, const VertId v) { return g.lookup(0, v); }, ub_up, ub_down);
+            moves([](const Graph& g, const VertId v) { return g.lookup(v, 0); }, lb_down, lb_up);
+        }
+        const auto relate = [&](const auto& sources, const auto& dests) {
+            if (sources.empty() || dests.empty() ||
+                (sources.size() == 1 && dests.size() == 1 && sources.front().first == dests.front().first)) {
+                return;
+            }
+            for (const auto* side : {&sources, &dests}) {
+                for (const auto& [var, node] : *side) {
+                    nodes.unite(node, sources.front().second);
+                }
+            }
+        };
+        relate(lb_up, ub_up);
+        relate(lb_down, ub_down);
+    }
+
+    boost::container::flat_map<size_t, Block> blocks;
+    for (const auto& [var, packs] : common) {
+        Block& block = blocks[nodes.find(packs.front())];
+        block.vars.push_back(var);
+        block.packs.resize(doms.size());
+        for (size_t k = 0; k < doms.size(); ++k) {
+            block.packs[k].push_back(packs[k]);
+        }
+    }
+    std::vector<Block> result;
+    result.reserve(blocks.size());
+    for (auto& [root, block] : blocks) {
+        for (auto& packs : block.packs) {
+            std::ranges::sort(packs);
+            const auto [first, last] = std::ranges::unique(packs);
+            packs.erase(first, last);
+        }
+        result.push_back(std::move(block));
+    }
+    return result;
+}
+
 void ZoneDomain::diffcsts_of_assign(const LinearExpression& exp, std::vector<std::pair<Variable, Weight>>& lb,
                                     std::vector<std::pair<Variable, Weight>>& ub) const {
     diffcsts_of_assign(exp, true, ub);
@@ -251,11 +528,30 @@ bool ZoneDomain::add_linear_leq(const LinearExpression& exp) {
     std::vector<std::pair<Variable, Weight>> lbs, ubs;
     std::vector<diffcst_t> csts;
     diffcsts_of_lin_leq(exp, csts, lbs, ubs);
+    if (intervals_only) {
+        csts.clear();
+    }
+
+    // Difference constraints relate their variables, which must share a pack.
+    std::vector<Variable> related;
+    for (const auto& [diff, k] : csts) {
+        related.push_back(diff.first);
+        related.push_back(diff.second);
+    }
+    std::vector<size_t> touched;
+    if (!related.empty()) {
+        touched.push_back(pack_for(related));
+    }
+    const auto vert_of = [&](const Variable var) {
+        const size_t pack = pack_for(std::span{&var, 1});
+        touched.push_back(pack);
+        return std::pair{pack, get_vert(pack, var)};
+    };
 
     // Apply lower bounds
     for (const auto& [var, n] : lbs) {
-        const VertId vert = get_vert(var);
-        if (!core_->update_bound_if_tighter(vert, Side::LEFT, n)) {
+        const auto [pack, vert] = vert_of(var);
+        if (!mutable_pack(pack).core.update_bound_if_tighter(vert, Side::LEFT, n)) {
             return false;
         }
     }
@@ -265,23 +561,29 @@ bool ZoneDomain::add_linear_leq(const LinearExpression& exp) {
         if (variable_registry.is_min_only(var)) {
             continue;
         }
-        const VertId vert = get_vert(var);
-        if (!core_->update_bound_if_tighter(vert, Side::RIGHT, n)) {
+        const auto [pack, vert] = vert_of(var);
+        if (!mutable_pack(pack).core.update_bound_if_tighter(vert, Side::RIGHT, n)) {
             return false;
         }
     }
 
     // Apply difference constraints
     for (const auto& [diff, k] : csts) {
-        const VertId src = get_vert(diff.second);
-        const VertId dest = get_vert(diff.first);
-        if (!core_->add_difference_constraint(src, dest, k)) {
+        const size_t pack = touched.front();
+        const VertId src = get_vert(pack, diff.second);
+        const VertId dest = get_vert(pack, diff.first);
+        if (!mutable_pack(pack).core.add_difference_constraint(src, dest, k)) {
             return false;
         }
     }
 
-    core_->close_after_bound_updates();
-    normalize();
+    std::ranges::sort(touched);
+    const auto [first, last] = std::ranges::unique(touched);
+    touched.erase(first, last);
+    for (const size_t pack : touched) {
+        SplitDBM& core = mutable_pack(pack).core;
+        core.close_after_bound_updates();
+    }
     return true;
 }
 
@@ -308,18 +610,48 @@ bool ZoneDomain::add_univar_disequation(const Variable x, const Number& n) {
         return true;
     }
 
-    const VertId v = get_vert(x);
+    const size_t pack = pack_for(std::span{&x, 1});
+    SplitDBM& core = mutable_pack(pack).core;
+    const VertId v = get_vert(pack, x);
     if (new_i.lb().is_finite()) {
-        if (!core_->strengthen_bound(v, Side::LEFT, Weight{*new_i.lb().number()})) {
+        if (!core.strengthen_bound(v, Side::LEFT, Weight{*new_i.lb().number()})) {
             return false;
         }
     }
     if (new_i.ub().is_finite() && !variable_registry.is_min_only(x)) {
-        if (!core_->strengthen_bound(v, Side::RIGHT, Weight{*new_i.ub().number()})) {
+        if (!core.strengthen_bound(v, Side::RIGHT, Weight{*new_i.ub().number()})) {
             return false;
         }
     }
-    normalize();
+    return true;
+}
+
+bool ZoneDomain::bounds_within(const ZoneDomain& o) const {
+    for (const Cow<Pack>& opack : o.partition_->packs) {
+        const auto holds = [&](const VertId ov, const Weight& ow, const bool upper) {
+            const auto located = locate(*opack->rev_map[ov]);
+            if (!located) {
+                return false;
+            }
+            if (located->first == opack.get()) {
+                return true;
+            }
+            const Graph& g = located->first->core.graph();
+            const std::optional<Weight> w = upper ? g.lookup(0, located->second) : g.lookup(located->second, 0);
+            return w && *w <= ow;
+        };
+        const Graph& og = opack->core.graph();
+        for (const auto& [d, w] : og.e_succs(0)) {
+            if (!holds(d, w, true)) {
+                return false;
+            }
+        }
+        for (const auto& [s, w] : og.e_preds(0)) {
+            if (!holds(s, w, false)) {
+                return false;
+            }
+        }
+    }
     return true;
 }
 
@@ -332,124 +664,210 @@ bool ZoneDomain::operator<=(const ZoneDomain& o) const {
         return false;
     }
 
-    if (vert_map_.size() < o.vert_map_.size()) {
+    if (partition_.get() == o.partition_.get()) {
+        return true;
+    }
+    if (partition_->pack_of.size() < o.partition_->pack_of.size()) {
+        return false;
+    }
+    if (!bounds_within(o)) {
         return false;
     }
 
-    // Build permutation mapping from o's vertices to this's vertices
+    // Each pack of o must be entailed by the packs of this that hold its variables.
     constexpr VertId INVALID_VERT = std::numeric_limits<VertId>::max();
-    std::vector perm(o.core_->graph_size(), INVALID_VERT);
-    perm[0] = 0;
-    for (const auto& [v, n] : o.vert_map_) {
-        if (!o.core_->vertex_has_edges(n)) {
+    for (const Cow<Pack>& opack : o.partition_->packs) {
+        std::vector<size_t> packs;
+        for (const auto& [v, n] : opack->vert_map) {
+            if (!opack->core.vertex_has_edges(n)) {
+                continue;
+            }
+            // We can't have this <= o if we're missing some vertex.
+            const auto it = partition_->pack_of.find(v);
+            if (it == partition_->pack_of.end()) {
+                return false;
+            }
+            packs.push_back(it->second);
+        }
+        if (packs.empty()) {
+            continue;
+        }
+        std::ranges::sort(packs);
+        const auto [first, last] = std::ranges::unique(packs);
+        packs.erase(first, last);
+        if (packs.size() == 1 && partition_->packs[packs.front()].get() == opack.get()) {
             continue;
         }
 
-        // We can't have this <= o if we're missing some vertex.
-        if (auto y = try_at(vert_map_, v)) {
-            perm[n] = *y;
-        } else {
+        // Build permutation mapping from o's vertices to this's vertices
+        const PackView mine = view(*this, packs);
+        std::vector perm(opack->core.graph_size(), INVALID_VERT);
+        perm[0] = 0;
+        for (const auto& [v, n] : opack->vert_map) {
+            if (const auto y = try_at(mine.vert_map(), v)) {
+                perm[n] = *y;
+            }
+        }
+        if (!SplitDBM::is_subsumed_by(mine.core(), opack->core, perm)) {
             return false;
         }
     }
-
-    return SplitDBM::is_subsumed_by(*core_, *o.core_, perm);
+    return true;
 }
 
-using RevMap = std::vector<std::optional<Variable>>;
-using VertMap = boost::container::flat_map<Variable, VertId>;
-
-[[nodiscard]]
-std::pair<VertMap, RevMap> result_mappings(const RevMap&& aligned_vars) {
-    VertMap vmap;
-    RevMap revmap = aligned_vars;
-
-    for (size_t i = 1; i < aligned_vars.size(); ++i) {
-        if (aligned_vars[i]) {
-            vmap.emplace(*aligned_vars[i], gsl::narrow<VertId>(i));
+bool ZoneDomain::identical(const ZoneDomain& o) const {
+    if (partition_.get() == o.partition_.get()) {
+        return true;
+    }
+    // The number of edges, and of unstable vertices and closure edits of the widening they come from.
+    const auto counts = [](const ZoneDomain& dom) {
+        std::array<size_t, 3> result{};
+        for (const Cow<Pack>& pack : dom.partition_->packs) {
+            result[0] += pack->core.num_edges();
+            result[1] += std::ranges::count_if(pack->core.unstable(),
+                                               [&](const VertId v) { return pack->core.vertex_has_edges(v); });
+            result[2] += pack->core.closure_edits().size();
         }
+        return result;
+    };
+    if (counts(*this) != counts(o)) {
+        return false;
     }
-    return {std::move(vmap), std::move(revmap)};
-}
-
-// Build alignment from intersection of variables (for join/widen)
-std::tuple<AlignedPair, RevMap> ZoneDomain::make_intersection_alignment(const ZoneDomain& left,
-                                                                        const ZoneDomain& right) {
-    std::vector<VertId> perm_left = {0};
-    std::vector<VertId> perm_right = {0};
-    RevMap aligned_vars = {std::nullopt};
-
-    for (const auto& [var, left_vert] : left.vert_map_) {
-        if (auto right_vert = try_at(right.vert_map_, var)) {
-            perm_left.push_back(left_vert);
-            perm_right.push_back(*right_vert);
-            aligned_vars.emplace_back(var);
+    // With as many of each on both sides, it suffices that every one of this is in o. The unstable
+    // vertices without edges are left out: they add nothing to the closure of the next widening.
+    for (const Cow<Pack>& pack : partition_->packs) {
+        const Graph& g = pack->core.graph();
+        const Pack* opack = nullptr;
+        std::vector<std::optional<VertId>> perm(pack->core.graph_size());
+        perm[0] = 0;
+        for (const auto& [v, n] : pack->vert_map) {
+            if (!pack->core.vertex_has_edges(n)) {
+                continue;
+            }
+            const auto located = o.locate(v);
+            if (!located || (opack && located->first != opack)) {
+                return false;
+            }
+            opack = located->first;
+            perm[n] = located->second;
+        }
+        if (!opack || opack == &*pack) {
+            continue;
+        }
+        const Graph& og = opack->core.graph();
+        for (const VertId s : g.verts()) {
+            for (const auto& [d, w] : g.e_succs(s)) {
+                const std::optional<Weight> ow = og.lookup(*perm[s], *perm[d]);
+                if (!ow || *ow != w) {
+                    return false;
+                }
+            }
+        }
+        for (const VertId v : pack->core.unstable()) {
+            if (pack->core.vertex_has_edges(v) && !opack->core.unstable().contains(*perm[v])) {
+                return false;
+            }
+        }
+        // The edits are on edges of the graph, whose vertices are all mapped.
+        const auto edge = [](const SplitDBM::ClosureEdit& e) { return std::pair{e.src, e.dest}; };
+        const auto oedits = opack->core.closure_edits();
+        for (const auto& [src, dest, before] : pack->core.closure_edits()) {
+            const auto it = std::ranges::lower_bound(oedits, std::pair{*perm[src], *perm[dest]}, {}, edge);
+            if (it == oedits.end() || it->src != *perm[src] || it->dest != *perm[dest] || it->before != before) {
+                return false;
+            }
         }
     }
-
-    return std::make_tuple(AlignedPair{*left.core_, *right.core_, std::move(perm_left), std::move(perm_right)},
-                           std::move(aligned_vars));
+    return true;
 }
 
-// Build alignment from union of variables (for meet)
-std::tuple<AlignedPair, RevMap> ZoneDomain::make_union_alignment(const ZoneDomain& left, const ZoneDomain& right) {
-    constexpr VertId NOT_PRESENT = static_cast<VertId>(-1);
-
-    std::vector<VertId> perm_left = {0};
-    std::vector<VertId> perm_right = {0};
-    RevMap aligned_vars = {std::nullopt};
-    std::vector initial_potentials = {Weight(0)};
-
-    boost::container::flat_map<Variable, size_t> var_to_index;
-    for (const auto& [var, left_vert] : left.vert_map_) {
-        var_to_index.emplace(var, perm_left.size());
-        perm_left.push_back(left_vert);
-        perm_right.push_back(NOT_PRESENT);
-        aligned_vars.emplace_back(var);
-        initial_potentials.push_back(left.core_->potential_at(left_vert) - left.core_->potential_at_zero());
-    }
-
-    for (const auto& [var, right_vert] : right.vert_map_) {
-        if (const auto it = var_to_index.find(var); it != var_to_index.end()) {
-            perm_right[it->second] = right_vert;
-        } else {
-            perm_left.push_back(NOT_PRESENT);
-            perm_right.push_back(right_vert);
-            aligned_vars.emplace_back(var);
-            initial_potentials.push_back(right.core_->potential_at(right_vert) - right.core_->potential_at_zero());
+std::size_t ZoneDomain::hash() const {
+    // A sum over the edges and the widening state, so that the order of packs and vertices does not matter.
+    std::size_t result = 0;
+    for (const Cow<Pack>& pack : partition_->packs) {
+        const Graph& g = pack->core.graph();
+        const auto key = [&](const VertId v) { return v == 0 ? 0 : pack->rev_map[v]->hash() + 1; };
+        for (const VertId s : g.verts()) {
+            for (const auto& [d, w] : g.e_succs(s)) {
+                std::size_t seed = key(s);
+                boost::hash_combine(seed, key(d));
+                boost::hash_combine(seed, w);
+                result += seed;
+            }
+        }
+        for (const VertId v : pack->core.unstable()) {
+            if (pack->core.vertex_has_edges(v)) {
+                // As a loop v -> v, which is never an edge.
+                std::size_t seed = key(v);
+                boost::hash_combine(seed, key(v));
+                result += seed;
+            }
+        }
+        for (const auto& [src, dest, before] : pack->core.closure_edits()) {
+            std::size_t seed = key(src);
+            boost::hash_combine(seed, key(dest));
+            boost::hash_combine(seed, before.has_value());
+            if (before) {
+                boost::hash_combine(seed, *before);
+            }
+            result += seed;
         }
     }
-
-    return std::make_tuple(AlignedPair{*left.core_, *right.core_, std::move(perm_left), std::move(perm_right),
-                                       std::move(initial_potentials)},
-                           std::move(aligned_vars));
+    return result;
 }
 
-ZoneDomain do_join(const ZoneDomain& left, const ZoneDomain& right) {
-    if (right.is_top()) {
-        return right;
+ZoneDomain ZoneDomain::join(const std::span<const ZoneDomain* const> doms) {
+    if (doms.size() == 1) {
+        return *doms.front();
     }
-    if (left.is_top()) {
-        return left;
+    for (const ZoneDomain* dom : doms) {
+        if (dom->is_top()) {
+            return *dom;
+        }
     }
 
-    // 1. Build alignment (intersection of variables)
-    auto [aligned_pair, aligned_vars] = ZoneDomain::make_intersection_alignment(left, right);
-
-    // 2. Execute graph join
-    SplitDBM joined = SplitDBM::join(aligned_pair);
+    // Join each block of related packs on its own. A pack shared by all operands is joined too, since
+    // the join relates variables through their bounds.
+    ZoneDomain result;
+    for (const Block& block : common_blocks(doms, !intervals_only)) {
+        // 1. Build the alignment of each operand (intersection of variables)
+        std::vector<PackView> views;
+        std::vector<std::vector<VertId>> perms;
+        views.reserve(doms.size());
+        for (size_t k = 0; k < doms.size(); ++k) {
+            views.push_back(view(*doms[k], block.packs[k]));
+            std::vector<VertId>& perm = perms.emplace_back(1, 0);
+            for (const Variable var : block.vars) {
+                perm.push_back(views.back().vert_map().at(var));
+            }
+        }
+        RevMap aligned_vars = {std::nullopt};
+        aligned_vars.insert(aligned_vars.end(), block.vars.begin(), block.vars.end());
+
+        // 2. Execute graph join, folding the operands into the aligned graph of the first two
+        SplitDBM joined =
+            SplitDBM::join(AlignedPair{views[0].core(), views[1].core(), std::move(perms[0]), std::move(perms[1])});
+        if (doms.size() > 2) {
+            std::vector<VertId> identity(aligned_vars.size());
+            std::iota(identity.begin(), identity.end(), VertId{0});
+            for (size_t k = 2; k < doms.size(); ++k) {
+                joined = SplitDBM::join(AlignedPair{joined, views[k].core(), identity, std::move(perms[k])});
+            }
+        }
 
-    // 3. Build result mappings and garbage collect
-    auto [out_vmap, out_revmap] = result_mappings(std::move(aligned_vars));
-    for (const VertId v : joined.get_disconnected_vertices()) {
-        joined.forget(v);
-        if (out_revmap[v]) {
-            out_vmap.erase(*out_revmap[v]);
-            out_revmap[v] = std::nullopt;
+        // 3. Garbage collect and split into packs
+        for (const VertId v : joined.get_disconnected_vertices()) {
+            joined.forget(v);
+            aligned_vars[v] = std::nullopt;
         }
+        result.add_components(std::move(joined), aligned_vars);
     }
+    return result;
+}
 
-    return ZoneDomain(std::move(out_vmap), std::move(out_revmap), std::make_unique<SplitDBM>(std::move(joined)));
+ZoneDomain do_join(const ZoneDomain& left, const ZoneDomain& right) {
+    const std::array doms{&left, &right};
+    return ZoneDomain::join(doms);
 }
 
 void ZoneDomain::operator|=(const ZoneDomain& right) { *this = do_join(*this, right); }
@@ -457,16 +875,37 @@ void ZoneDomain::operator|=(const ZoneDomain& right) { *this = do_join(*this, ri
 ZoneDomain ZoneDomain::operator|(const ZoneDomain& right) const { return do_join(*this, right); }
 
 ZoneDomain ZoneDomain::widen(const ZoneDomain& o) const {
-    // 1. Build alignment (intersection of variables)
-    auto [aligned_pair, aligned_vars] = make_intersection_alignment(*this, o);
+    ZoneDomain result;
+    const std::array doms{this, &o};
+    for (const Block& block : common_blocks(doms, false)) {
+        const std::vector<size_t>& left_packs = block.packs[0];
+        const std::vector<size_t>& right_packs = block.packs[1];
+        if (left_packs.size() == 1 && right_packs.size() == 1 &&
+            partition_->packs[left_packs.front()].get() == o.partition_->packs[right_packs.front()].get()) {
+            result.adopt(partition_->packs[left_packs.front()]);
+            continue;
+        }
 
-    // 2. Execute graph widen
-    auto result_core = std::make_unique<SplitDBM>(SplitDBM::widen(aligned_pair));
+        // 1. Build alignment (intersection of variables)
+        const PackView lview = view(*this, left_packs);
+        const PackView rview = view(o, right_packs);
+        std::vector<VertId> perm_left = {0};
+        std::vector<VertId> perm_right = {0};
+        RevMap aligned_vars = {std::nullopt};
+        for (const Variable var : block.vars) {
+            perm_left.push_back(lview.vert_map().at(var));
+            perm_right.push_back(rview.vert_map().at(var));
+            aligned_vars.emplace_back(var);
+        }
 
-    // 3. Build result mappings
-    auto [out_vmap, out_revmap] = result_mappings(std::move(aligned_vars));
+        // 2. Execute graph widen
+        SplitDBM widened =
+            SplitDBM::widen(AlignedPair{lview.core(), rview.core(), std::move(perm_left), std::move(perm_right)});
 
-    return ZoneDomain(std::move(out_vmap), std::move(out_revmap), std::move(result_core));
+        // 3. Split into packs
+        result.add_components(std::move(widened), aligned_vars);
+    }
+    return result;
 }
 
 std::optional<ZoneDomain> ZoneDomain::meet(const ZoneDomain& o) const {
@@ -477,27 +916,82 @@ std::optional<ZoneDomain> ZoneDomain::meet(const ZoneDomain& o) const {
         return *this;
     }
 
-    // 1. Build alignment (union of variables, with initial potentials)
-    auto [aligned_pair, aligned_vars] = make_union_alignment(*this, o);
-
-    // 2. Execute graph meet
-    auto meet_result = SplitDBM::meet(aligned_pair);
-    if (!meet_result) {
-        return std::nullopt; // Infeasible
+    // Packs related by a common variable are met together; the others are kept as they are.
+    const size_t n_left = partition_->packs.size();
+    DisjointSetUnion nodes{n_left + o.partition_->packs.size()};
+    for (const auto& [var, l] : partition_->pack_of) {
+        if (const auto it = o.partition_->pack_of.find(var); it != o.partition_->pack_of.end()) {
+            nodes.unite(l, n_left + it->second);
+        }
     }
+    boost::container::flat_map<size_t, std::pair<std::vector<size_t>, std::vector<size_t>>> blocks;
+    for (size_t l = 0; l < n_left; ++l) {
+        blocks[nodes.find(l)].first.push_back(l);
+    }
+    for (size_t r = 0; r < o.partition_->packs.size(); ++r) {
+        blocks[nodes.find(n_left + r)].second.push_back(r);
+    }
+
+    ZoneDomain result;
+    for (const auto& [root, block] : blocks) {
+        const auto& [left_packs, right_packs] = block;
+        if (right_packs.empty()) {
+            result.adopt(partition_->packs[left_packs.front()]);
+            continue;
+        }
+        if (left_packs.empty()) {
+            result.adopt(o.partition_->packs[right_packs.front()]);
+            continue;
+        }
+        if (left_packs.size() == 1 && right_packs.size() == 1 &&
+            partition_->packs[left_packs.front()].get() == o.partition_->packs[right_packs.front()].get()) {
+            result.adopt(partition_->packs[left_packs.front()]);
+            continue;
+        }
 
-    // 3. Build result mappings
-    auto [out_vmap, out_revmap] = result_mappings(std::move(aligned_vars));
+        // 1. Build alignment (union of variables, with initial potentials)
+        constexpr VertId NOT_PRESENT = static_cast<VertId>(-1);
+        const PackView lview = view(*this, left_packs);
+        const PackView rview = view(o, right_packs);
+        const SplitDBM& lcore = lview.core();
+        const SplitDBM& rcore = rview.core();
+        std::vector<VertId> perm_left = {0};
+        std::vector<VertId> perm_right = {0};
+        RevMap aligned_vars = {std::nullopt};
+        std::vector initial_potentials = {Weight(0)};
+        for (const auto& [var, left_vert] : lview.vert_map()) {
+            perm_left.push_back(left_vert);
+            perm_right.push_back(try_at(rview.vert_map(), var).value_or(NOT_PRESENT));
+            aligned_vars.emplace_back(var);
+            initial_potentials.push_back(lcore.potential_at(left_vert) - lcore.potential_at_zero());
+        }
+        for (const auto& [var, right_vert] : rview.vert_map()) {
+            if (!lview.vert_map().contains(var)) {
+                perm_left.push_back(NOT_PRESENT);
+                perm_right.push_back(right_vert);
+                aligned_vars.emplace_back(var);
+                initial_potentials.push_back(rcore.potential_at(right_vert) - rcore.potential_at_zero());
+            }
+        }
+        AlignedPair aligned{lcore, rcore, std::move(perm_left), std::move(perm_right), std::move(initial_potentials)};
+
+        // 2. Execute graph meet
+        auto meet_result = SplitDBM::meet(aligned);
+        if (!meet_result) {
+            return std::nullopt; // Infeasible
+        }
 
-    return ZoneDomain(std::move(out_vmap), std::move(out_revmap), std::make_unique<SplitDBM>(std::move(*meet_result)));
+        // 3. Split into packs
+        result.add_components(std::move(*meet_result), aligned_vars);
+    }
+    return result;
 }
 
 void ZoneDomain::havoc(const Variable v) {
-    if (const auto y = try_at(vert_map_, v)) {
-        core_->forget(*y);
-        rev_map_[*y] = std::nullopt;
-        vert_map_.erase(v);
-        normalize();
+    if (const auto it = partition_->pack_of.find(v); it != partition_->pack_of.end()) {
+        const size_t pack = it->second;
+        forget_vertex(pack, v);
+        drop_if_empty(pack);
     }
 }
 
@@ -566,9 +1060,8 @@ void ZoneDomain::assign(Variable lhs, const LinearExpression& e) {
     // JN: it seems that we can only do this if
     // close_bounds_inline is disabled (which in eBPF is always the case).
     // Otherwise, the meet operator misses some non-redundant edges.
-    if (value_interval.is_singleton()) {
+    if (value_interval.is_singleton() || intervals_only) {
         set(lhs, value_interval);
-        normalize();
         return;
     }
 
@@ -577,34 +1070,49 @@ void ZoneDomain::assign(Variable lhs, const LinearExpression& e) {
     diffcsts_of_assign(e, diffs_lb, diffs_ub);
     if (diffs_lb.empty() && diffs_ub.empty()) {
         set(lhs, value_interval);
-        normalize();
         return;
     }
 
+    // The new vertex is related to every variable of the difference constraints.
+    std::vector<Variable> related;
+    for (const auto* diffs : {&diffs_lb, &diffs_ub}) {
+        for (const auto& [var, n] : *diffs) {
+            related.push_back(var);
+        }
+    }
+    const size_t pack = pack_for(related);
     const Weight e_val = eval_expression(e);
 
     std::vector<std::pair<VertId, Weight>> diffs_from, diffs_to;
     for (const auto& [var, n] : diffs_lb) {
-        diffs_from.emplace_back(get_vert(var), -n);
+        diffs_from.emplace_back(get_vert(pack, var), -n);
     }
     for (const auto& [var, n] : diffs_ub) {
-        diffs_to.emplace_back(get_vert(var), n);
+        diffs_to.emplace_back(get_vert(pack, var), n);
     }
 
-    VertId vert = core_->assign_vertex(core_->potential_at_zero() + e_val, diffs_from, diffs_to, lb_w,
+    Pack& p = mutable_pack(pack);
+    VertId vert = p.core.assign_vertex(p.core.potential_at_zero() + e_val, diffs_from, diffs_to, lb_w,
                                        (ub_w && !variable_registry.is_min_only(lhs)) ? ub_w : std::nullopt);
 
-    assert(vert <= rev_map_.size());
-    if (vert == rev_map_.size()) {
-        rev_map_.emplace_back(lhs);
+    assert(vert <= p.rev_map.size());
+    if (vert == p.rev_map.size()) {
+        p.rev_map.emplace_back(lhs);
     } else {
-        rev_map_[vert] = lhs;
+        p.rev_map[vert] = lhs;
     }
     // Clear the old x vertex
-    havoc(lhs);
-    vert_map_.emplace(lhs, vert);
+    std::optional<size_t> old_pack;
+    if (const auto it = partition_->pack_of.find(lhs); it != partition_->pack_of.end()) {
+        old_pack = it->second;
+        forget_vertex(*old_pack, lhs);
+    }
+    mutable_pack(pack).vert_map.emplace(lhs, vert);
+    mutable_partition().pack_of.emplace(lhs, pack);
 
-    normalize();
+    if (old_pack && *old_pack != pack) {
+        drop_if_empty(*old_pack);
+    }
 }
 
 ZoneDomain ZoneDomain::narrow(const ZoneDomain& o) const {
@@ -618,8 +1126,6 @@ ZoneDomain ZoneDomain::narrow(const ZoneDomain& o) const {
 
 void ZoneDomain::clear_thread_local_state() { SplitDBM::clear_thread_local_state(); }
 
-void ZoneDomain::normalize() { core_->normalize(); }
-
 void ZoneDomain::set(const Variable x, const Interval& intv) {
     assert(!intv.is_bottom());
 
@@ -629,14 +1135,15 @@ void ZoneDomain::set(const Variable x, const Interval& intv) {
         return;
     }
 
-    const VertId v = get_vert(x);
+    const size_t pack = pack_for(std::span{&x, 1});
+    SplitDBM& core = mutable_pack(pack).core;
+    const VertId v = get_vert(pack, x);
     if (intv.ub().is_finite() && !variable_registry.is_min_only(x)) {
-        core_->set_bound(v, Side::RIGHT, Weight{*intv.ub().number()});
+        core.set_bound(v, Side::RIGHT, Weight{*intv.ub().number()});
     }
     if (intv.lb().is_finite()) {
-        core_->set_bound(v, Side::LEFT, Weight{*intv.lb().number()});
+        core.set_bound(v, Side::LEFT, Weight{*intv.lb().number()});
     }
-    normalize();
 }
 
 void ZoneDomain::apply(const ArithBinOp op, const Variable x, const Variable y, const Variable z) {
@@ -647,7 +1154,6 @@ void ZoneDomain::apply(const ArithBinOp op, const Variable x, const Variable y,
     case ArithBinOp::MUL: set(x, get_interval(y) * get_interval(z)); break;
     default: std::unreachable();
     }
-    normalize();
 }
 
 void ZoneDomain::apply(const ArithBinOp op, const Variable x, const Variable y, const Number& k) {
@@ -656,7 +1162,6 @@ void ZoneDomain::apply(const ArithBinOp op, const Variable x, const Variable y,
     case ArithBinOp::SUB: assign(x, LinearExpression(y).subtract(k)); break;
     case ArithBinOp::MUL: assign(x, LinearExpression(k, y)); break;
     }
-    normalize();
 }
 
 void ZoneDomain::forget(const VariableVector& variables) {
@@ -665,34 +1170,36 @@ void ZoneDomain::forget(const VariableVector& variables) {
     }
 
     for (const auto v : variables) {
-        if (vert_map_.contains(v)) {
-            havoc(v);
-        }
+        havoc(v);
     }
-    normalize();
 }
 
 void ZoneDomain::rename(const std::vector<std::pair<Variable, Variable>>& renaming) {
     assert(std::ranges::none_of(renaming, [&](const auto& pair) {
         return std::ranges::any_of(renaming, [&](const auto& other) { return other.first == pair.second; });
     }));
-    bool forgot_destination = false;
     for (const auto& [from, to] : renaming) {
-        if (const auto it = vert_map_.find(from); it != vert_map_.end()) {
-            const auto vert = it->second;
-            vert_map_.erase(it);
-            if (const auto dest = vert_map_.find(to); dest != vert_map_.end()) {
-                core_->forget(dest->second);
-                rev_map_[dest->second] = std::nullopt;
-                vert_map_.erase(dest);
-                forgot_destination = true;
-            }
-            vert_map_.emplace(to, vert);
-            rev_map_[vert] = to;
+        const auto it = partition_->pack_of.find(from);
+        if (it == partition_->pack_of.end()) {
+            continue;
+        }
+        const size_t pack = it->second;
+        std::optional<size_t> dest_pack;
+        if (const auto dest = partition_->pack_of.find(to); dest != partition_->pack_of.end()) {
+            dest_pack = dest->second;
+            forget_vertex(*dest_pack, to);
+        }
+        Pack& p = mutable_pack(pack);
+        const VertId vert = p.vert_map.at(from);
+        p.vert_map.erase(from);
+        p.vert_map.emplace(to, vert);
+        p.rev_map[vert] = to;
+        Partition& partition = mutable_partition();
+        partition.pack_of.erase(from);
+        partition.pack_of.emplace(to, pack);
+        if (dest_pack && *dest_pack != pack) {
+            drop_if_empty(*dest_pack);
         }
-    }
-    if (forgot_destination) {
-        normalize();
     }
 }
 
@@ -718,26 +1225,25 @@ StringInvariant ZoneDomain::to_set() const {
         return StringInvariant::top();
     }
 
-    const Graph& g = core_->graph();
-
     // Extract all the edges
-    SubGraph g_excl{g, 0};
-
     std::map<Variable, Variable> equivalence_classes;
     std::set<std::tuple<Variable, Variable, Weight>> diff_csts;
-    for (const VertId s : g_excl.verts()) {
-        const Variable vs = *rev_map_.at(s);
-        Variable least = vs;
-        for (const VertId d : g_excl.succs(s)) {
-            const Variable vd = *rev_map_.at(d);
-            const Weight w = g_excl.edge_val(s, d);
-            if (w == 0) {
-                least = std::min(least, vd, VariableRegistry::printing_order);
-            } else {
-                diff_csts.emplace(vd, vs, w);
+    for (const Cow<Pack>& pack : partition_->packs) {
+        SubGraph g_excl{pack->core.graph(), 0};
+        for (const VertId s : g_excl.verts()) {
+            const Variable vs = *pack->rev_map.at(s);
+            Variable least = vs;
+            for (const VertId d : g_excl.succs(s)) {
+                const Variable vd = *pack->rev_map.at(d);
+                const Weight w = g_excl.edge_val(s, d);
+                if (w == 0) {
+                    least = std::min(least, vd, VariableRegistry::printing_order);
+                } else {
+                    diff_csts.emplace(vd, vs, w);
+                }
             }
+            equivalence_classes.insert_or_assign(vs, least);
         }
-        equivalence_classes.insert_or_assign(vs, least);
     }
 
     std::set<Variable> representatives;
@@ -768,36 +1274,40 @@ StringInvariant ZoneDomain::to_set() const {
     }
 
     // Intervals
-    for (VertId v : g_excl.verts()) {
-        const auto pvar = this->rev_map_[v];
-        if (!pvar || !representatives.contains(*pvar)) {
-            continue;
-        }
-        const bool has_lb = g.elem(v, 0);
-        const bool has_ub = g.elem(0, v) && !variable_registry.is_min_only(*pvar);
-        if (!has_lb && !has_ub) {
-            continue;
-        }
-        Interval v_out{has_lb ? -Number(g.edge_val(v, 0)) : MINUS_INFINITY,
-                       has_ub ? Number(g.edge_val(0, v)) : PLUS_INFINITY};
-        assert(!v_out.is_bottom());
+    for (const Cow<Pack>& pack : partition_->packs) {
+        const Graph& g = pack->core.graph();
+        SubGraph g_excl{g, 0};
+        for (VertId v : g_excl.verts()) {
+            const auto pvar = pack->rev_map[v];
+            if (!pvar || !representatives.contains(*pvar)) {
+                continue;
+            }
+            const bool has_lb = g.elem(v, 0);
+            const bool has_ub = g.elem(0, v) && !variable_registry.is_min_only(*pvar);
+            if (!has_lb && !has_ub) {
+                continue;
+            }
+            Interval v_out{has_lb ? -Number(g.edge_val(v, 0)) : MINUS_INFINITY,
+                           has_ub ? Number(g.edge_val(0, v)) : PLUS_INFINITY};
+            assert(!v_out.is_bottom());
 
-        Variable variable = *pvar;
+            Variable variable = *pvar;
 
-        std::stringstream elem;
-        elem << variable;
-        if (variable_registry.is_min_only(variable)) {
-            // One-sided variables: display just the lower bound
-            elem << "=" << v_out.lb();
-        } else {
-            elem << "=";
-            if (v_out.is_singleton()) {
-                elem << v_out.lb();
+            std::stringstream elem;
+            elem << variable;
+            if (variable_registry.is_min_only(variable)) {
+                // One-sided variables: display just the lower bound
+                elem << "=" << v_out.lb();
             } else {
-                elem << v_out;
+                elem << "=";
+                if (v_out.is_singleton()) {
+                    elem << v_out.lb();
+                } else {
+                    elem << v_out;
+                }
             }
+            result.insert(elem.str());
         }
-        result.insert(elem.str());
     }
 
     return StringInvariant{std::move(result)};
@@ -805,10 +1315,28 @@ StringInvariant ZoneDomain::to_set() const {
 
 std::ostream& operator<<(std::ostream& o, const ZoneDomain& dom) { return o << dom.to_set(); }
 
+std::vector<LinearConstraint> ZoneDomain::to_constraints() const {
+    std::vector<LinearConstraint> res;
+    for (const Cow<Pack>& pack : partition_->packs) {
+        const Graph& g = pack->core.graph();
+        const auto term = [&](const VertId v) {
+            return v == 0 ? LinearExpression{0} : LinearExpression{*pack->rev_map.at(v)};
+        };
+        for (const VertId s : g.verts()) {
+            for (const auto& e : g.e_succs(s)) {
+                // An edge s -> d of weight w stands for d - s <= w.
+                res.emplace_back(term(e.vert).subtract(term(s)).subtract(Number{e.val}),
+                                 ConstraintKind::LESS_THAN_OR_EQUALS_ZERO);
+            }
+        }
+    }
+    return res;
+}
+
 Weight ZoneDomain::eval_expression(const LinearExpression& e) const {
     Weight res = e.constant_term();
     for (const auto& [variable, coefficient] : e.variable_terms()) {
-        res += (pot_value(variable) - core_->potential_at_zero()) * Weight{coefficient};
+        res += pot_value(variable) * Weight{coefficient};
     }
     return res;
 }
@@ -823,9 +1351,11 @@ Interval ZoneDomain::compute_residual(const LinearExpression& e, const Variable
     return residual;
 }
 
+// The potential of v relative to vertex 0 of its pack.
 Weight ZoneDomain::pot_value(const Variable v) const {
-    if (const auto y = try_at(vert_map_, v)) {
-        return core_->potential_at(*y);
+    if (const auto located = locate(v)) {
+        const SplitDBM& core = located->first->core;
+        return core.potential_at(located->second) - core.potential_at_zero();
     }
     return {0};
 }
@@ -839,6 +1369,77 @@ Interval ZoneDomain::eval_interval(const LinearExpression& e) const {
     return r;
 }
 
+Interval ZoneDomain::get_difference(const Variable x, const Variable y) const {
+    using namespace prevail::interval_operators;
+    Interval result = get_interval(x) - get_interval(y);
+    const auto lx = locate(x);
+    const auto ly = locate(y);
+    if (!lx || !ly || lx->first != ly->first) {
+        return result;
+    }
+    // An edge s -> d of weight w is d - s <= w.
+    const Graph& g = lx->first->core.graph();
+    if (const auto w = g.lookup(ly->second, lx->second)) {
+        result = result & Interval{MINUS_INFINITY, Bound{Number(*w)}};
+    }
+    if (const auto w = g.lookup(lx->second, ly->second)) {
+        result = result & Interval{Bound{-Number(*w)}, PLUS_INFINITY};
+    }
+    return result;
+}
+
+std::optional<Interval> ZoneDomain::exact_interval(const LinearExpression& e) const {
+    using namespace prevail::interval_operators;
+    // Other coefficients are rounded by add_constraint, which can be more precise over the integers.
+    const auto& terms = e.variable_terms();
+    // The bounds and differences read below are exact only on closed graphs.
+    assert(std::ranges::all_of(terms, [this](const auto& term) {
+        const auto located = locate(term.first);
+        return !located || located->first->core.is_closed();
+    }));
+    if (terms.empty()) {
+        return eval_interval(e);
+    }
+    if (terms.size() == 1) {
+        if (const Number& a = terms.begin()->second; a == 1 || a == -1) {
+            return eval_interval(e);
+        }
+    }
+    if (terms.size() == 2) {
+        const auto& [x, a] = *terms.begin();
+        const auto& [y, b] = *std::next(terms.begin());
+        if (a == 1 && b == -1) {
+            return get_difference(x, y) + Interval{e.constant_term()};
+        }
+        if (a == -1 && b == 1) {
+            return get_difference(y, x) + Interval{e.constant_term()};
+        }
+    }
+    return std::nullopt;
+}
+
+// Whether every value of e in interval satisfies e <kind> 0.
+static bool always_holds(const Interval& interval, const ConstraintKind kind) {
+    switch (kind) {
+    case ConstraintKind::EQUALS_ZERO: return interval.singleton() == std::optional(Number(0));
+    case ConstraintKind::LESS_THAN_OR_EQUALS_ZERO: return interval.ub() <= Number(0);
+    case ConstraintKind::LESS_THAN_ZERO: return interval.ub() < Number(0);
+    case ConstraintKind::NOT_ZERO: return interval.ub() < Number(0) || interval.lb() > Number(0);
+    }
+    return false;
+}
+
+// Whether some value of e in interval satisfies e <kind> 0.
+static bool may_hold(const Interval& interval, const ConstraintKind kind) {
+    switch (kind) {
+    case ConstraintKind::EQUALS_ZERO: return interval.contains(Number(0));
+    case ConstraintKind::LESS_THAN_OR_EQUALS_ZERO: return interval.lb() <= Number(0);
+    case ConstraintKind::LESS_THAN_ZERO: return interval.lb() < Number(0);
+    case ConstraintKind::NOT_ZERO: return interval.singleton() != std::optional(Number(0));
+    }
+    return true;
+}
+
 bool ZoneDomain::intersect(const LinearConstraint& cst) const {
     if (cst.is_contradiction()) {
         return false;
@@ -846,57 +1447,108 @@ bool ZoneDomain::intersect(const LinearConstraint& cst) const {
     if (is_top() || cst.is_tautology()) {
         return true;
     }
+    if (const auto exact = exact_interval(cst.expression())) {
+        return may_hold(*exact, cst.kind());
+    }
     return intersect_aux(cst);
 }
 
-bool ZoneDomain::entail(const LinearConstraint& rhs) const {
+// The values of e that satisfy e <kind> 0, when they form an interval.
+static std::optional<Interval> satisfying(const ConstraintKind kind) {
+    switch (kind) {
+    case ConstraintKind::EQUALS_ZERO: return Interval{Number(0)};
+    case ConstraintKind::LESS_THAN_OR_EQUALS_ZERO: return Interval{MINUS_INFINITY, Bound{Number(0)}};
+    case ConstraintKind::LESS_THAN_ZERO: return Interval{MINUS_INFINITY, Bound{Number(-1)}};
+    case ConstraintKind::NOT_ZERO: return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+std::optional<bool> ZoneDomain::entail_in_place(const LinearConstraint& rhs) const {
     if (rhs.is_tautology()) {
         return true;
     }
     if (rhs.is_contradiction()) {
         return false;
     }
-    const Interval interval = eval_interval(rhs.expression());
-    switch (rhs.kind()) {
-    case ConstraintKind::EQUALS_ZERO:
-        if (interval.singleton() == std::optional(Number(0))) {
-            return true;
-        }
-        break;
-    case ConstraintKind::LESS_THAN_OR_EQUALS_ZERO:
-        if (interval.ub() <= Number(0)) {
-            return true;
-        }
-        break;
-    case ConstraintKind::LESS_THAN_ZERO:
-        if (interval.ub() < Number(0)) {
-            return true;
-        }
-        break;
-    case ConstraintKind::NOT_ZERO:
-        if (interval.ub() < Number(0) || interval.lb() > Number(0)) {
-            return true;
-        }
-        break;
+    if (const auto exact = exact_interval(rhs.expression())) {
+        return always_holds(*exact, rhs.kind());
+    }
+    if (always_holds(eval_interval(rhs.expression()), rhs.kind())) {
+        return true;
     }
+    return std::nullopt;
+}
+
+bool ZoneDomain::entail_aux(const LinearConstraint& cst) const {
     // TODO: copy the implementation from crab
     //       https://github.com/seahorn/crab/blob/master/include/crab/domains/split_dbm.hpp
-    if (rhs.kind() == ConstraintKind::EQUALS_ZERO) {
+    if (cst.kind() == ConstraintKind::EQUALS_ZERO) {
         // try to convert the equality into inequalities so when it's
         // negated we do not have disequalities.
-        return entail_aux(LinearConstraint(rhs.expression(), ConstraintKind::LESS_THAN_OR_EQUALS_ZERO)) &&
-               entail_aux(LinearConstraint(rhs.expression().negate(), ConstraintKind::LESS_THAN_OR_EQUALS_ZERO));
-    } else {
-        return entail_aux(rhs);
+        return entail_aux(LinearConstraint(cst.expression(), ConstraintKind::LESS_THAN_OR_EQUALS_ZERO)) &&
+               entail_aux(LinearConstraint(cst.expression().negate(), ConstraintKind::LESS_THAN_OR_EQUALS_ZERO));
     }
+    return !ZoneDomain(*this).add_constraint(cst.negate());
 
-    // Note: we cannot convert rhs into ZoneDomain and then use the <=
+    // Note: we cannot convert cst into ZoneDomain and then use the <=
     //       operator. The problem is that we cannot know for sure
-    //       whether ZoneDomain can represent precisely rhs. It is not
+    //       whether ZoneDomain can represent precisely cst. It is not
     //       enough to do something like
     //
-    //       ZoneDomain dom = rhs;
+    //       ZoneDomain dom = cst;
     //       if (dom.is_top()) { ... }
 }
 
+bool ZoneDomain::entail(const LinearConstraint& rhs) const {
+    if (const auto entailed = entail_in_place(rhs)) {
+        return *entailed;
+    }
+    return entail_aux(rhs);
+}
+
+std::optional<std::size_t> ZoneDomain::first_not_entailed(const std::span<const LinearConstraint> csts) const {
+    std::vector<std::optional<bool>> decided;
+    decided.reserve(csts.size());
+    std::size_t end = csts.size();
+    for (std::size_t i = 0; i < end; ++i) {
+        decided.push_back(entail_in_place(csts[i]));
+        if (decided[i] == std::optional(false)) {
+            end = i;
+        }
+    }
+    for (std::size_t i = 0; i < end; ++i) {
+        if (!decided[i] && !entail_aux(csts[i])) {
+            return i;
+        }
+    }
+    if (end < csts.size()) {
+        return end;
+    }
+    return std::nullopt;
+}
+
+bool ZoneDomain::implies(const LinearConstraint& premise, const LinearConstraint& conclusion) const {
+    using namespace prevail::interval_operators;
+    if (entail_in_place(premise) == std::optional(true)) {
+        // A premise that always holds adds nothing.
+        return entail(conclusion);
+    }
+    if (const auto exact = exact_interval(premise.expression())) {
+        if (!may_hold(*exact, premise.kind())) {
+            return true;
+        }
+        // Both bound t, the common variable terms: t + cp and t + cc. On a closed graph, adding the
+        // premise restricts the range of t exactly to the values that satisfy it.
+        const auto range = satisfying(premise.kind());
+        if (range && premise.expression().variable_terms() == conclusion.expression().variable_terms()) {
+            const Interval restricted = *exact & *range;
+            const Number shift = conclusion.expression().constant_term() - premise.expression().constant_term();
+            return always_holds(restricted + Interval{shift}, conclusion.kind());
+        }
+    }
+    ZoneDomain result(*this);
+    return !result.add_constraint(premise) || result.entail(conclusion);
+}
+
 } // namespace prevail
@@ -19,15 +19,17 @@
 
 #pragma once
 
-#include <memory>
 #include <optional>
+#include <span>
 #include <utility>
+#include <vector>
 
 #include <boost/container/flat_map.hpp>
 
 #include "arith/linear_constraint.hpp"
 #include "arith/num_big.hpp"
 #include "arith/variable.hpp"
+#include "crab/cow.hpp"
 #include "crab/interval.hpp"
 #include "crab/splitdbm/split_dbm.hpp"
 #include "string_constraints.hpp"
@@ -51,12 +53,53 @@ class ZoneDomain final {
     using diffcst_t = std::pair<std::pair<Variable, Variable>, splitdbm::Weight>;
     friend class VertSetWrap;
 
-    std::unique_ptr<splitdbm::SplitDBM> core_;
+    /// A set of variables with a graph of its own. No relational edge connects variables of
+    /// different packs, so the domain is the product of its packs. Packs are merged when a
+    /// constraint relates their variables, and split into connected components after a join,
+    /// widening or meet. Packs are shared between copies until one of them modifies the pack.
+    struct Pack {
+        splitdbm::SplitDBM core;
+        VertMap vert_map; // Mapping from variables to vertices
+        RevMap rev_map = RevMap(1);
+    };
 
-    VertMap vert_map_; // Mapping from variables to vertices
-    RevMap rev_map_;
+    // The packs of one side of a binary operation, viewed as a single graph.
+    struct PackView;
+    // Common variables of several domains whose packs are related.
+    struct Block;
+
+    struct Partition {
+        std::vector<Cow<Pack>> packs;
+        boost::container::flat_map<Variable, size_t> pack_of; // Index in packs of the pack of each variable
+    };
+
+    // Shared between copies, so copying a domain is O(1). Mutators go through mutable_partition().
+    Cow<Partition> partition_{empty_partition()};
+
+    static const Cow<Partition>& empty_partition();
+
+    Partition& mutable_partition() { return partition_.get_mutable(); }
+
+    [[nodiscard]]
+    std::optional<std::pair<const Pack*, splitdbm::VertId>> locate(Variable v) const;
+
+    Pack& mutable_pack(const size_t index) { return mutable_partition().packs[index].get_mutable(); }
+
+    // Merge the packs of the given variables (and a fresh pack for the others) and return its index.
+    size_t pack_for(std::span<const Variable> vars);
+    splitdbm::VertId get_vert(size_t pack, Variable v);
+    // Remove v from its pack, which is left in place even if empty.
+    void forget_vertex(size_t pack, Variable v);
+    void drop_if_empty(size_t pack);
+    void remove_pack(size_t pack);
+
+    // Add the connected components of core as packs.
+    void add_components(splitdbm::SplitDBM&& core, const RevMap& rev_map);
+    void adopt(const Cow<Pack>& pack);
+
+    static PackView view(const ZoneDomain& dom, const std::vector<size_t>& packs);
+    static std::vector<Block> common_blocks(std::span<const ZoneDomain* const> doms, bool relate_bounds);
 
-    splitdbm::VertId get_vert(Variable v);
     // Evaluate the potential value of a variable.
     [[nodiscard]]
     splitdbm::Weight pot_value(Variable v) const;
@@ -110,27 +153,27 @@ class ZoneDomain final {
     // x != n
     bool add_univar_disequation(Variable x, const Number& n);
 
-    void normalize();
+    Interval get_interval(Variable x) const;
 
-    std::optional<splitdbm::VertId> get_vertid(Variable x) const;
-    Bound get_lb(const std::optional<splitdbm::VertId>& v) const;
-    Bound get_ub(const std::optional<splitdbm::VertId>& v) const;
+    // The interval of x - y. When x and y share a pack it is bounded by the edges between them,
+    // and exact since the graph is closed.
+    [[nodiscard]]
+    Interval get_difference(Variable x, Variable y) const;
 
-    Interval get_interval(Variable x) const;
+    // The exact range of e when it is k, x + k, -x + k or x - y + k, read from the graph.
+    // Constraints on such expressions are decided from it without copying the domain.
+    [[nodiscard]]
+    std::optional<Interval> exact_interval(const LinearExpression& e) const;
+
+    // Whether each bound of o holds in this. These are the edges through vertex 0 that
+    // is_subsumed_by compares, checked for all packs before any pack of this is aligned with o:
+    // a loop head that has not stabilized usually differs from its previous state in some range.
+    [[nodiscard]]
+    bool bounds_within(const ZoneDomain& o) const;
 
     Bound get_lb(Variable x) const;
     Bound get_ub(Variable x) const;
 
-    // Private constructor for internal use (join, meet, widen, etc.)
-    ZoneDomain(VertMap&& vert_map, RevMap&& rev_map, std::unique_ptr<splitdbm::SplitDBM> core);
-
-    // Build AlignedPair from intersection of variables (for join/widen)
-    static std::tuple<splitdbm::AlignedPair, RevMap> make_intersection_alignment(const ZoneDomain& left,
-                                                                                 const ZoneDomain& right);
-    // Build AlignedPair from union of variables (for meet)
-    static std::tuple<splitdbm::AlignedPair, RevMap> make_union_alignment(const ZoneDomain& left,
-                                                                          const ZoneDomain& right);
-
   public:
     explicit ZoneDomain();
     ~ZoneDomain();
@@ -150,9 +193,22 @@ class ZoneDomain final {
 
     bool operator<=(const ZoneDomain& o) const;
 
+    // Whether both domains have the same edges between the same variables, whatever their packs and
+    // vertex numbering, and come from the same widening (see SplitDBM::unstable), which the next
+    // widening depends on. Implies equality; equal domains may still differ in edges that closure implies.
+    [[nodiscard]]
+    bool identical(const ZoneDomain& o) const;
+    // A hash that agrees with identical().
+    [[nodiscard]]
+    std::size_t hash() const;
+
     void operator|=(const ZoneDomain& right);
     ZoneDomain operator|(const ZoneDomain& right) const;
 
+    // Join of one or more domains. The common variables are computed once, and each block of related
+    // packs is joined in a single aligned graph.
+    static ZoneDomain join(std::span<const ZoneDomain* const> doms);
+
     [[nodiscard]]
     ZoneDomain widen(const ZoneDomain& o) const;
 
@@ -206,19 +262,29 @@ class ZoneDomain final {
     [[nodiscard]]
     std::pair<std::size_t, std::size_t> size() const;
 
-  private:
+    // return number of packs
     [[nodiscard]]
-    bool entail_aux(const LinearConstraint& cst) const {
-        // Full copy of *this is needed because add_constraint mutates the DBM.
-        // Potential optimization: a read-only constraint check on the graph
-        // (without closure) could avoid this copy, but would require a separate
-        // code path that reasons about feasibility without modifying edges.
-        return !ZoneDomain(*this).add_constraint(cst.negate());
+    std::size_t pack_count() const {
+        return partition_->packs.size();
     }
 
+    // Whether the graph of every pack is closed, as the queries that read it directly assume.
+    [[nodiscard]]
+    bool is_closed() const;
+
+  private:
+    // Whether this entails rhs, when that is decided from the graph alone.
+    [[nodiscard]]
+    std::optional<bool> entail_in_place(const LinearConstraint& rhs) const;
+
+    // For constraints that entail_in_place() does not decide. The copy shares its packs with
+    // *this; add_constraint only copies the packs it modifies.
+    [[nodiscard]]
+    bool entail_aux(const LinearConstraint& cst) const;
+
     [[nodiscard]]
     bool intersect_aux(const LinearConstraint& cst) const {
-        // Same copy overhead as entail_aux — see comment above.
+        // Same fallback as entail_aux.
         return ZoneDomain(*this).add_constraint(cst);
     }
 
@@ -231,25 +297,50 @@ class ZoneDomain final {
     [[nodiscard]]
     bool entail(const LinearConstraint& rhs) const;
 
+    // The index of the first of csts that is not entailed, if any, as if by calling entail() on each
+    // in order. The constraints decided from the graph are checked first, so no copy is made for
+    // the constraints after one of them that fails.
+    [[nodiscard]]
+    std::optional<std::size_t> first_not_entailed(std::span<const LinearConstraint> csts) const;
+
     /**
      * Checks logical implication between two constraints in the current abstract state.
      * Returns true if, for all states represented by this ZoneDomain, whenever 'premise' holds,
-     * 'conclusion' also holds. This is implemented by adding 'premise' to the current state:
+     * 'conclusion' also holds. This amounts to adding 'premise' to the current state:
      * - If 'premise' is inconsistent with the current state, implication holds vacuously (returns true).
      * - Otherwise, checks if 'conclusion' is entailed by the state with 'premise' added.
+     * When the premise is decided from the graph, or both constraints bound the same expression up to
+     * a constant, this is answered without adding the premise to a copy.
      */
     [[nodiscard]]
-    bool implies(const LinearConstraint& premise, const LinearConstraint& conclusion) const {
-        ZoneDomain result(*this);
-        return !result.add_constraint(premise) || result.entail(conclusion);
-    }
+    bool implies(const LinearConstraint& premise, const LinearConstraint& conclusion) const;
 
     friend std::ostream& operator<<(std::ostream& o, const ZoneDomain& dom);
     [[nodiscard]]
     StringInvariant to_set() const;
 
+    /// Every edge of the packs as a constraint, with none of the simplifications of to_set(): adding
+    /// them all to a top domain rebuilds this one.
+    [[nodiscard]]
+    std::vector<LinearConstraint> to_constraints() const;
+
   public:
     static void clear_thread_local_state();
+
+    /// While an instance is alive, the domains of the calling thread record no new relation between
+    /// variables: assignments and linear constraints only bound their variables, and joins do not
+    /// relate variables through their bounds, so packs stay single variables. This makes the
+    /// domain an interval domain, for the interval pre-pass (VerifierOptions::interval_pre_pass).
+    class IntervalsOnly final {
+        bool previous_;
+
+      public:
+        explicit IntervalsOnly(bool enable);
+        ~IntervalsOnly();
+
+        IntervalsOnly(const IntervalsOnly&) = delete;
+        IntervalsOnly& operator=(const IntervalsOnly&) = delete;
+    };
 }; // class ZoneDomain
 
 } // namespace prevail
@@ -0,0 +1,126 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#include <algorithm>
+#include <utility>
+
+#include "crab_utils/thread_pool.hpp"
+
+namespace prevail {
+
+namespace {
+// The pool and deque index of the worker running on this thread, if any.
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local size_t current_queue = 0;
+} // namespace
+
+ThreadPool::ThreadPool(const size_t num_threads) {
+    const size_t n = std::max<size_t>(num_threads, 1);
+    queues_.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    threads_.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        threads_.emplace_back([this, i] { worker_loop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock{state_mutex_};
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::default_concurrency() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+void ThreadPool::submit(Task task) {
+    {
+        // Push and count the task under the state lock: an idle worker never wakes to a non-zero
+        // `queued_` with every deque still empty, and a worker that takes the task right away
+        // decrements `queued_` only after this increment.
+        std::lock_guard lock{state_mutex_};
+        const size_t target = current_pool == this ? current_queue : next_queue_++ % queues_.size();
+        {
+            std::lock_guard queue_lock{queues_[target]->mutex};
+            queues_[target]->tasks.push_back(std::move(task));
+        }
+        ++queued_;
+        ++pending_;
+    }
+    work_available_.notify_one();
+}
+
+bool ThreadPool::try_take(const size_t index, Task& task) {
+    // Own deque first, newest task first; then steal the oldest task of the others.
+    const size_t n = queues_.size();
+    for (size_t k = 0; k < n && !task; ++k) {
+        WorkerQueue& queue = *queues_[(index + k) % n];
+        std::lock_guard lock{queue.mutex};
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (k == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task) {
+        return false;
+    }
+    std::lock_guard lock{state_mutex_};
+    --queued_;
+    return true;
+}
+
+void ThreadPool::finish_task(std::exception_ptr error) {
+    std::lock_guard lock{state_mutex_};
+    if (error && !first_error_) {
+        first_error_ = std::move(error);
+    }
+    if (--pending_ == 0) {
+        all_done_.notify_all();
+    }
+}
+
+void ThreadPool::worker_loop(const size_t index) {
+    current_pool = this;
+    current_queue = index;
+    while (true) {
+        Task task;
+        if (try_take(index, task)) {
+            std::exception_ptr error;
+            try {
+                task();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            // Destroy the task's captures before reporting completion to wait().
+            task = nullptr;
+            finish_task(std::move(error));
+            continue;
+        }
+        std::unique_lock lock{state_mutex_};
+        work_available_.wait(lock, [this] { return queued_ > 0 || stopping_; });
+        if (stopping_ && queued_ == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::wait() {
+    std::unique_lock lock{state_mutex_};
+    all_done_.wait(lock, [this] { return pending_ == 0; });
+    if (first_error_) {
+        std::rethrow_exception(std::exchange(first_error_, nullptr));
+    }
+}
+
+} // namespace prevail
@@ -0,0 +1,81 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace prevail {
+
+/// Fixed-size work-stealing thread pool.
+///
+/// Every worker owns a task deque. A task submitted from a worker goes to the back of that
+/// worker's deque and is popped LIFO, so dependent work stays on a warm cache; an idle worker
+/// steals FIFO from the front of the other deques. Tasks submitted from outside the pool are
+/// spread round-robin.
+///
+/// Tasks must not block on other tasks. The first exception escaping a task is captured and
+/// rethrown by wait(); the remaining tasks still run to completion.
+class ThreadPool final {
+  public:
+    using Task = std::function<void()>;
+
+    /// Start `num_threads` workers (at least one).
+    explicit ThreadPool(size_t num_threads);
+
+    /// Wait for the workers to drain every queued task, then join them.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    void submit(Task task);
+
+    /// Block until every submitted task, including those submitted by other tasks, has finished.
+    /// Rethrows the first exception thrown by a task since the previous wait(). Must not be
+    /// called from a task.
+    void wait();
+
+    [[nodiscard]]
+    size_t size() const {
+        return threads_.size();
+    }
+
+    /// Number of workers to use when the caller asks for "as many as the host has".
+    [[nodiscard]]
+    static size_t default_concurrency();
+
+  private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void worker_loop(size_t index);
+    bool try_take(size_t index, Task& task);
+    void finish_task(std::exception_ptr error);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    // Guards the counters below; `work_available_` and `all_done_` wait on it.
+    std::mutex state_mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable all_done_;
+    size_t queued_{};  // Tasks sitting in some deque.
+    size_t pending_{}; // Tasks submitted and not yet finished.
+    size_t next_queue_{};
+    bool stopping_{};
+    std::exception_ptr first_error_;
+};
+
+} // namespace prevail
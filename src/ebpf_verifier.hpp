@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include "batch_verify.hpp"
 #include "config.hpp"
 #include "io/elf_loader.hpp"
 #include "ir/program.hpp"
@@ -1,9 +1,24 @@
 // Copyright (c) Prevail Verifier contributors.
 // SPDX-License-Identifier: Apache-2.0
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <latch>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <ranges>
+#include <string>
 #include <utility>
 #include <variant>
+#include <vector>
+
+#include <gsl/narrow>
 
 #include "analysis_context.hpp"
 #include "cfg/cfg.hpp"
@@ -11,7 +26,12 @@
 #include "config.hpp"
 #include "crab/ebpf_domain.hpp"
 #include "crab/extrapolator.hpp"
+#include "crab/state_memo.hpp"
+#include "crab/var_registry.hpp"
+#include "crab_utils/thread_pool.hpp"
+#include "ir/liveness.hpp"
 #include "ir/program.hpp"
+#include "iteration_engine.hpp"
 #include "result.hpp"
 #include "verifier.hpp"
 
@@ -21,74 +41,867 @@ namespace prevail {
 // operations. Call between analyses to keep peak memory down.
 void ebpf_verifier_clear_thread_local_state() { ZoneDomain::clear_thread_local_state(); }
 
+namespace {
+/// Thrown by set_error under VerifierOptions::stop_on_first_error, and when the analysis exceeds
+/// one of its VerifierOptions::limits, to unwind the WTO traversal.
+struct AnalysisStopped {};
+} // namespace
+
 class InterleavedFwdFixpointIterator final {
     const AnalysisContext& context;
     const Program& _prog;
     const Cfg& _cfg;
     const Wto _wto;
     AnalysisResult& result;
+    /// Number of threads of the parallel engine and of the deferred checks (VerifierOptions::analysis_threads).
+    const size_t _threads;
+    /// Cache of joins, widenings and inclusion checks (VerifierOptions::memoize_lattice_operations).
+    std::unique_ptr<StateMemo> _memo;
     Extrapolator _extrapolator;
 
     /// Used to skip the analysis until _entry is found
     bool _skip{true};
 
+    /// Number of labels with an error; atomic because the parallel engine reports errors from
+    /// several threads. A rejected warm-start candidate withdraws the errors it caused.
+    std::atomic<size_t> _error_count{0};
+
+    /// Set once an error (VerifierOptions::stop_on_first_error) or a limit stops the analysis, so
+    /// that the parallel engine skips the components it has not started and unwinds the others.
+    std::atomic<bool> _stopped{false};
+
+    /// What VerifierOptions::limits bounds: the start of the analysis, and the transfer functions
+    /// applied so far, in total and by LabelId. One budget is shared by all the passes of an
+    /// analysis (interval_pre_pass, lazy_narrowing), so the limits apply to the analysis as a whole.
+    /// A label is transformed by one thread at a time, so its own count needs no synchronization.
+    struct Budget {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::atomic<uint64_t> steps{0};
+        std::vector<uint64_t> steps_at;
+    };
+    Budget& _budget;
+
+    /// Visits the top-level components of the WTO, sequentially or in parallel.
+    ComponentScheduler _scheduler;
+
+    /// Worklist engine only (VerifierOptions::incremental_loops): whether the post-state of a parent
+    /// may have changed since the label was last visited, and whether it was ever transformed. The
+    /// parallel engine marks labels of a component from the threads running its dependencies, so
+    /// the marks are atomic; a label is only visited by one thread at a time.
+    std::vector<std::atomic<bool>> _dirty;
+    std::vector<uint8_t> _transformed;
+
+    /// The first limit exceeded; later ones, from other threads of the parallel engine, are ignored.
+    std::optional<AnalysisInterruption> _interruption;
+    std::mutex _interruption_mutex;
+
+    /// VerifierOptions::defer_loop_checks only: whether each label, by LabelId, is in a top-level
+    /// cycle of the WTO, and so is checked once that cycle has stabilized. Cleared for the labels of
+    /// a cycle that is iterated again with its checks (see operator() on a cycle).
+    std::vector<uint8_t> _deferred_check;
+
+    /// VerifierOptions::defer_loop_checks with several analysis threads: the workers that check
+    /// the labels of a stabilized cycle, separate from the engine's pool, whose tasks wait for
+    /// them. Each worker keeps its own SplitDBM scratch space, released when the pool is.
+    std::unique_ptr<ThreadPool> _check_pool;
+    static constexpr size_t labels_per_check_task = 64;
+
+    /// VerifierOptions::lazy_narrowing only: whether the cycle headed by each label, by LabelId, runs
+    /// its descending sequence. Empty if every cycle does.
+    std::vector<uint8_t> _narrow_at;
+
+    /// check_certificate() only: the certified pre-state of each loop head, by LabelId (null if the
+    /// certificate has none, i.e., the head is unreachable). Empty otherwise.
+    std::vector<const EbpfDomain*> _certified;
+
+    /// VerifierOptions::emit_certificate only: whether each label, by LabelId, is a loop head, whose
+    /// pre-state verdict mode keeps for the certificate.
+    std::vector<uint8_t> _certificate_head;
+
+    /// Warm-start candidates for the heads of outermost cycles, indexed by LabelId (null if none).
+    std::vector<const EbpfDomain*> _warm_start;
+    std::atomic<int> _warm_started_loops{0};
+
+    /// Verdict mode only: the labels whose states each top-level component reads, and for each
+    /// label the number of top-level components that have yet to finish reading them.
+    std::vector<std::vector<LabelId>> _reads_of_component;
+    std::vector<std::atomic<uint32_t>> _pending_readers;
+
+    static constexpr size_t no_region = std::numeric_limits<size_t>::max();
+
+    /// Summary mode only: the labels cloned under the stack frame prefix of one CallLocal, i.e.
+    /// one inlined call, and the WTO components that analyzing the call visits. Components of
+    /// calls nested in it belong to the nested call, which the visit of its CallLocal analyzes.
+    struct CallRegion {
+        LabelId call{};
+        const CallLocal* instruction{};
+        std::vector<LabelId> labels;             ///< In LabelId order, nested calls included.
+        std::vector<std::string> frame_suffixes; ///< Frame prefixes in the region, minus the call's.
+        std::vector<const CycleOrLabel*> components;
+    };
+    std::vector<CallRegion> _regions;
+    std::vector<size_t> _region_of_call; ///< By LabelId of a CallLocal.
+    std::vector<size_t> _region_of;      ///< By LabelId: innermost call region holding the label.
+
+    /// The per-label results of one analyzed call, by position in CallRegion::labels, with the
+    /// frame variables named after `prefix`. Calls of the same subprogram clone the same labels
+    /// in the same order, so positions match across them.
+    struct CallSummary {
+        std::string prefix;
+        EbpfDomain input;
+        EbpfDomain observed_input; ///< `input` without the registers saved by the callers.
+        std::vector<InvariantMapPair> invariants;
+        bool checked{}; ///< Whether the labels were checked, i.e., whether `invariants` hold their errors.
+        bool has_errors{};
+    };
+    std::map<Label, std::vector<std::shared_ptr<const CallSummary>>> _summaries; ///< By callee.
+    std::mutex _summaries_mutex;
+    std::atomic<int> _reused_call_summaries{0};
+
+    /// Verdict mode only: largest loop-count bound among the post-states released so far.
+    ExtendedNumber _released_loop_count{0};
+    std::mutex _released_loop_count_mutex;
+
+    [[nodiscard]]
+    bool has_error(const LabelId node) const {
+        return result.invariants[node].error.has_value();
+    }
+
+    void set_error(const LabelId node, VerificationError&& error) {
+        _error_count.fetch_add(1, std::memory_order_relaxed);
+        result.invariants[node].error = std::move(error);
+        if (context.options.stop_on_first_error) {
+            _stopped.store(true, std::memory_order_relaxed);
+            throw AnalysisStopped{};
+        }
+    }
+
+    [[noreturn]]
+    void interrupt(const InterruptionReason reason, const LabelId node) {
+        {
+            const std::lock_guard lock{_interruption_mutex};
+            if (!_interruption) {
+                // Another thread may not have given back a step it was refused yet.
+                const uint64_t max_steps = context.options.limits.max_steps;
+                const uint64_t steps = _budget.steps.load(std::memory_order_relaxed);
+                _interruption = AnalysisInterruption{
+                    .reason = reason,
+                    .steps = max_steps != 0 ? std::min(steps, max_steps) : steps,
+                    .elapsed = std::chrono::steady_clock::now() - _budget.start,
+                    .where = _cfg.label_of(node),
+                };
+            }
+        }
+        _stopped.store(true, std::memory_order_relaxed);
+        throw AnalysisStopped{};
+    }
+
+    /// Count one transfer function at `node` against VerifierOptions::limits, or stop the analysis
+    /// if it is over one of them.
+    void charge_step(const LabelId node) {
+        const AnalysisLimits& limits = context.options.limits;
+        if (_stopped.load(std::memory_order_relaxed)) {
+            throw AnalysisStopped{};
+        }
+        if (limits.cancellation.cancelled()) {
+            interrupt(InterruptionReason::cancelled, node);
+        }
+        if (limits.time_limit.count() != 0 &&
+            std::chrono::steady_clock::now() - _budget.start >= limits.time_limit) {
+            interrupt(InterruptionReason::deadline, node);
+        }
+        // Take the step first, so that concurrent threads cannot all pass a check of the same count.
+        if (const uint64_t spent = _budget.steps.fetch_add(1, std::memory_order_relaxed);
+            limits.max_steps != 0 && spent >= limits.max_steps) {
+            _budget.steps.fetch_sub(1, std::memory_order_relaxed);
+            interrupt(InterruptionReason::step_budget, node);
+        }
+        ++_budget.steps_at[node];
+    }
+
+    /// The interruption, if any, with the steps spent in each top-level WTO component.
     [[nodiscard]]
-    bool has_error(const Label& node) const {
-        return result.invariants.at(node).error.has_value();
+    std::optional<AnalysisInterruption> interruption_report() const {
+        if (!_interruption) {
+            return {};
+        }
+        AnalysisInterruption report = *_interruption;
+        for (const auto& component : _wto) {
+            uint64_t steps = 0;
+            for_each_component_label(component, [&](const Label& label) { steps += _budget.steps_at[_cfg.id_of(label)]; });
+            if (const auto pcycle = std::get_if<std::shared_ptr<WtoCycle>>(&component)) {
+                if (steps != 0) {
+                    report.steps_by_loop.emplace_back((*pcycle)->head(), steps);
+                }
+            } else {
+                report.steps_outside_loops += steps;
+            }
+        }
+        std::ranges::stable_sort(report.steps_by_loop, std::greater{}, &std::pair<Label, uint64_t>::second);
+        return report;
+    }
+
+    void clear_error(const LabelId node) {
+        _error_count.fetch_sub(1, std::memory_order_relaxed);
+        result.invariants[node].error.reset();
+        // The error was found under the pre-state stored at `node`, so it must be checked again
+        // even if that pre-state comes back unchanged.
+        if (!_dirty.empty()) {
+            _transformed[node] = false;
+            _dirty[node].store(true, std::memory_order_relaxed);
+        }
     }
 
-    void set_error(const Label& node, VerificationError&& error) {
-        result.failed = true;
-        result.invariants.at(node).error = std::move(error);
+    void mark_children_dirty(const LabelId node) {
+        if (_dirty.empty()) {
+            return;
+        }
+        for (const LabelId child : _cfg.children_of(node)) {
+            _dirty[child].store(true, std::memory_order_relaxed);
+        }
     }
 
-    void set_pre(const Label& label, EbpfDomain&& v) { result.invariants.at(label).pre = std::move(v); }
-    void set_pre(const Label& label, const EbpfDomain& v) { result.invariants.at(label).pre = v; }
+    [[nodiscard]]
+    bool failed() const {
+        return _error_count.load(std::memory_order_relaxed) > 0;
+    }
+
+    void set_pre(const LabelId label, EbpfDomain&& v) { result.invariants[label].pre = std::move(v); }
+    void set_pre(const LabelId label, const EbpfDomain& v) { result.invariants[label].pre = v; }
 
     [[nodiscard]]
-    const EbpfDomain& get_pre(const Label& node) const {
-        return result.invariants.at(node).pre;
+    const EbpfDomain& get_pre(const LabelId node) const {
+        return result.invariants[node].pre;
     }
 
     [[nodiscard]]
-    const EbpfDomain& get_post(const Label& node) const {
-        return result.invariants.at(node).post;
+    const EbpfDomain& get_post(const LabelId node) const {
+        return result.invariants[node].post;
     }
 
-    void transform_to_post(const Label& label, EbpfDomain pre) {
-        const auto& ins = _prog.instruction_at(label);
+    void transform_to_post(const LabelId id, EbpfDomain pre) {
+        charge_step(id);
+        const auto& ins = _prog.instruction_at(id);
 
         if (context.options.verbosity_opts.collect_instruction_deps) {
-            result.invariants.at(label).deps = extract_instruction_deps(ins, pre, context.runtime().total_stack_size());
+            result.invariants[id].deps = extract_instruction_deps(ins, pre, context.runtime().total_stack_size());
         }
 
         if (!std::holds_alternative<IncrementLoopCounter>(ins)) {
-            if (has_error(label)) {
+            if (has_error(id)) {
                 return;
             }
-            for (const auto& assertion : _prog.assertions_at(label)) {
-                if (auto error = ebpf_domain_check(pre, assertion, label, context)) {
-                    set_error(label, std::move(*error));
+            if (!checks_deferred(id)) {
+                if (auto error = check_assertions(id, pre)) {
+                    set_error(id, std::move(*error));
                     return;
                 }
             }
         }
         ebpf_domain_transform(pre, ins, context);
 
-        result.invariants.at(label).post = std::move(pre);
+        result.invariants[id].post = std::move(pre);
+    }
+
+    /// The first assertion of `id` that does not hold in `pre`.
+    [[nodiscard]]
+    std::optional<VerificationError> check_assertions(const LabelId id, const EbpfDomain& pre) const {
+        for (const auto& assertion : _prog.assertions_at(id)) {
+            if (auto error = ebpf_domain_check(pre, assertion, _cfg.label_of(id), context)) {
+                return error;
+            }
+        }
+        return {};
+    }
+
+    [[nodiscard]]
+    bool checks_deferred(const LabelId id) const {
+        return !_deferred_check.empty() && _deferred_check[id];
+    }
+
+    /// VerifierOptions::defer_loop_checks: whether the labels of a top-level cycle that has just
+    /// stabilized pass their checks. Both the ascending and the descending sequence return the head
+    /// pre-state their last iteration ran from, so every pre-state in the cycle is final and only
+    /// read from here on. With a check pool, ranges of labels are checked concurrently. Cycles in
+    /// independent components stabilize concurrently and share the pool, so each call waits on a
+    /// latch for its own tasks only, and rethrows the first exception of these.
+    [[nodiscard]]
+    bool stabilized_checks_pass(const std::shared_ptr<WtoCycle>& cycle) {
+        std::vector<LabelId> ids;
+        for_each_component_label(cycle, [&](const Label& label) {
+            const LabelId id = _cfg.id_of(label);
+            if (!has_error(id) && !std::holds_alternative<IncrementLoopCounter>(_prog.instruction_at(id))) {
+                ids.push_back(id);
+            }
+        });
+        std::atomic<bool> pass{true};
+        const auto check_range = [&](const size_t begin, const size_t end) {
+            for (size_t i = begin; i < end && pass.load(std::memory_order_relaxed); ++i) {
+                if (check_assertions(ids[i], get_pre(ids[i]))) {
+                    pass.store(false, std::memory_order_relaxed);
+                }
+            }
+        };
+        if (!_check_pool || ids.size() < 2 * labels_per_check_task) {
+            check_range(0, ids.size());
+        } else {
+            VariableRegistry& registry = variable_registry;
+            const VariableRegistrySharing sharing{registry};
+            const size_t tasks = (ids.size() + labels_per_check_task - 1) / labels_per_check_task;
+            std::latch done{gsl::narrow<std::ptrdiff_t>(tasks)};
+            std::mutex error_mutex;
+            std::exception_ptr error;
+            for (size_t begin = 0; begin < ids.size(); begin += labels_per_check_task) {
+                const size_t end = std::min(begin + labels_per_check_task, ids.size());
+                _check_pool->submit([&, begin, end] {
+                    try {
+                        const VariableRegistryBinding binding{registry};
+                        const ZoneDomain::IntervalsOnly scope{result.tier == AnalysisTier::intervals};
+                        check_range(begin, end);
+                    } catch (...) {
+                        pass.store(false, std::memory_order_relaxed);
+                        const std::lock_guard lock{error_mutex};
+                        if (!error) {
+                            error = std::current_exception();
+                        }
+                    }
+                    done.count_down();
+                });
+            }
+            done.wait();
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        return pass.load(std::memory_order_relaxed);
+    }
+
+    /// Check the labels of `cycle` when they are transformed from now on, and have them transformed
+    /// again, dropping the errors raised so far.
+    void check_eagerly(const std::shared_ptr<WtoCycle>& cycle) {
+        for_each_component_label(cycle, [&](const Label& label) {
+            const LabelId id = _cfg.id_of(label);
+            _deferred_check[id] = false;
+            if (has_error(id)) {
+                clear_error(id);
+            }
+            if (!_dirty.empty()) {
+                _transformed[id] = false;
+                _dirty[id].store(true, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    [[nodiscard]]
+    EbpfDomain join(const std::span<const EbpfDomain* const> doms) const {
+        return _memo ? _memo->join(doms) : EbpfDomain::join(doms);
     }
 
-    EbpfDomain join_all_prevs(const Label& node) const {
-        if (node == _cfg.entry_label()) {
+    [[nodiscard]]
+    bool leq(const EbpfDomain& left, const EbpfDomain& right) const {
+        return _memo ? _memo->leq(left, right) : left <= right;
+    }
+
+    EbpfDomain join_all_prevs(const LabelId node) const {
+        if (node == _cfg.entry_id()) {
             return get_pre(node);
         }
-        EbpfDomain res = EbpfDomain::bottom();
-        for (const Label& prev : _cfg.parents_of(node)) {
-            res |= get_post(prev);
+        std::vector<const EbpfDomain*> posts;
+        for (const LabelId prev : _cfg.parents_of(node)) {
+            posts.push_back(&get_post(prev));
+        }
+        EbpfDomain res = join(posts);
+        if (_cfg.parents_of(node).size() > 1) {
+            forget_dead(node, res);
+        }
+        return res;
+    }
+
+    /// VerifierOptions::forget_dead_variables: drop the registers and stack slots that are dead at
+    /// the start of `node`, so that joins and widenings there do not carry them along.
+    void forget_dead(const LabelId node, EbpfDomain& inv) const {
+        const Liveness* liveness = _prog.liveness();
+        if (!liveness || inv.is_bottom()) {
+            return;
+        }
+        for (uint8_t r = R0_RETURN_VALUE; r < R10_STACK_POINTER; ++r) {
+            if (!liveness->is_live(node, Reg{r})) {
+                inv.havoc_register(Reg{r});
+            }
+        }
+        const size_t slots = liveness->slot_count();
+        for (size_t slot = 0; slot < slots;) {
+            if (liveness->is_live_slot(node, slot)) {
+                ++slot;
+                continue;
+            }
+            size_t end = slot + 1;
+            while (end < slots && !liveness->is_live_slot(node, end)) {
+                ++end;
+            }
+            inv.havoc_stack(gsl::narrow<int64_t>(slot) * Liveness::SLOT_SIZE,
+                            gsl::narrow<int64_t>(end - slot) * Liveness::SLOT_SIZE, context.runtime().big_endian);
+            slot = end;
+        }
+    }
+
+    // A label's post-state is read only when one of its CFG children is analyzed, and once a
+    // top-level WTO component has stabilized none of its labels is visited again. So both states
+    // of a label are dead once its own top-level component and those of its children have finished.
+    void plan_releases() {
+        _reads_of_component.assign(_scheduler.size(), {});
+        _pending_readers = std::vector<std::atomic<uint32_t>>(_cfg.size());
+        std::vector<size_t> readers;
+        for (LabelId id = 0; id < _cfg.size(); ++id) {
+            if (_scheduler.component_of(id) == ComponentScheduler::unreached) {
+                continue;
+            }
+            readers.assign(1, _scheduler.component_of(id));
+            for (const LabelId child : _cfg.children_of(id)) {
+                readers.push_back(_scheduler.component_of(child));
+            }
+            std::ranges::sort(readers);
+            const auto duplicates = std::ranges::unique(readers);
+            readers.erase(duplicates.begin(), duplicates.end());
+            _pending_readers[id].store(gsl::narrow<uint32_t>(readers.size()), std::memory_order_relaxed);
+            for (const size_t reader : readers) {
+                _reads_of_component[reader].push_back(id);
+            }
+        }
+    }
+
+    // Drop the states nobody reads anymore, except what the result is still reported from: the exit
+    // post-state (exit_value), the entry pre-state, loop-counter pre-states (find_termination_errors),
+    // the pre-states of labels with an error (find_first_error) or of an Assume that made the code
+    // unreachable (find_unreachable), and loop-head pre-states for a certificate.
+    void release_states(const LabelId id) {
+        InvariantMapPair& inv = result.invariants[id];
+        if (context.runtime().check_for_termination) {
+            const ExtendedNumber bound = inv.post.get_loop_count_upper_bound(_extrapolator.loop_counters());
+            std::lock_guard lock{_released_loop_count_mutex};
+            _released_loop_count = std::max(_released_loop_count, bound);
+        }
+        if (inv.error) {
+            return;
+        }
+        const auto& ins = _prog.instruction_at(id);
+        const bool keep_pre = id == _cfg.entry_id() || std::holds_alternative<IncrementLoopCounter>(ins) ||
+                              (std::holds_alternative<Assume>(ins) && inv.post.is_bottom()) ||
+                              (!_certificate_head.empty() && _certificate_head[id]);
+        if (!keep_pre) {
+            inv.pre = EbpfDomain::bottom();
+        }
+        if (id != _cfg.exit_id()) {
+            inv.post = EbpfDomain::bottom();
+        }
+    }
+
+    void component_finished(const size_t index) {
+        if (context.options.retain_invariants) {
+            return;
+        }
+        for (const LabelId id : _reads_of_component[index]) {
+            if (_pending_readers[id].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                release_states(id);
+            }
+        }
+    }
+
+    void index_call_regions() {
+        std::map<std::string, size_t> region_of_prefix;
+        _region_of_call.assign(_cfg.size(), no_region);
+        for (LabelId id = 0; id < _cfg.size(); ++id) {
+            if (const auto pcall = std::get_if<CallLocal>(&_prog.instruction_at(id))) {
+                region_of_prefix.emplace(pcall->stack_frame_prefix, _regions.size());
+                _region_of_call[id] = _regions.size();
+                _regions.push_back(CallRegion{.call = id, .instruction = pcall});
+            }
+        }
+        // A CallLocal sorts before the labels cloned under its prefix, so its own region is known
+        // by the time they are reached.
+        _region_of.assign(_cfg.size(), no_region);
+        for (LabelId id = 0; id < _cfg.size(); ++id) {
+            const auto it = region_of_prefix.find(_cfg.label_of(id).stack_frame_prefix);
+            if (it == region_of_prefix.end()) {
+                continue;
+            }
+            _region_of[id] = it->second;
+            for (size_t r = it->second; r != no_region; r = _region_of[_regions[r].call]) {
+                _regions[r].labels.push_back(id);
+            }
+        }
+        for (CallRegion& region : _regions) {
+            const std::string& prefix = region.instruction->stack_frame_prefix;
+            region.frame_suffixes.emplace_back();
+            for (const LabelId id : region.labels) {
+                if (const auto pcall = std::get_if<CallLocal>(&_prog.instruction_at(id))) {
+                    region.frame_suffixes.push_back(pcall->stack_frame_prefix.substr(prefix.size()));
+                }
+            }
+        }
+
+        // Assign every WTO component to the call that analyzes it, in WTO order.
+        std::vector<std::pair<const CycleOrLabel*, size_t>> work;
+        const auto push_reversed = [&](const auto& components, const size_t enclosing) {
+            const size_t first = work.size();
+            for (const auto& component : components) {
+                work.emplace_back(&component, enclosing);
+            }
+            std::reverse(work.begin() + gsl::narrow<std::ptrdiff_t>(first), work.end());
+        };
+        push_reversed(_wto, no_region);
+        while (!work.empty()) {
+            const auto [component, enclosing] = work.back();
+            work.pop_back();
+            const size_t region = region_of(*component);
+            if (region != enclosing) {
+                _regions[region].components.push_back(component);
+            }
+            if (const auto pcycle = std::get_if<std::shared_ptr<WtoCycle>>(component)) {
+                push_reversed(**pcycle, region);
+            }
+        }
+    }
+
+    [[nodiscard]]
+    size_t region_of(const CycleOrLabel& component) const {
+        if (_region_of.empty()) {
+            return no_region;
+        }
+        const auto pcycle = std::get_if<std::shared_ptr<WtoCycle>>(&component);
+        return _region_of[_cfg.id_of(pcycle ? (*pcycle)->head() : std::get<Label>(component))];
+    }
+
+    /// Summary mode: whether `component` is analyzed by a call inside `enclosing` (no_region
+    /// for the program itself) rather than by whoever visits `enclosing`.
+    [[nodiscard]]
+    bool analyzed_by_call(const CycleOrLabel& component, const size_t enclosing) const {
+        return region_of(component) != enclosing;
+    }
+
+    [[nodiscard]]
+    static std::vector<std::pair<Variable, Variable>> frame_renaming(const CallRegion& region, const std::string& from,
+                                                                     const std::string& to) {
+        std::vector<std::pair<Variable, Variable>> renaming;
+        for (const std::string& suffix : region.frame_suffixes) {
+            for (const uint8_t r : {R6, R7, R8, R9}) {
+                for (const DataKind kind : iterate_kinds(KIND_MIN, KIND_MAX)) {
+                    renaming.emplace_back(variable_registry.stack_frame_var(kind, r, from + suffix),
+                                          variable_registry.stack_frame_var(kind, r, to + suffix));
+                }
+            }
         }
+        return renaming;
+    }
+
+    [[nodiscard]]
+    static Label relabel(const Label& label, const std::string& from, const std::string& to) {
+        Label res = label;
+        res.stack_frame_prefix = to + label.stack_frame_prefix.substr(from.size());
         return res;
     }
 
+    /// The registers saved by the call with stack frame `prefix` and by every call enclosing it.
+    /// A callee only passes them through: the nested frames aside, its labels never read them,
+    /// except for its Exit, which restores its own.
+    [[nodiscard]]
+    static std::vector<Variable> saved_by_callers(const std::string& prefix) {
+        std::vector<Variable> vars;
+        for (size_t end = prefix.find(STACK_FRAME_DELIMITER);; end = prefix.find(STACK_FRAME_DELIMITER, end + 1)) {
+            const std::string frame = prefix.substr(0, end);
+            for (const uint8_t r : {R6, R7, R8, R9}) {
+                for (const DataKind kind : iterate_kinds(KIND_MIN, KIND_MAX)) {
+                    vars.push_back(variable_registry.stack_frame_var(kind, r, frame));
+                }
+            }
+            if (end == std::string::npos) {
+                return vars;
+            }
+        }
+    }
+
+    /// What the callee of the call with stack frame `prefix` can observe of `dom`. The stack is
+    /// kept whole, since the callee can reach the frames of its callers through pointers.
+    [[nodiscard]]
+    static EbpfDomain observed_by_callee(EbpfDomain dom, const std::string& prefix) {
+        dom.forget(saved_by_callers(prefix));
+        return dom;
+    }
+
+    /// What the callee of `region` can neither observe nor change of `dom`, i.e., the registers
+    /// saved by its callers, which hold throughout the call.
+    [[nodiscard]]
+    EbpfDomain kept_from_callee(EbpfDomain dom, const CallRegion& region) const {
+        for (uint8_t r = R0_RETURN_VALUE; r <= R10_STACK_POINTER; ++r) {
+            dom.havoc_register(Reg{r});
+        }
+        dom.havoc_stack(0, gsl::narrow<int64_t>(context.runtime().total_stack_size()), false);
+        std::vector<Variable> vars{variable_registry.packet_size(), variable_registry.meta_offset()};
+        for (const std::string& suffix : region.frame_suffixes | std::views::drop(1)) {
+            for (const uint8_t r : {R6, R7, R8, R9}) {
+                for (const DataKind kind : iterate_kinds(KIND_MIN, KIND_MAX)) {
+                    vars.push_back(variable_registry.stack_frame_var(
+                        kind, r, region.instruction->stack_frame_prefix + suffix));
+                }
+            }
+        }
+        dom.forget(vars);
+        return dom;
+    }
+
+    // Look for an earlier call of the same subprogram whose results hold for `input`, and copy
+    // them into this call's labels. A call whose input equals `input` once both are named after
+    // the same frame is copied as is. Otherwise, the inputs are compared on what the callee
+    // observes, and a summary whose observed input covers this one is rebuilt from that part of
+    // its results and from what the call keeps of `input`. The results of a larger input may
+    // hold errors that `input` would not raise, so such a summary is reused only when error-free.
+    bool reuse_summary(const CallRegion& region, const EbpfDomain& input) {
+        std::vector<std::shared_ptr<const CallSummary>> candidates;
+        {
+            std::lock_guard lock{_summaries_mutex};
+            if (const auto it = _summaries.find(region.instruction->target); it != _summaries.end()) {
+                candidates = it->second;
+            }
+        }
+        const std::string& prefix = region.instruction->stack_frame_prefix;
+        const bool checked = !checks_deferred(region.call);
+        const EbpfDomain observed = observed_by_callee(input, prefix);
+        const CallSummary* covering = nullptr;
+        for (const auto& summary : candidates) {
+            if (summary->invariants.size() != region.labels.size() || summary->checked != checked) {
+                continue;
+            }
+            const auto renaming = frame_renaming(region, prefix, summary->prefix);
+            EbpfDomain renamed = input;
+            renamed.rename(renaming);
+            if (renamed <= summary->input && summary->input <= renamed) {
+                copy_summary(region, *summary, nullptr);
+                return true;
+            }
+            if (covering != nullptr) {
+                continue;
+            }
+            EbpfDomain renamed_observed = observed;
+            renamed_observed.rename(renaming);
+            if (renamed_observed <= summary->observed_input &&
+                (!summary->has_errors || summary->observed_input <= renamed_observed)) {
+                covering = summary.get();
+            }
+        }
+        if (covering == nullptr) {
+            return false;
+        }
+        const EbpfDomain kept = kept_from_callee(input, region);
+        copy_summary(region, *covering, &kept);
+        return true;
+    }
+
+    /// Copy the results of `summary` into the labels of `region`. With `kept`, they are rebuilt
+    /// as the meet of what the callee observes of them and of `kept`, and the Exit of the callee
+    /// restores the registers of `kept`.
+    void copy_summary(const CallRegion& region, const CallSummary& summary, const EbpfDomain* kept) {
+        const std::string& prefix = region.instruction->stack_frame_prefix;
+        const auto renaming = frame_renaming(region, summary.prefix, prefix);
+        const auto rebuild = [&](EbpfDomain& dom) {
+            if (kept != nullptr) {
+                dom = observed_by_callee(std::move(dom), summary.prefix);
+            }
+            dom.rename(renaming);
+            if (kept != nullptr) {
+                dom = dom & *kept;
+            }
+        };
+        for (size_t i = 0; i < region.labels.size(); ++i) {
+            const LabelId id = region.labels[i];
+            InvariantMapPair inv = summary.invariants[i];
+            rebuild(inv.pre);
+            const Instruction& ins = _prog.instruction_at(id);
+            const bool restores_kept = kept != nullptr && !inv.error && std::holds_alternative<Exit>(ins) &&
+                                       _cfg.label_of(id).stack_frame_prefix == prefix;
+            if (restores_kept) {
+                inv.post = inv.pre;
+                ebpf_domain_transform(inv.post, ins, context);
+            } else {
+                rebuild(inv.post);
+            }
+            std::optional<VerificationError> error = std::move(inv.error);
+            result.invariants[id] = std::move(inv);
+            if (!_dirty.empty()) {
+                _transformed[id] = true;
+                mark_children_dirty(id);
+            }
+            if (error) {
+                if (error->where) {
+                    error->where = relabel(*error->where, summary.prefix, prefix);
+                }
+                set_error(id, std::move(*error));
+            }
+        }
+        _reused_call_summaries.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void store_summary(const CallRegion& region, EbpfDomain input) {
+        auto summary = std::make_shared<CallSummary>();
+        summary->prefix = region.instruction->stack_frame_prefix;
+        summary->observed_input = observed_by_callee(input, summary->prefix);
+        summary->input = std::move(input);
+        summary->checked = !checks_deferred(region.call);
+        summary->invariants.reserve(region.labels.size());
+        for (const LabelId id : region.labels) {
+            summary->invariants.push_back(result.invariants[id]);
+            summary->has_errors |= has_error(id);
+        }
+        std::lock_guard lock{_summaries_mutex};
+        _summaries[region.instruction->target].push_back(std::move(summary));
+    }
+
+    // Summary mode: analyze the inlined call made by `call`, whose post-state was just computed.
+    // Its labels are only reachable through `call`, so their states are a function of that input.
+    // Errors are sticky across visits, though: once a label of the call has one (e.g., from an
+    // earlier iteration of an enclosing loop), the results no longer depend on the input alone
+    // and the call is analyzed without the cache.
+    void analyze_call(const LabelId call) {
+        if (_region_of_call.empty() || _region_of_call[call] == no_region) {
+            return;
+        }
+        const CallRegion& region = _regions[_region_of_call[call]];
+        const bool cacheable = std::ranges::none_of(region.labels, [&](const LabelId id) { return has_error(id); });
+        const EbpfDomain& input = get_post(call);
+        if (cacheable && reuse_summary(region, input)) {
+            return;
+        }
+        EbpfDomain saved_input = cacheable ? input : EbpfDomain::bottom();
+        for (const CycleOrLabel* component : region.components) {
+            std::visit(*this, *component);
+        }
+        if (cacheable) {
+            store_summary(region, std::move(saved_input));
+        }
+    }
+
+    void match_warm_start(const LoopHeadInvariants& warm_start) {
+        _warm_start.assign(_cfg.size(), nullptr);
+        for (const auto& component : _wto) {
+            if (const auto pcycle = std::get_if<std::shared_ptr<WtoCycle>>(&component)) {
+                const auto it = warm_start.find(loop_structure_hash(_prog, **pcycle));
+                if (it != warm_start.end()) {
+                    _warm_start[_cfg.id_of((*pcycle)->head())] = &it->second;
+                }
+            }
+        }
+    }
+
+    // Seed an outermost cycle with a candidate invariant from an earlier analysis. The candidate
+    // is accepted only if one pass over the cycle shows it inductive without raising new errors.
+    // `propagate` joins every predecessor of the head, including the edges entering the cycle, so
+    // inductiveness also implies that the candidate covers the entry state;
+    // narrowing then proceeds from it as after the widening phase. Otherwise the errors found
+    // under the candidate are withdrawn (the cold iteration will find the real ones again) and
+    // the caller falls back to the full fixpoint computation.
+    std::optional<EbpfDomain> try_warm_start(const WtoCycle& cycle, const EbpfDomain& candidate,
+                                             const Extrapolator::Step& propagate) {
+        std::vector<LabelId> clean;
+        for (const auto& component : cycle) {
+            for_each_component_label(component, [&](const Label& label) {
+                if (const LabelId id = _cfg.id_of(label); !has_error(id)) {
+                    clean.push_back(id);
+                }
+            });
+        }
+        EbpfDomain next = propagate(candidate);
+        bool new_errors = false;
+        for (const LabelId id : clean) {
+            if (has_error(id)) {
+                clear_error(id);
+                new_errors = true;
+            }
+        }
+        if (new_errors || !(next <= candidate)) {
+            return std::nullopt;
+        }
+        if (!narrows(_cfg.id_of(cycle.head()))) {
+            // The state the last pass ran from, as Extrapolator::ascend returns.
+            return candidate;
+        }
+        return _extrapolator.refine(std::move(next), propagate);
+    }
+
+    // check_certificate(): one pass over the cycle from the certified head pre-state, which must
+    // contain the state entering the cycle and the one its body brings back to the head. Otherwise
+    // the head is in error, and the pass goes on from the join of all three, so that the error is
+    // reported at a reachable state.
+    EbpfDomain check_certified(const LabelId head, const EbpfDomain& entering, const Extrapolator::Step& propagate) {
+        EbpfDomain certified = _certified[head] ? *_certified[head] : EbpfDomain::bottom();
+        EbpfDomain next = propagate(certified);
+        if (leq(entering, certified) && leq(next, certified)) {
+            return certified;
+        }
+        if (!has_error(head)) {
+            VerificationError error{"Loop invariant of the certificate is not inductive"};
+            error.where = _cfg.label_of(head);
+            set_error(head, std::move(error));
+        }
+        return certified | entering | next;
+    }
+
+    [[nodiscard]]
+    InvariantCertificate certificate() const {
+        InvariantCertificate res{.program_hash = certificate_hash(context)};
+        _wto.for_each_loop_head([&](const Label& head) {
+            if (const EbpfDomain& pre = get_pre(_cfg.id_of(head)); !pre.is_bottom()) {
+                res.loop_heads.insert_or_assign(head, pre);
+            }
+        });
+        return res;
+    }
+
+    // Visit a top-level component of the WTO, unless a call analyzes it, and release the states
+    // it was the last to read.
+    void visit_component(const size_t index) {
+        const CycleOrLabel& component = _scheduler.component(index);
+        if (!analyzed_by_call(component, no_region)) {
+            std::visit(*this, component);
+        }
+        component_finished(index);
+    }
+
+    void visit_components() {
+        const auto visit = [this](const size_t index) { visit_component(index); };
+        if (_threads > 1) {
+            _scheduler.run_parallel(_threads, visit, _stopped, result.tier == AnalysisTier::intervals);
+        } else {
+            _scheduler.run_sequential(visit);
+        }
+    }
+
+    [[nodiscard]]
+    bool narrows(const LabelId head) const {
+        return _narrow_at.empty() || _narrow_at[head];
+    }
+
+    // The labels from which some label with an error in `result` can be reached.
+    static std::vector<uint8_t> labels_reaching_errors(const Cfg& cfg, const AnalysisResult& result) {
+        std::vector<uint8_t> reaches(cfg.size(), false);
+        std::vector<LabelId> worklist;
+        for (LabelId id = 0; id < cfg.size(); ++id) {
+            if (result.invariants[id].error) {
+                reaches[id] = true;
+                worklist.push_back(id);
+            }
+        }
+        while (!worklist.empty()) {
+            const LabelId id = worklist.back();
+            worklist.pop_back();
+            for (const LabelId parent : cfg.parents_of(id)) {
+                if (!reaches[parent]) {
+                    reaches[parent] = true;
+                    worklist.push_back(parent);
+                }
+            }
+        }
+        return reaches;
+    }
+
     static std::vector<Variable> collect_loop_counters(const Wto& wto, bool check_for_termination) {
         std::vector<Variable> counters;
         if (check_for_termination) {
@@ -98,41 +911,72 @@ class InterleavedFwdFixpointIterator final {
         return counters;
     }
 
-    explicit InterleavedFwdFixpointIterator(const AnalysisContext& context, AnalysisResult& result)
+    [[nodiscard]]
+    static size_t thread_count(const VerifierOptions& options) {
+        return options.analysis_threads == 0 ? ThreadPool::default_concurrency() : options.analysis_threads;
+    }
+
+    InterleavedFwdFixpointIterator(const AnalysisContext& context, AnalysisResult& result, Budget& budget)
         : context(context), _prog(context.program), _cfg(context.program.cfg()), _wto(context.program.cfg()),
-          result(result), _extrapolator(context, collect_loop_counters(_wto, context.runtime().check_for_termination)) {
-        for (const auto& label : _cfg.labels()) {
-            result.invariants.emplace(label, InvariantMapPair{EbpfDomain::bottom(), {}, EbpfDomain::bottom()});
+          result(result), _threads(thread_count(context.options)),
+          _memo(context.options.memoize_lattice_operations ? std::make_unique<StateMemo>() : nullptr),
+          _extrapolator(context, collect_loop_counters(_wto, context.runtime().check_for_termination), _memo.get()),
+          _budget(budget), _scheduler(_cfg, _wto) {
+        result.invariants =
+            InvariantTable{_cfg.label_index(), InvariantMapPair{EbpfDomain::bottom(), {}, EbpfDomain::bottom()}};
+        _budget.steps_at.resize(_cfg.size());
+        if (context.options.incremental_loops) {
+            _dirty = std::vector<std::atomic<bool>>(_cfg.size());
+            for (auto& dirty : _dirty) {
+                dirty.store(true, std::memory_order_relaxed);
+            }
+            _transformed.assign(_cfg.size(), false);
+        }
+        if (!context.options.retain_invariants) {
+            plan_releases();
+        }
+        if (context.options.summarize_local_calls && !context.runtime().check_for_termination) {
+            index_call_regions();
+        }
+        if (context.options.defer_loop_checks) {
+            _deferred_check.assign(_cfg.size(), false);
+            for (const auto& component : _wto) {
+                if (std::holds_alternative<std::shared_ptr<WtoCycle>>(component)) {
+                    for_each_component_label(component,
+                                             [&](const Label& label) { _deferred_check[_cfg.id_of(label)] = true; });
+                }
+            }
         }
     }
 
     [[nodiscard]]
-    static std::optional<VerificationError> check_loop_bound(const Program& prog, const Label& label,
+    static std::optional<VerificationError> check_loop_bound(const Program& prog, const LabelId id,
                                                              const EbpfDomain& pre, const AnalysisContext& context) {
-        if (std::holds_alternative<IncrementLoopCounter>(prog.instruction_at(label))) {
-            const auto assertions = prog.assertions_at(label);
+        if (std::holds_alternative<IncrementLoopCounter>(prog.instruction_at(id))) {
+            const auto& assertions = prog.assertions_at(id);
             if (assertions.size() != 1) {
                 CRAB_ERROR("Expected exactly 1 assertion for IncrementLoopCounter");
             }
-            return ebpf_domain_check(pre, assertions.front(), label, context);
+            return ebpf_domain_check(pre, assertions.front(), prog.cfg().label_of(id), context);
         }
         return {};
     }
 
     void find_termination_errors(const Program& prog) {
-        for (const auto& [label, inv_pair] : result.invariants) {
-            if (inv_pair.pre.is_bottom()) {
+        for (LabelId id = 0; id < result.invariants.size(); ++id) {
+            const EbpfDomain& pre = result.invariants[id].pre;
+            if (pre.is_bottom()) {
                 continue;
             }
-            if (auto error = check_loop_bound(prog, label, inv_pair.pre, context)) {
-                set_error(label, std::move(*error));
+            if (auto error = check_loop_bound(prog, id, pre, context)) {
+                set_error(id, std::move(*error));
             }
         }
     }
 
     int max_loop_count() const {
-        ExtendedNumber loop_count{0};
-        for (const auto& inv_pair : std::views::values(result.invariants)) {
+        ExtendedNumber loop_count = _released_loop_count;
+        for (const auto& inv_pair : result.invariants.values()) {
             loop_count = std::max(loop_count, inv_pair.post.get_loop_count_upper_bound(_extrapolator.loop_counters()));
         }
         const auto m = loop_count.number();
@@ -142,12 +986,28 @@ class InterleavedFwdFixpointIterator final {
         return std::numeric_limits<int>::max();
     }
 
+    // Iterate `cycle` to its fixpoint and store the pre-state of its head. Returns whether the
+    // fixpoint was reached from a warm-start candidate.
+    bool stabilize(const std::shared_ptr<WtoCycle>& cycle, bool entry_in_this_cycle);
+
   public:
     void operator()(const Label& node);
 
     void operator()(const std::shared_ptr<WtoCycle>& cycle);
 
-    static AnalysisResult run(const AnalysisContext& context, EbpfDomain entry_inv);
+    static AnalysisResult run(const AnalysisContext& context, EbpfDomain entry_inv,
+                              const LoopHeadInvariants* warm_start = nullptr);
+
+    static AnalysisResult check(const AnalysisContext& context, EbpfDomain entry_inv,
+                                const InvariantCertificate& certificate);
+
+  private:
+    static AnalysisResult run_tier(const AnalysisContext& context, Budget& budget, EbpfDomain entry_inv,
+                                   const LoopHeadInvariants* warm_start, AnalysisTier tier);
+
+    static AnalysisResult run_pass(const AnalysisContext& context, Budget& budget, EbpfDomain entry_inv,
+                                   const LoopHeadInvariants* warm_start, AnalysisTier tier,
+                                   std::vector<uint8_t> narrow_at, const InvariantCertificate* certificate = nullptr);
 };
 
 AnalysisResult analyze(const Program& prog, const VerifierOptions& options) {
@@ -164,6 +1024,18 @@ AnalysisResult analyze(const EbpfDomain& entry_invariant, const AnalysisContext&
     return InterleavedFwdFixpointIterator::run(context, entry_invariant);
 }
 
+AnalysisResult analyze(const AnalysisContext& context, const LoopHeadInvariants& warm_start) {
+    const auto* ctx = context.program_info().type.ctx_descriptor;
+    const bool init_r1 = ctx != nullptr && ctx->size > 0;
+    return InterleavedFwdFixpointIterator::run(context, EbpfDomain::setup_entry(init_r1, context), &warm_start);
+}
+
+AnalysisResult check_certificate(const AnalysisContext& context, const InvariantCertificate& certificate) {
+    const auto* ctx = context.program_info().type.ctx_descriptor;
+    const bool init_r1 = ctx != nullptr && ctx->size > 0;
+    return InterleavedFwdFixpointIterator::check(context, EbpfDomain::setup_entry(init_r1, context), certificate);
+}
+
 void InterleavedFwdFixpointIterator::operator()(const Label& node) {
     if (_skip && node == _cfg.entry_label()) {
         _skip = false;
@@ -172,15 +1044,32 @@ void InterleavedFwdFixpointIterator::operator()(const Label& node) {
         return;
     }
 
-    EbpfDomain pre = join_all_prevs(node);
+    const LabelId id = _cfg.id_of(node);
+    if (!_dirty.empty()) {
+        // Worklist engine: a label none of whose parents changed keeps its states, and so does one
+        // whose parents changed without changing their join.
+        if (!_dirty[id].exchange(false, std::memory_order_relaxed)) {
+            return;
+        }
+        EbpfDomain pre = join_all_prevs(id);
+        if (_transformed[id] && leq(pre, get_pre(id)) && leq(get_pre(id), pre)) {
+            return;
+        }
+        _transformed[id] = true;
+        set_pre(id, pre);
+        transform_to_post(id, std::move(pre));
+        mark_children_dirty(id);
+        analyze_call(id);
+        return;
+    }
+    EbpfDomain pre = join_all_prevs(id);
 
-    set_pre(node, pre);
-    transform_to_post(node, std::move(pre));
+    set_pre(id, pre);
+    transform_to_post(id, std::move(pre));
+    analyze_call(id);
 }
 
 void InterleavedFwdFixpointIterator::operator()(const std::shared_ptr<WtoCycle>& cycle) {
-    const Label head = cycle->head();
-
     bool entry_in_this_cycle = false;
     if (_skip) {
         entry_in_this_cycle = is_component_member(_cfg.entry_label(), cycle);
@@ -190,54 +1079,180 @@ void InterleavedFwdFixpointIterator::operator()(const std::shared_ptr<WtoCycle>&
         }
     }
 
+    // With deferred checks, a failing assertion does not stop the state during the iteration, so
+    // the states after it in the cycle, and those leaving it, may not be reachable. When the checks
+    // of the stabilized cycle fail, it is iterated again with its checks, as without deferral.
+    const bool deferred = checks_deferred(_cfg.id_of(cycle->head())) &&
+                          _wto.nesting(cycle->head()).outermost_head() == std::nullopt;
+    bool warm_started = stabilize(cycle, entry_in_this_cycle);
+    if (deferred && !stabilized_checks_pass(cycle)) {
+        check_eagerly(cycle);
+        warm_started = stabilize(cycle, entry_in_this_cycle);
+    }
+    if (warm_started) {
+        _warm_started_loops.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool InterleavedFwdFixpointIterator::stabilize(const std::shared_ptr<WtoCycle>& cycle, const bool entry_in_this_cycle) {
+    const Label head = cycle->head();
+    const LabelId head_id = _cfg.id_of(head);
+
     const auto initial_head_state = [&]() -> EbpfDomain {
         if (entry_in_this_cycle) {
-            return get_pre(_cfg.entry_label());
+            return get_pre(_cfg.entry_id());
         }
         const WtoNesting cycle_nesting = _wto.nesting(head);
-        EbpfDomain inv = EbpfDomain::bottom();
-        for (const Label& prev : _cfg.parents_of(head)) {
-            if (!(_wto.nesting(prev) > cycle_nesting)) {
-                inv |= get_post(prev);
+        std::vector<const EbpfDomain*> entering;
+        for (const LabelId prev : _cfg.parents_of(head_id)) {
+            if (!(_wto.nesting(_cfg.label_of(prev)) > cycle_nesting)) {
+                entering.push_back(&get_post(prev));
             }
         }
+        EbpfDomain inv = join(entering);
+        forget_dead(head_id, inv);
         return inv;
     };
 
-    const Extrapolator::Step propagate = [this, &head, &cycle](const EbpfDomain& invariant) {
-        set_pre(head, invariant);
-        transform_to_post(head, invariant);
+    const size_t region = _region_of.empty() ? no_region : _region_of[head_id];
+    const Extrapolator::Step propagate = [this, &head, head_id, &cycle, region](const EbpfDomain& invariant) {
+        // Only the final head pre-state (stored below) is ever read back, so verdict mode skips the copy.
+        if (context.options.retain_invariants) {
+            set_pre(head_id, invariant);
+        }
+        transform_to_post(head_id, invariant);
+        mark_children_dirty(head_id);
+        analyze_call(head_id);
         for (const auto& component : *cycle) {
             const auto plabel = std::get_if<Label>(&component);
-            if (!plabel || *plabel != head) {
+            if ((!plabel || *plabel != head) && !analyzed_by_call(component, region)) {
                 std::visit(*this, component);
             }
         }
-        return join_all_prevs(head);
+        return join_all_prevs(head_id);
     };
 
-    set_pre(head, _extrapolator.compute_fixpoint(initial_head_state(), propagate));
+    std::optional<EbpfDomain> invariant;
+    bool warm_started = false;
+    if (!_certified.empty()) {
+        invariant = check_certified(head_id, initial_head_state(), propagate);
+    } else if (!_warm_start.empty() && _warm_start[head_id] && !entry_in_this_cycle) {
+        invariant = try_warm_start(*cycle, *_warm_start[head_id], propagate);
+        warm_started = invariant.has_value();
+    }
+    if (!invariant) {
+        invariant = narrows(head_id) ? _extrapolator.compute_fixpoint(initial_head_state(), propagate)
+                                     : _extrapolator.ascend(initial_head_state(), propagate);
+    }
+    set_pre(head_id, std::move(*invariant));
+    return warm_started;
 }
 
-AnalysisResult InterleavedFwdFixpointIterator::run(const AnalysisContext& context, EbpfDomain entry_inv) {
+// With VerifierOptions::interval_pre_pass, the program is first analyzed with intervals only. A
+// pass, or a run stopped by one of the limits (which apply to the whole analysis), decides the
+// result; an error may be a false alarm, and the program is analyzed again with zones.
+AnalysisResult InterleavedFwdFixpointIterator::run(const AnalysisContext& context, EbpfDomain entry_inv,
+                                                   const LoopHeadInvariants* warm_start) {
+    Budget budget;
+    if (context.options.interval_pre_pass) {
+        AnalysisResult result = run_tier(context, budget, entry_inv, warm_start, AnalysisTier::intervals);
+        if (!result.failed || result.interruption) {
+            return result;
+        }
+    }
+    return run_tier(context, budget, std::move(entry_inv), warm_start, AnalysisTier::zones);
+}
+
+// With VerifierOptions::lazy_narrowing, the first pass stops every cycle at the post-fixpoint of its
+// ascending sequence. If that proves the program safe, narrowing would only have added precision
+// nobody needs. Otherwise the program is analyzed again, and only the cycles from which an error of
+// the first pass is reachable are narrowed: the others cannot have caused it.
+AnalysisResult InterleavedFwdFixpointIterator::run_tier(const AnalysisContext& context, Budget& budget,
+                                                        EbpfDomain entry_inv, const LoopHeadInvariants* warm_start,
+                                                        const AnalysisTier tier) {
+    if (!context.options.lazy_narrowing) {
+        return run_pass(context, budget, std::move(entry_inv), warm_start, tier, {});
+    }
+    const Cfg& cfg = context.program.cfg();
+    AnalysisResult result =
+        run_pass(context, budget, entry_inv, warm_start, tier, std::vector<uint8_t>(cfg.size(), false));
+    if (!result.failed || result.interruption) {
+        return result;
+    }
+    return run_pass(context, budget, std::move(entry_inv), warm_start, tier, labels_reaching_errors(cfg, result));
+}
+
+// A certificate is checked with zones, whichever tier computed it: a state of the interval tier is
+// also a state of the zone domain, only with fewer relations.
+AnalysisResult InterleavedFwdFixpointIterator::check(const AnalysisContext& context, EbpfDomain entry_inv,
+                                                     const InvariantCertificate& certificate) {
+    Budget budget;
+    return run_pass(context, budget, std::move(entry_inv), nullptr, AnalysisTier::zones, {}, &certificate);
+}
+
+AnalysisResult InterleavedFwdFixpointIterator::run_pass(const AnalysisContext& context, Budget& budget,
+                                                        EbpfDomain entry_inv, const LoopHeadInvariants* warm_start,
+                                                        const AnalysisTier tier, std::vector<uint8_t> narrow_at,
+                                                        const InvariantCertificate* certificate) {
     const Program& prog = context.program;
     AnalysisResult result;
-    InterleavedFwdFixpointIterator analyzer(context, result);
+    result.tier = tier;
+    const ZoneDomain::IntervalsOnly scope{tier == AnalysisTier::intervals};
+    InterleavedFwdFixpointIterator analyzer(context, result, budget);
+    analyzer._narrow_at = std::move(narrow_at);
+    if (warm_start && !warm_start->empty() && !context.options.stop_on_first_error) {
+        analyzer.match_warm_start(*warm_start);
+    }
     if (context.runtime().check_for_termination) {
         analyzer._wto.for_each_loop_head(
             [&](const Label& label) { ebpf_domain_initialize_loop_counter(entry_inv, label, context); });
     }
-    analyzer.set_pre(prog.cfg().entry_label(), std::move(entry_inv));
-    for (const auto& component : analyzer._wto) {
-        std::visit(analyzer, component);
+    analyzer.set_pre(prog.cfg().entry_id(), std::move(entry_inv));
+    const bool certificate_matches = !certificate || certificate->program_hash == certificate_hash(context);
+    if (certificate && certificate_matches) {
+        analyzer._certified.assign(prog.cfg().size(), nullptr);
+        for (const auto& [head, inv] : certificate->loop_heads) {
+            analyzer._certified[prog.cfg().id_of(head)] = &inv;
+        }
+    }
+    if (context.options.emit_certificate && !certificate) {
+        analyzer._certificate_head.assign(prog.cfg().size(), false);
+        analyzer._wto.for_each_loop_head(
+            [&](const Label& head) { analyzer._certificate_head[prog.cfg().id_of(head)] = true; });
+    }
+    if (analyzer._threads > 1 && context.options.defer_loop_checks) {
+        analyzer._check_pool = std::make_unique<ThreadPool>(analyzer._threads);
     }
-    if (!result.failed && context.runtime().check_for_termination) {
-        analyzer.find_termination_errors(prog);
-        if (!result.failed) {
-            result.max_loop_count = analyzer.max_loop_count();
+    try {
+        if (!certificate_matches) {
+            VerificationError error{"Certificate was computed for another program or configuration"};
+            error.where = prog.cfg().entry_label();
+            analyzer.set_error(prog.cfg().entry_id(), std::move(error));
+        } else {
+            analyzer.visit_components();
         }
+        if (!analyzer.failed() && context.runtime().check_for_termination) {
+            analyzer.find_termination_errors(prog);
+            if (!analyzer.failed()) {
+                result.max_loop_count = analyzer.max_loop_count();
+            }
+        }
+    } catch (const AnalysisStopped&) {
+        result.partial = true;
+        result.interruption = analyzer.interruption_report();
+    }
+    result.failed = result.partial || analyzer.failed();
+    result.warm_started_loops = analyzer._warm_started_loops;
+    result.reused_call_summaries = analyzer._reused_call_summaries;
+    result.steps = budget.steps;
+    result.memo_hits = analyzer._memo ? analyzer._memo->hits() : 0;
+    if (result.partial) {
+        return result;
+    }
+    result.exit_value = analyzer.get_post(prog.cfg().exit_id()).get_r0();
+    if (!analyzer._certificate_head.empty() && !result.failed) {
+        result.certificate = analyzer.certificate();
     }
-    result.exit_value = analyzer.get_post(Label::exit).get_r0();
     return result;
 }
 
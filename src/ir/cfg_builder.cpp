@@ -4,7 +4,9 @@
 #include <cassert>
 #include <limits>
 #include <map>
+#include <memory>
 #include <optional>
+#include <ranges>
 #include <set>
 #include <string>
 #include <vector>
@@ -13,6 +15,7 @@
 #include "cfg/wto.hpp"
 #include "config.hpp"
 #include "ir/call_resolver.hpp"
+#include "ir/liveness.hpp"
 #include "ir/program.hpp"
 #include "ir/syntax.hpp"
 #include "platform.hpp"
@@ -30,18 +33,80 @@ struct CallbackMetadata {
 };
 
 struct CfgBuilder final {
+    // A node of the graph under construction. The graph is mutated freely while the
+    // passes run and frozen into the dense, LabelId-indexed Program by finalize().
+    struct Node {
+        std::set<Label> parents;
+        std::set<Label> children;
+        Instruction ins;
+        std::vector<Assertion> assertions;
+    };
+
+    std::map<Label, Node> nodes{{Label::entry, Node{.ins = Undefined{}}}, {Label::exit, Node{.ins = Undefined{}}}};
     Program prog;
 
+    [[nodiscard]]
+    Node& get_node(const Label& label) {
+        const auto it = nodes.find(label);
+        if (it == nodes.end()) {
+            CRAB_ERROR("Label ", to_string(label), " not found in the CFG: ");
+        }
+        return it->second;
+    }
+
+    [[nodiscard]]
+    const Node& get_node(const Label& label) const {
+        const auto it = nodes.find(label);
+        if (it == nodes.end()) {
+            CRAB_ERROR("Label ", to_string(label), " not found in the CFG: ");
+        }
+        return it->second;
+    }
+
+    [[nodiscard]]
+    bool contains(const Label& label) const {
+        return nodes.contains(label);
+    }
+
+    [[nodiscard]]
+    auto labels() const {
+        return std::views::keys(nodes);
+    }
+
+    [[nodiscard]]
+    const std::set<Label>& children_of(const Label& label) const {
+        return get_node(label).children;
+    }
+
+    [[nodiscard]]
+    Label get_child(const Label& label) const {
+        const auto& children = children_of(label);
+        if (children.size() != 1) {
+            CRAB_ERROR("Label ", to_string(label), " does not have a single child");
+        }
+        return *children.begin();
+    }
+
+    [[nodiscard]]
+    Instruction& instruction_at(const Label& label) {
+        return get_node(label).ins;
+    }
+
+    [[nodiscard]]
+    const Instruction& instruction_at(const Label& label) const {
+        return get_node(label).ins;
+    }
+
     // TODO: ins should be inserted elsewhere
     void insert_after(const Label& prev_label, const Label& new_label, const Instruction& ins) {
         if (prev_label == new_label) {
             CRAB_ERROR("Cannot insert after the same label ", to_string(new_label));
         }
         std::set<Label> prev_children;
-        std::swap(prev_children, prog.m_cfg.get_node(prev_label).children);
+        std::swap(prev_children, get_node(prev_label).children);
 
         for (const Label& next_label : prev_children) {
-            prog.m_cfg.get_node(next_label).parents.erase(prev_label);
+            get_node(next_label).parents.erase(prev_label);
         }
 
         insert(new_label, ins);
@@ -53,17 +118,16 @@ struct CfgBuilder final {
 
     // TODO: ins should be inserted elsewhere
     void insert(const Label& _label, const Instruction& ins) {
-        if (const auto it = prog.m_cfg.neighbours.find(_label); it != prog.m_cfg.neighbours.end()) {
+        if (const auto it = nodes.find(_label); it != nodes.end()) {
             CRAB_ERROR("Label ", to_string(_label), " already exists");
         }
-        prog.m_cfg.neighbours.emplace(_label, Cfg::Adjacent{});
-        prog.m_instructions.emplace(_label, ins);
+        nodes.emplace(_label, Node{.ins = ins});
     }
 
     // TODO: ins should be inserted elsewhere
     Label insert_jump(const Label& from, const Label& to, const Instruction& ins) {
         const Label jump_label = Label::make_jump(from, to);
-        if (prog.m_cfg.contains(jump_label)) {
+        if (contains(jump_label)) {
             CRAB_ERROR("Jump label ", to_string(jump_label), " already exists");
         }
         insert(jump_label, ins);
@@ -75,28 +139,72 @@ struct CfgBuilder final {
     void add_child(const Label& a, const Label& b) {
         assert(b != Label::entry);
         assert(a != Label::exit);
-        prog.m_cfg.neighbours.at(a).children.insert(b);
-        prog.m_cfg.neighbours.at(b).parents.insert(a);
+        nodes.at(a).children.insert(b);
+        nodes.at(b).parents.insert(a);
     }
 
     void remove_child(const Label& a, const Label& b) {
-        prog.m_cfg.get_node(a).children.erase(b);
-        prog.m_cfg.get_node(b).parents.erase(a);
+        get_node(a).children.erase(b);
+        get_node(b).parents.erase(a);
     }
 
     void set_assertions(const Label& label, const std::vector<Assertion>& assertions) {
-        if (!prog.m_cfg.contains(label)) {
-            CRAB_ERROR("Label ", to_string(label), " not found in the CFG: ");
-        }
-        prog.m_assertions.insert_or_assign(label, assertions);
+        get_node(label).assertions = assertions;
     }
 
     void set_callback_metadata(CallbackMetadata md) {
         prog.m_callback_target_labels = std::move(md.target_labels);
         prog.m_callback_targets_with_exit = std::move(md.targets_with_exit);
     }
+
+    // Intern every label to its dense id and lay the adjacency out in flat vectors.
+    [[nodiscard]]
+    Cfg freeze_cfg() const {
+        Cfg cfg;
+        std::vector<Label> sorted_labels;
+        sorted_labels.reserve(nodes.size());
+        for (const Label& label : labels()) {
+            sorted_labels.push_back(label);
+        }
+        cfg.m_index = std::make_shared<const LabelIndex>(std::move(sorted_labels));
+        cfg.m_nodes.clear();
+        cfg.m_nodes.reserve(nodes.size());
+        for (const Node& node : std::views::values(nodes)) {
+            Cfg::Adjacent& adjacent = cfg.m_nodes.emplace_back();
+            adjacent.parents.reserve(node.parents.size());
+            for (const Label& parent : node.parents) {
+                adjacent.parents.push_back(cfg.id_of(parent));
+            }
+            adjacent.children.reserve(node.children.size());
+            for (const Label& child : node.children) {
+                adjacent.children.push_back(cfg.id_of(child));
+            }
+        }
+        cfg.m_entry = cfg.id_of(Label::entry);
+        cfg.m_exit = cfg.id_of(Label::exit);
+        return cfg;
+    }
+
+    // Hand off the finished graph as a Program whose per-label data is indexed by LabelId.
+    [[nodiscard]]
+    Program finalize() && {
+        prog.m_cfg = freeze_cfg();
+        prog.m_instructions.clear();
+        prog.m_instructions.reserve(nodes.size());
+        prog.m_assertions.clear();
+        prog.m_assertions.reserve(nodes.size());
+        for (Node& node : std::views::values(nodes)) {
+            prog.m_instructions.push_back(std::move(node.ins));
+            prog.m_assertions.push_back(std::move(node.assertions));
+        }
+        return std::move(prog);
+    }
 };
 
+Cfg::Cfg()
+    : m_index{std::make_shared<const LabelIndex>(std::vector{Label::entry, Label::exit})}, m_nodes(2), m_entry{0},
+      m_exit{1} {}
+
 /// Get the inverse of a given comparison operation.
 static Condition::Op reverse(const Condition::Op op) {
     switch (op) {
@@ -347,13 +455,13 @@ static void add_cfg_nodes(CfgBuilder& builder, const Label& caller_label, const
     bool first = true;
 
     // Get the label of the node to go to on returning from the macro.
-    Label exit_to_label = builder.prog.cfg().get_child(caller_label);
+    Label exit_to_label = builder.get_child(caller_label);
 
     // Construct the variable prefix to use for the new stack frame
     // and store a copy in the CallLocal instruction since the instruction-specific
     // labels may only exist until the CFG is simplified.
     const std::string stack_frame_prefix = to_string(caller_label);
-    if (const auto pcall = std::get_if<CallLocal>(&builder.prog.instruction_at(caller_label))) {
+    if (const auto pcall = std::get_if<CallLocal>(&builder.instruction_at(caller_label))) {
         pcall->stack_frame_prefix = stack_frame_prefix;
     }
 
@@ -371,7 +479,7 @@ static void add_cfg_nodes(CfgBuilder& builder, const Label& caller_label, const
 
         // Clone the macro block into a new block with the new stack frame prefix.
         const Label label{macro_label.from, macro_label.to, stack_frame_prefix};
-        auto inst = builder.prog.instruction_at(macro_label);
+        auto inst = builder.instruction_at(macro_label);
         if (const auto pexit = std::get_if<Exit>(&inst)) {
             pexit->stack_frame_prefix = label.stack_frame_prefix;
         }
@@ -384,8 +492,8 @@ static void add_cfg_nodes(CfgBuilder& builder, const Label& caller_label, const
         }
 
         // Walk all successor nodes, enqueuing any not-yet-cloned macro block.
-        for (const auto& next_macro_label : builder.prog.cfg().children_of(macro_label)) {
-            if (next_macro_label != builder.prog.cfg().exit_label() && !seen_labels.contains(next_macro_label)) {
+        for (const auto& next_macro_label : builder.children_of(macro_label)) {
+            if (next_macro_label != Label::exit && !seen_labels.contains(next_macro_label)) {
                 macro_labels.insert(next_macro_label);
                 seen_labels.insert(next_macro_label);
             }
@@ -400,8 +508,8 @@ static void add_cfg_nodes(CfgBuilder& builder, const Label& caller_label, const
     // insertion, missing a pointer that walks out of bounds across iterations (#1203).
     for (const Label& macro_label : seen_labels) {
         const Label label{macro_label.from, macro_label.to, stack_frame_prefix};
-        for (const auto& next_macro_label : builder.prog.cfg().children_of(macro_label)) {
-            if (next_macro_label == builder.prog.cfg().exit_label()) {
+        for (const auto& next_macro_label : builder.children_of(macro_label)) {
+            if (next_macro_label == Label::exit) {
                 // This is an exit transition, so add an edge to the block to execute
                 // upon returning from the macro.
                 builder.add_child(label, exit_to_label);
@@ -419,7 +527,7 @@ static void add_cfg_nodes(CfgBuilder& builder, const Label& caller_label, const
     // Finally, recurse to replace any nested function macros.
     for (const auto& macro_label : seen_labels) {
         const Label label{macro_label.from, macro_label.to, caller_label_str};
-        if (const auto pins = std::get_if<CallLocal>(&builder.prog.instruction_at(label))) {
+        if (const auto pins = std::get_if<CallLocal>(&builder.instruction_at(label))) {
             add_cfg_nodes(builder, label, pins->target, max_call_stack_frames);
         }
     }
@@ -539,8 +647,8 @@ static void pass_connect_edges(CfgBuilder& builder, const InstructionSeq& insts,
     // Ordering check: pass_populate_nodes must run first so that every non-Undefined label
     // referenced below (the entry's target, jump targets, fallthrough labels) already exists.
     assert(std::holds_alternative<Undefined>(std::get<1>(insts[0])) ||
-           builder.prog.cfg().contains(std::get<0>(insts[0])));
-    builder.add_child(builder.prog.cfg().entry_label(), std::get<0>(insts[0]));
+           builder.contains(std::get<0>(insts[0])));
+    builder.add_child(Label::entry, std::get<0>(insts[0]));
 
     for (size_t i = 0; i < insts.size(); i++) {
         const auto& [label, inst, _0] = insts[i];
@@ -548,7 +656,7 @@ static void pass_connect_edges(CfgBuilder& builder, const InstructionSeq& insts,
         if (std::holds_alternative<Undefined>(inst)) {
             continue;
         }
-        Label fallthrough{builder.prog.cfg().exit_label()};
+        Label fallthrough{Label::exit};
         if (i + 1 < insts.size()) {
             fallthrough = std::get<0>(insts[i + 1]);
         } else {
@@ -563,7 +671,7 @@ static void pass_connect_edges(CfgBuilder& builder, const InstructionSeq& insts,
                     builder.add_child(label, fallthrough);
                     continue;
                 }
-                if (!builder.prog.cfg().contains(target_label)) {
+                if (!builder.contains(target_label)) {
                     throw InvalidControlFlow{"jump to undefined label " + to_string(target_label)};
                 }
                 builder.insert_jump(label, target_label, Assume{.cond = *cond, .is_implicit = true});
@@ -577,7 +685,7 @@ static void pass_connect_edges(CfgBuilder& builder, const InstructionSeq& insts,
             }
         }
         if (std::holds_alternative<Exit>(inst)) {
-            builder.add_child(label, builder.prog.cfg().exit_label());
+            builder.add_child(label, Label::exit);
         }
     }
 }
@@ -593,7 +701,7 @@ static void pass_connect_edges(CfgBuilder& builder, const InstructionSeq& insts,
 static void pass_inline_local_calls(CfgBuilder& builder, const InstructionSeq& insts, const int max_call_stack_frames) {
     // Ordering check: pass_connect_edges must have run. When insts is non-empty, its first
     // label has been wired as a child of Label::entry, so entry has at least one successor.
-    assert(insts.empty() || !builder.prog.cfg().children_of(Label::entry).empty());
+    assert(insts.empty() || !builder.children_of(Label::entry).empty());
     for (const auto& [label, inst, _] : insts) {
         if (const auto pins = std::get_if<CallLocal>(&inst)) {
             add_cfg_nodes(builder, label, pins->target, max_call_stack_frames);
@@ -626,39 +734,21 @@ static bool is_tail_call_site(const Instruction& ins, const ebpf_platform_t& pla
     return false;
 }
 
-static void collect_wto_labels(const CycleOrLabel& component, std::set<Label>& labels) {
-    // Iterative (explicit work-stack) rather than recursive on cycle-nesting depth.
-    // This runs unconditionally for every program via pass_validate_tail_call_depth,
-    // so a crafted deeply-nested CFG must not be able to overflow the C++ stack here.
-    std::vector<const CycleOrLabel*> stack{&component};
-    while (!stack.empty()) {
-        const CycleOrLabel* const current = stack.back();
-        stack.pop_back();
-        if (const auto plabel = std::get_if<Label>(current)) {
-            labels.insert(*plabel);
-            continue;
-        }
-        for (const auto& nested_component : *std::get<std::shared_ptr<WtoCycle>>(*current)) {
-            stack.push_back(&nested_component);
-        }
-    }
-}
-
 // Pass: ValidateTailCallDepth
-// Reads    : Program (CFG + instructions), Wto, platform, program type.
+// Reads    : CfgBuilder (graph + instructions), Wto, platform, program type.
 // Writes   : nothing.
 // Throws   : InvalidControlFlow if the reachable tail-call chain exceeds the fixed limit.
 // Notes    : Counts tail-call sites along the longest path through the reachable maximal-SCC DAG
 //            so cycles do not inflate depth. Maximal SCCs are derived from WTO nesting: labels in
 //            the same outermost WTO cycle are mutually reachable and form one maximal SCC.
-static void pass_validate_tail_call_depth(const Program& prog, const Wto& wto, const ebpf_platform_t& platform,
+static void pass_validate_tail_call_depth(const CfgBuilder& builder, const Wto& wto, const ebpf_platform_t& platform,
                                           const EbpfProgramType& program_type) {
     constexpr int tail_call_chain_limit = 33;
 
     // WTO only covers labels reachable from entry.
     std::set<Label> reachable;
     for (const auto& component : wto) {
-        collect_wto_labels(component, reachable);
+        for_each_component_label(component, [&](const Label& label) { reachable.insert(label); });
     }
 
     // Partition reachable labels by maximal SCC representative:
@@ -684,14 +774,14 @@ static void pass_validate_tail_call_depth(const Program& prog, const Wto& wto, c
 
     for (const auto& label : reachable) {
         const Label src_scc = maximal_scc_of.at(label);
-        if (is_tail_call_site(prog.instruction_at(label), platform, program_type)) {
+        if (is_tail_call_site(builder.instruction_at(label), platform, program_type)) {
             ++tail_sites_per_scc.at(src_scc);
             auto& representative = representative_tail_label.at(src_scc);
             if (!representative.has_value()) {
                 representative = label;
             }
         }
-        for (const auto& child : prog.cfg().children_of(label)) {
+        for (const auto& child : builder.children_of(label)) {
             if (!reachable.contains(child)) {
                 continue;
             }
@@ -759,20 +849,19 @@ static void pass_validate_tail_call_depth(const Program& prog, const Wto& wto, c
 }
 
 // Pass: ComputeCallbackMetadata
-// Reads    : Program (CFG + instructions).
+// Reads    : CfgBuilder (graph + instructions).
 // Writes   : builder.prog's callback metadata, via CfgBuilder::set_callback_metadata: the set
 //            of top-level concrete-instruction labels eligible as PTR_TO_FUNC targets, and the
 //            subset whose body can reach a top-level Exit.
 // Notes    : Excludes Label::entry/Label::exit, synthetic jump labels, labels under an inlined
 //            stack-frame prefix, and Exit instructions themselves.
 static void pass_compute_callback_metadata(CfgBuilder& builder) {
-    const Program& prog = builder.prog;
     CallbackMetadata md;
-    for (const Label& label : prog.labels()) {
+    for (const Label& label : builder.labels()) {
         if (label == Label::entry || label == Label::exit || label.isjump() || !label.stack_frame_prefix.empty()) {
             continue;
         }
-        if (std::holds_alternative<Exit>(prog.instruction_at(label))) {
+        if (std::holds_alternative<Exit>(builder.instruction_at(label))) {
             continue;
         }
         md.target_labels.insert(label.from);
@@ -791,11 +880,11 @@ static void pass_compute_callback_metadata(CfgBuilder& builder) {
             if (label == Label::exit) {
                 return true;
             }
-            if (label != Label::entry && prog.cfg().contains(label) &&
-                std::holds_alternative<Exit>(prog.instruction_at(label)) && label.stack_frame_prefix.empty()) {
+            if (label != Label::entry && builder.contains(label) &&
+                std::holds_alternative<Exit>(builder.instruction_at(label)) && label.stack_frame_prefix.empty()) {
                 return true;
             }
-            for (const Label& child : prog.cfg().children_of(label)) {
+            for (const Label& child : builder.children_of(label)) {
                 worklist.push_back(child);
             }
         }
@@ -825,12 +914,12 @@ static void pass_insert_termination_counters(CfgBuilder& builder, const Wto& wto
 
 // Pass: ExtractAssertions
 // Reads    : Program instructions, ProgramInfo, options.
-// Writes   : Populates builder.prog.m_assertions with the per-label precondition vector
+// Writes   : Populates each builder node's assertions with the per-label precondition vector
 //            (memory bounds, type guards, etc.) produced by get_assertions.
 // Notes    : Runs for every label in the CFG, including synthetic ones (Assume / counters).
 static void pass_extract_assertions(CfgBuilder& builder, const ProgramInfo& info, const VerifierOptions& options) {
-    for (const auto& label : builder.prog.labels()) {
-        builder.set_assertions(label, get_assertions(builder.prog.instruction_at(label), info, options.runtime, label));
+    for (const auto& label : builder.labels()) {
+        builder.set_assertions(label, get_assertions(builder.instruction_at(label), info, options.runtime, label));
     }
 }
 
@@ -865,8 +954,8 @@ Program Program::from_sequence(const InstructionSeq& inst_seq, const ProgramInfo
     pass_inline_local_calls(builder, inst_seq, options.runtime.max_call_stack_frames);
 
     // --- Pass: ValidateTailCallDepth --------------------------------------
-    const Wto wto{builder.prog.cfg()};
-    pass_validate_tail_call_depth(builder.prog, wto, *info.platform, info.type);
+    const Wto wto{builder.freeze_cfg()};
+    pass_validate_tail_call_depth(builder, wto, *info.platform, info.type);
 
     // --- Pass: ComputeCallbackMetadata ------------------------------------
     pass_compute_callback_metadata(builder);
@@ -879,7 +968,14 @@ Program Program::from_sequence(const InstructionSeq& inst_seq, const ProgramInfo
     // --- Pass: ExtractAssertions ------------------------------------------
     pass_extract_assertions(builder, info, options);
 
-    return std::move(builder.prog);
+    Program prog = std::move(builder).finalize();
+
+    // --- Pass: ComputeLiveness --------------------------------------------
+    // Runs on the finalized, LabelId-indexed CFG; reads the instructions and their assertions.
+    if (options.forget_dead_variables) {
+        prog.m_liveness = std::make_shared<const Liveness>(prog, options.runtime);
+    }
+    return prog;
 }
 
 std::set<BasicBlock> BasicBlock::collect_basic_blocks(const Cfg& cfg, const bool simplify) {
@@ -949,6 +1045,6 @@ Cfg cfg_from_adjacency_list(const std::map<Label, std::vector<Label>>& AdjList)
             builder.add_child(label, child);
         }
     }
-    return builder.prog.cfg();
+    return builder.freeze_cfg();
 }
 } // namespace prevail
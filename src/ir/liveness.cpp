@@ -0,0 +1,244 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#include "ir/liveness.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <variant>
+
+#include <gsl/narrow>
+
+#include "ir/program.hpp"
+#include "result.hpp"
+
+namespace prevail {
+
+template <typename>
+inline constexpr bool always_false_v = false;
+
+namespace {
+
+/// A byte range [start, end) in absolute stack offsets.
+struct StackRange {
+    int64_t start{};
+    int64_t end{};
+};
+
+/// What one label reads and definitely overwrites. Registers are bit masks indexed by register number.
+struct Effect {
+    uint16_t gen{};
+    uint16_t kill{};
+    bool reads_any_stack{};
+    std::optional<StackRange> stack_read;
+    std::optional<StackRange> stack_write;
+};
+
+constexpr uint16_t bit(const Reg& reg) { return gsl::narrow<uint16_t>(1u << reg.v); }
+
+constexpr uint16_t bits(const uint8_t first, const uint8_t last) {
+    uint16_t mask = 0;
+    for (uint8_t r = first; r <= last; ++r) {
+        mask |= bit(Reg{r});
+    }
+    return mask;
+}
+
+void read_value(Effect& effect, const Value& value) {
+    if (const auto reg = std::get_if<Reg>(&value)) {
+        effect.gen |= bit(*reg);
+    }
+}
+
+Effect effect_of(const Instruction& ins, const int64_t frame_pointer) {
+    Effect effect;
+    const auto r10_range = [&](const Deref& access) {
+        const int64_t start = frame_pointer + access.offset;
+        return StackRange{start, start + access.width};
+    };
+    std::visit(
+        [&](const auto& v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, Undefined> || std::is_same_v<T, IncrementLoopCounter> ||
+                          std::is_same_v<T, LoadPseudo>) {
+                // No register read; LoadPseudo is lowered before the CFG is built.
+            } else if constexpr (std::is_same_v<T, Bin>) {
+                if (v.op == Bin::Op::MOV || v.op == Bin::Op::MOVSX8 || v.op == Bin::Op::MOVSX16 ||
+                    v.op == Bin::Op::MOVSX32) {
+                    effect.kill |= bit(v.dst);
+                } else {
+                    effect.gen |= bit(v.dst);
+                }
+                read_value(effect, v.v);
+            } else if constexpr (std::is_same_v<T, Un>) {
+                effect.gen |= bit(v.dst);
+            } else if constexpr (std::is_same_v<T, LoadMapFd> || std::is_same_v<T, LoadMapAddress>) {
+                effect.kill |= bit(v.dst);
+            } else if constexpr (std::is_same_v<T, Call> || std::is_same_v<T, CallBtf>) {
+                // Some helpers leave r0-r5 untouched on some paths, so nothing is killed.
+                effect.gen |= bits(R1_ARG, R5_ARG);
+                effect.reads_any_stack = true;
+            } else if constexpr (std::is_same_v<T, Callx>) {
+                effect.gen |= bits(R1_ARG, R5_ARG) | bit(v.func);
+                effect.reads_any_stack = true;
+            } else if constexpr (std::is_same_v<T, CallLocal>) {
+                // r6-r9 are saved in the frame of the call and restored by its Exit.
+                effect.gen |= bits(R1_ARG, R9);
+            } else if constexpr (std::is_same_v<T, Exit>) {
+                if (!v.stack_frame_prefix.empty()) {
+                    // Restores r6-r9 of the caller and scratches r1-r5.
+                    effect.kill |= bits(R1_ARG, R9);
+                }
+                effect.gen |= bit(Reg{R0_RETURN_VALUE});
+            } else if constexpr (std::is_same_v<T, Jmp>) {
+                if (v.cond) {
+                    effect.gen |= bit(v.cond->left);
+                    read_value(effect, v.cond->right);
+                }
+            } else if constexpr (std::is_same_v<T, Assume>) {
+                effect.gen |= bit(v.cond.left);
+                read_value(effect, v.cond.right);
+            } else if constexpr (std::is_same_v<T, Mem>) {
+                const bool on_stack = v.access.basereg.v == R10_STACK_POINTER;
+                if (v.is_load) {
+                    if (const auto dst = std::get_if<Reg>(&v.value)) {
+                        effect.kill |= bit(*dst);
+                    }
+                    if (on_stack) {
+                        effect.stack_read = r10_range(v.access);
+                    } else {
+                        effect.reads_any_stack = true;
+                    }
+                } else {
+                    read_value(effect, v.value);
+                    if (on_stack) {
+                        effect.stack_write = r10_range(v.access);
+                    }
+                }
+                effect.gen |= bit(v.access.basereg);
+            } else if constexpr (std::is_same_v<T, Packet>) {
+                // r0 is the result and r1-r5 are scratched; r6 holds the context (see the assertions).
+                effect.kill |= bits(R0_RETURN_VALUE, R5_ARG);
+                if (v.regoffset) {
+                    effect.gen |= bit(*v.regoffset);
+                }
+            } else if constexpr (std::is_same_v<T, Atomic>) {
+                effect.gen |= bit(v.access.basereg) | bit(v.valreg);
+                if (v.op == Atomic::Op::CMPXCHG) {
+                    effect.gen |= bit(Reg{R0_RETURN_VALUE});
+                }
+                if (v.access.basereg.v == R10_STACK_POINTER) {
+                    effect.stack_read = r10_range(v.access);
+                } else {
+                    effect.reads_any_stack = true;
+                }
+            } else {
+                static_assert(always_false_v<T>, "Unhandled instruction type in Liveness");
+            }
+        },
+        ins);
+    return effect;
+}
+
+} // namespace
+
+Liveness::Liveness(const Program& prog, const RuntimeConfig& runtime) {
+    const Cfg& cfg = prog.cfg();
+    const size_t total_slots = gsl::narrow<size_t>(runtime.total_stack_size()) / SLOT_SIZE;
+    m_slots = total_slots <= MAX_TRACKED_SLOTS ? total_slots : 0;
+    m_words = 1 + (m_slots + 63) / 64;
+    m_live.assign(cfg.size() * m_words, 0);
+
+    std::vector<Effect> effects;
+    effects.reserve(cfg.size());
+    for (LabelId id = 0; id < cfg.size(); ++id) {
+        const Label& label = cfg.label_of(id);
+        const int64_t frame_pointer = runtime.total_stack_size() -
+                                      int64_t{runtime.subprogram_stack_size} * (label.call_stack_depth() - 1);
+        Effect effect = effect_of(prog.instruction_at(id), frame_pointer);
+        for (const Assertion& assertion : prog.assertions_at(id)) {
+            for (const Reg& reg : extract_assertion_registers(assertion)) {
+                effect.gen |= bit(reg);
+            }
+        }
+        effects.push_back(effect);
+    }
+
+    const auto set_slots = [&](uint64_t* words, size_t first, const size_t last, const bool value) {
+        for (; first < last; ++first) {
+            if (value) {
+                words[1 + first / 64] |= uint64_t{1} << (first % 64);
+            } else {
+                words[1 + first / 64] &= ~(uint64_t{1} << (first % 64));
+            }
+        }
+    };
+    const auto clamp = [&](const int64_t slot) {
+        return gsl::narrow<size_t>(std::clamp<int64_t>(slot, 0, gsl::narrow<int64_t>(m_slots)));
+    };
+
+    // Backward worklist, seeded in reverse LabelId order, which roughly follows the program backwards.
+    std::vector<LabelId> worklist;
+    std::vector<bool> queued(cfg.size(), true);
+    worklist.reserve(cfg.size());
+    for (LabelId id = 0; id < cfg.size(); ++id) {
+        worklist.push_back(id);
+    }
+    std::vector<uint64_t> live(m_words);
+    while (!worklist.empty()) {
+        const LabelId id = worklist.back();
+        worklist.pop_back();
+        queued[id] = false;
+
+        std::ranges::fill(live, 0);
+        for (const LabelId child : cfg.children_of(id)) {
+            for (size_t w = 0; w < m_words; ++w) {
+                live[w] |= m_live[child * m_words + w];
+            }
+        }
+        if (id == cfg.exit_id()) {
+            // The analysis reports r0 at the exit.
+            live[0] |= bit(Reg{R0_RETURN_VALUE});
+        }
+        const Effect& effect = effects[id];
+        live[0] = (live[0] & ~uint64_t{effect.kill}) | effect.gen;
+        if (effect.reads_any_stack) {
+            set_slots(live.data(), 0, m_slots, true);
+        } else {
+            if (const auto& range = effect.stack_write) {
+                set_slots(live.data(), clamp((range->start + SLOT_SIZE - 1) / SLOT_SIZE),
+                          clamp(range->end / SLOT_SIZE), false);
+            }
+            if (const auto& range = effect.stack_read) {
+                set_slots(live.data(), clamp(range->start / SLOT_SIZE),
+                          clamp((range->end + SLOT_SIZE - 1) / SLOT_SIZE), true);
+            }
+        }
+
+        uint64_t* const stored = &m_live[id * m_words];
+        if (std::ranges::equal(live, std::span{stored, m_words})) {
+            continue;
+        }
+        std::ranges::copy(live, stored);
+        for (const LabelId parent : cfg.parents_of(id)) {
+            if (!queued[parent]) {
+                queued[parent] = true;
+                worklist.push_back(parent);
+            }
+        }
+    }
+}
+
+bool Liveness::is_live(const LabelId label, const Reg& reg) const {
+    return reg.v == R10_STACK_POINTER || (m_live[label * m_words] & bit(reg)) != 0;
+}
+
+bool Liveness::is_live_slot(const LabelId label, const size_t slot) const {
+    if (slot >= m_slots) {
+        return true;
+    }
+    return (m_live[label * m_words + 1 + slot / 64] >> (slot % 64) & 1) != 0;
+}
+
+} // namespace prevail
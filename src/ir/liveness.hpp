@@ -0,0 +1,53 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "cfg/cfg.hpp"
+#include "config.hpp"
+#include "ir/syntax.hpp"
+
+namespace prevail {
+
+class Program;
+
+/// Backward liveness of registers and stack slots over the CFG of a Program, inlined calls included.
+///
+/// A register or 8-byte stack slot is live at the start of a label if some path from there may read
+/// it before overwriting it. The analysis is conservative: only full overwrites kill, and an access
+/// whose target is not a constant offset from r10 (a load through another register, a helper call,
+/// an atomic operation through a pointer) makes the whole stack live. r10 is always live.
+///
+/// Stack slots are numbered by absolute stack offset, with r10 at `total_stack_size()` on entry and
+/// one `subprogram_stack_size` lower in each nested call, as set up by EbpfDomain::setup_entry.
+class Liveness final {
+  public:
+    static constexpr int SLOT_SIZE = 8;
+    /// Stacks with more slots are not tracked; all their slots are considered live.
+    static constexpr size_t MAX_TRACKED_SLOTS = 4096;
+
+    Liveness(const Program& prog, const RuntimeConfig& runtime);
+
+    [[nodiscard]]
+    bool is_live(LabelId label, const Reg& reg) const;
+
+    /// Whether the stack bytes [slot * SLOT_SIZE, (slot + 1) * SLOT_SIZE) are live at the start of `label`.
+    [[nodiscard]]
+    bool is_live_slot(LabelId label, size_t slot) const;
+
+    /// Number of tracked stack slots, 0 if the stack is too large to be tracked.
+    [[nodiscard]]
+    size_t slot_count() const {
+        return m_slots;
+    }
+
+  private:
+    size_t m_slots{};
+    size_t m_words{};             ///< Words per label: one for the registers, then the stack slots.
+    std::vector<uint64_t> m_live; ///< Live-in sets, m_words per LabelId.
+};
+
+} // namespace prevail
@@ -3,26 +3,30 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <set>
 #include <vector>
 
 #include "cfg/cfg.hpp"
 #include "cfg/label.hpp"
 #include "config.hpp"
-#include "crab_utils/debug.hpp"          // CRAB_ERROR (used by inline methods below)
 #include "crab_utils/prevail_errors.hpp" // RuntimeInputError base for InvalidControlFlow
 #include "ir/syntax.hpp"
 #include "spec/type_descriptors.hpp"
 
 namespace prevail {
+class Liveness;
+
 class Program {
     friend struct CfgBuilder;
 
-    std::map<Label, Instruction> m_instructions{{Label::entry, Undefined{}}, {Label::exit, Undefined{}}};
+    Cfg m_cfg;
+
+    // Indexed by the LabelId of m_cfg.
+    std::vector<Instruction> m_instructions{Undefined{}, Undefined{}};
 
     // This is a cache. The assertions can also be computed on the fly.
-    std::map<Label, std::vector<Assertion>> m_assertions{{Label::entry, {}}, {Label::exit, {}}};
-    Cfg m_cfg;
+    std::vector<std::vector<Assertion>> m_assertions{{}, {}};
 
     ProgramInfo m_info;
 
@@ -31,6 +35,9 @@ class Program {
     std::set<int32_t> m_callback_target_labels;
     std::set<int32_t> m_callback_targets_with_exit;
 
+    // Computed by Program::from_sequence under VerifierOptions::forget_dead_variables.
+    std::shared_ptr<const Liveness> m_liveness;
+
   public:
     const Cfg& cfg() const { return m_cfg; }
     const ProgramInfo& info() const { return m_info; }
@@ -40,32 +47,22 @@ class Program {
     // Subset whose body can reach a top-level Exit in the CFG.
     const std::set<int32_t>& callback_targets_with_exit() const { return m_callback_targets_with_exit; }
 
-    //! return a view of the labels, including entry and exit
+    //! return the labels in LabelId order, including entry and exit
     [[nodiscard]]
-    auto labels() const {
+    const std::vector<Label>& labels() const {
         return m_cfg.labels();
     }
 
-    const Instruction& instruction_at(const Label& label) const {
-        if (!m_instructions.contains(label)) {
-            CRAB_ERROR("Label ", to_string(label), " not found in the CFG: ");
-        }
-        return m_instructions.at(label);
-    }
+    const Instruction& instruction_at(const Label& label) const { return m_instructions[m_cfg.id_of(label)]; }
 
-    Instruction& instruction_at(const Label& label) {
-        if (!m_instructions.contains(label)) {
-            CRAB_ERROR("Label ", to_string(label), " not found in the CFG: ");
-        }
-        return m_instructions.at(label);
-    }
+    const Instruction& instruction_at(const LabelId id) const { return m_instructions[id]; }
 
-    std::vector<Assertion> assertions_at(const Label& label) const {
-        if (!m_assertions.contains(label)) {
-            CRAB_ERROR("Label ", to_string(label), " not found in the CFG: ");
-        }
-        return m_assertions.at(label);
-    }
+    const std::vector<Assertion>& assertions_at(const Label& label) const { return m_assertions[m_cfg.id_of(label)]; }
+
+    const std::vector<Assertion>& assertions_at(const LabelId id) const { return m_assertions[id]; }
+
+    // Null unless the program was built with VerifierOptions::forget_dead_variables.
+    const Liveness* liveness() const { return m_liveness.get(); }
 
     static Program from_sequence(const InstructionSeq& inst_seq, const ProgramInfo& info,
                                  const VerifierOptions& options);
@@ -0,0 +1,96 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#include <algorithm>
+
+#include <gsl/narrow>
+
+#include "crab/var_registry.hpp"
+#include "crab/zone_domain.hpp"
+#include "crab_utils/thread_pool.hpp"
+#include "iteration_engine.hpp"
+
+namespace prevail {
+
+ComponentScheduler::ComponentScheduler(const Cfg& cfg, const Wto& wto)
+    : cfg_(cfg), wto_(wto), component_of_(cfg.size(), unreached) {
+    for (const auto& component : wto_) {
+        for_each_component_label(component,
+                                 [&](const Label& label) { component_of_[cfg_.id_of(label)] = components_.size(); });
+        components_.push_back(&component);
+    }
+}
+
+void ComponentScheduler::run_sequential(const Visit& visit) const {
+    for (size_t c = 0; c < components_.size(); ++c) {
+        visit(c);
+    }
+}
+
+void ComponentScheduler::run_parallel(const size_t num_threads, const Visit& visit, const std::atomic<bool>& stopped,
+                                      const bool intervals_only) const {
+    const size_t n = components_.size();
+    std::vector<std::vector<size_t>> successors(n);
+    std::vector<std::atomic<uint32_t>> waiting_on(n);
+    std::vector<size_t> deps;
+    for (size_t c = 0; c < n; ++c) {
+        deps.clear();
+        for_each_component_label(*components_[c], [&](const Label& label) {
+            for (const LabelId prev : cfg_.parents_of(cfg_.id_of(label))) {
+                const size_t dep = component_of_[prev];
+                if (dep != c && dep != unreached) {
+                    deps.push_back(dep);
+                }
+            }
+        });
+        std::ranges::sort(deps);
+        const auto duplicates = std::ranges::unique(deps);
+        deps.erase(duplicates.begin(), duplicates.end());
+        waiting_on[c].store(gsl::narrow<uint32_t>(deps.size()), std::memory_order_relaxed);
+        for (const size_t dep : deps) {
+            successors[dep].push_back(c);
+        }
+    }
+    warm_nesting_cache();
+
+    VariableRegistry& registry = variable_registry;
+    const VariableRegistrySharing sharing{registry};
+    ThreadPool pool{num_threads};
+    std::function<void(size_t)> schedule = [&](const size_t c) {
+        pool.submit([&, c] {
+            if (stopped.load(std::memory_order_relaxed)) {
+                return;
+            }
+            const VariableRegistryBinding binding{registry};
+            const ZoneDomain::IntervalsOnly scope{intervals_only};
+            visit(c);
+            for (const size_t next : successors[c]) {
+                if (waiting_on[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    schedule(next);
+                }
+            }
+        });
+    };
+    // Collect the roots before submitting any: once tasks run, counters of later components
+    // drop to zero too, and those are scheduled by the task that finishes their last dependency.
+    std::vector<size_t> roots;
+    for (size_t c = 0; c < n; ++c) {
+        if (waiting_on[c].load(std::memory_order_relaxed) == 0) {
+            roots.push_back(c);
+        }
+    }
+    for (const size_t c : roots) {
+        schedule(c);
+    }
+    pool.wait();
+}
+
+void ComponentScheduler::warm_nesting_cache() const {
+    wto_.for_each_loop_head([&](const Label& head) {
+        wto_.nesting(head);
+        for (const LabelId prev : cfg_.parents_of(cfg_.id_of(head))) {
+            wto_.nesting(cfg_.label_of(prev));
+        }
+    });
+}
+
+} // namespace prevail
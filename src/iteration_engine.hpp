@@ -0,0 +1,71 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "cfg/cfg.hpp"
+#include "cfg/wto.hpp"
+
+namespace prevail {
+
+/// The order in which the fixpoint iterator visits the top-level components of the WTO.
+///
+/// Top-level components form a DAG along the CFG edges between them: a component only reads the
+/// post-states of earlier components holding parents of its labels, and never writes outside
+/// itself. The sequential engine visits them in WTO order. The parallel engine
+/// (VerifierOptions::analysis_threads) makes each a task that becomes ready once all the components
+/// it reads from have finished. Cycles are still iterated to their fixpoint by a single task, so
+/// every label sees exactly the inputs it sees sequentially and the invariants are the same.
+///
+/// Has no knowledge of abstract states: visiting a component is up to the caller.
+class ComponentScheduler final {
+  public:
+    /// Visit the top-level component with the given index.
+    using Visit = std::function<void(size_t)>;
+
+    static constexpr size_t unreached = std::numeric_limits<size_t>::max();
+
+    ComponentScheduler(const Cfg& cfg, const Wto& wto);
+
+    [[nodiscard]]
+    size_t size() const {
+        return components_.size();
+    }
+
+    [[nodiscard]]
+    const CycleOrLabel& component(const size_t index) const {
+        return *components_[index];
+    }
+
+    /// The index of the top-level component holding `id`, or `unreached` outside the WTO.
+    [[nodiscard]]
+    size_t component_of(const LabelId id) const {
+        return component_of_[id];
+    }
+
+    /// Visit the components one after the other, in WTO order.
+    void run_sequential(const Visit& visit) const;
+
+    /// Visit the components on `num_threads` threads, each with the shared variable registry bound,
+    /// and with ZoneDomain::IntervalsOnly if `intervals_only`. Components not started by the time
+    /// `stopped` is set are skipped. Rethrows the first exception a visit throws.
+    void run_parallel(size_t num_threads, const Visit& visit, const std::atomic<bool>& stopped,
+                      bool intervals_only) const;
+
+  private:
+    // Wto::nesting() fills a cache on first use. Fill it for every query the cycle visitor makes,
+    // so that concurrent visitors only read it.
+    void warm_nesting_cache() const;
+
+    const Cfg& cfg_;
+    const Wto& wto_;
+    std::vector<const CycleOrLabel*> components_;
+    std::vector<size_t> component_of_;
+};
+
+} // namespace prevail
@@ -1,5 +1,7 @@
 // Copyright (c) Prevail Verifier contributors.
 // SPDX-License-Identifier: MIT
+#include <chrono>
+#include <iomanip>
 #include <iostream>
 #include <ranges>
 #include <vector>
@@ -37,11 +39,65 @@ static std::set<std::string> get_conformance_group_names() {
 }
 
 /// Format the program label as "section/function" or just "section" if they match.
+static std::string program_label(const std::string& section_name, const std::string& function_name) {
+    if (function_name.empty() || function_name == section_name) {
+        return section_name;
+    }
+    return section_name + "/" + function_name;
+}
+
 static std::string program_label(const RawProgram& raw_prog) {
-    if (raw_prog.function_name.empty() || raw_prog.function_name == raw_prog.section_name) {
-        return raw_prog.section_name;
+    return program_label(raw_prog.section_name, raw_prog.function_name);
+}
+
+/// Verify every program of `elf` with `--all`, printing one PASS/FAIL line per program
+/// in object order. Returns the process exit code.
+static int verify_all_programs(ElfObject& elf, const VerifierOptions& options, const size_t jobs, const bool quiet) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto results = verify_all(elf, options, jobs);
+    const std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - start;
+
+    bool any_internal_error = false;
+    size_t passed = 0;
+    for (const ProgramVerification& res : results) {
+        any_internal_error |= res.internal_error;
+        if (!res.failed) {
+            ++passed;
+        }
+        if (quiet) {
+            continue;
+        }
+        const std::chrono::duration<double, std::milli> elapsed =
+            res.timings.unmarshal + res.timings.cfg + res.timings.analysis;
+        std::cout << (res.interruption ? "TIMEOUT: " : res.failed ? "FAIL: " : "PASS: ")
+                  << program_label(res.section_name, res.function_name);
+        if (!res.failed && options.runtime.check_for_termination) {
+            std::cout << " (terminates within " << res.max_loop_count << " loop iterations)";
+        }
+        if (options.interval_pre_pass && !res.load_error) {
+            std::cout << " {" << to_string(res.tier) << "}";
+        }
+        std::cout << " [" << std::fixed << std::setprecision(3) << elapsed.count() << " ms]\n";
+        if (res.load_error) {
+            std::cout << (res.internal_error ? "  internal error: " : "  error: ") << *res.load_error << "\n";
+        } else {
+            if (res.first_error) {
+                std::cout << "  " << to_string(*res.first_error) << "\n";
+            }
+            if (res.interruption) {
+                std::cout << "  " << to_string(*res.interruption) << "\n";
+            }
+        }
+    }
+    if (!quiet) {
+        std::cout << passed << " of " << results.size() << " programs passed [" << std::fixed << std::setprecision(3)
+                  << wall.count() << " ms]\n";
+    }
+    if (any_internal_error) {
+        std::cerr << "this is a bug in Prevail; please file an issue." << std::endl;
+        return 2;
     }
-    return raw_prog.section_name + "/" + raw_prog.function_name;
+    return passed == results.size() ? 0 : 1;
 }
 
 int main(int argc, char** argv) {
@@ -62,19 +118,64 @@ int main(int argc, char** argv) {
     app.add_option("path", filename, "Elf file to analyze")->required()->check(CLI::ExistingFile);
 
     std::string desired_section;
-    app.add_option("--section,section", desired_section, "Section to analyze")->type_name("SECTION");
+    auto* section_opt =
+        app.add_option("--section,section", desired_section, "Section to analyze")->type_name("SECTION");
 
     std::string desired_program;
-    app.add_option("--function,function", desired_program, "Function to analyze")->type_name("FUNCTION");
+    auto* function_opt =
+        app.add_option("--function,function", desired_program, "Function to analyze")->type_name("FUNCTION");
 
     bool list = false;
-    app.add_flag("-l", list, "List programs");
+    auto* list_opt = app.add_flag("-l", list, "List programs");
+
+    bool all = false;
+    auto* all_opt = app.add_flag("--all", all, "Verify every program of the object")
+                        ->excludes(section_opt)
+                        ->excludes(function_opt)
+                        ->excludes(list_opt);
+
+    size_t jobs = 0;
+    app.add_option("--jobs,-j", jobs, "Programs verified concurrently with --all (default: one per hardware thread)")
+        ->needs(all_opt)
+        ->type_name("N");
 
     bool quiet = false;
     app.add_flag("-q,--quiet", quiet, "No stdout output, exit code only");
 
     bool print_cfg = false;
-    app.add_flag("--cfg", print_cfg, "Print control-flow graph and exit");
+    app.add_flag("--cfg", print_cfg, "Print control-flow graph and exit")->excludes(all_opt);
+
+    app.add_flag("--summarize-calls", ebpf_verifier_options.summarize_local_calls,
+                 "Reuse the analysis of a local subprogram across calls with the same calling context");
+
+    app.add_flag("--stop-on-first-error", ebpf_verifier_options.stop_on_first_error,
+                 "Stop the analysis at the first error; invariants are then incomplete");
+
+    app.add_flag("--incremental-loops", ebpf_verifier_options.incremental_loops,
+                 "Only re-analyze the loop labels whose inputs changed since the previous iteration");
+
+    app.add_flag("--forget-dead", ebpf_verifier_options.forget_dead_variables,
+                 "Forget dead registers and stack slots at joins and loop heads");
+
+    app.add_flag("--memoize", ebpf_verifier_options.memoize_lattice_operations,
+                 "Cache the results of joins, widenings and inclusion checks on recurring states");
+
+    app.add_flag("--defer-loop-checks", ebpf_verifier_options.defer_loop_checks,
+                 "Check the assertions of loop labels once, after their loop has stabilized");
+
+    app.add_flag("--interval-pre-pass", ebpf_verifier_options.interval_pre_pass,
+                 "Try an interval-only analysis first; report which domain decided the result");
+
+    app.add_flag("--lazy-narrowing", ebpf_verifier_options.lazy_narrowing,
+                 "Narrow loop invariants only if the widened ones leave an error");
+
+    uint64_t time_limit_ms = 0;
+    app.add_option("--time-limit", time_limit_ms, "Give up the analysis after MS milliseconds (default: no limit)")
+        ->type_name("MS");
+
+    app.add_option("--max-steps", ebpf_verifier_options.limits.max_steps,
+                   "Give up the analysis after N transfer functions (default: no limit)")
+        ->type_name("N");
 
     app.add_flag("--termination,!--no-verify-termination", ebpf_verifier_options.runtime.check_for_termination,
                  "Verify termination. Default: ignore")
@@ -132,13 +233,15 @@ int main(int argc, char** argv) {
         ->group("Verbosity");
 
     app.add_flag("-v", ebpf_verifier_options.verbosity_opts.print_invariants, "Print invariants and first failure")
-        ->group("Verbosity");
+        ->group("Verbosity")
+        ->excludes(all_opt);
     app.add_flag("-f", ebpf_verifier_options.verbosity_opts.print_failures, "Print first failure")->group("Verbosity");
 
     bool failure_slice = false;
     app.add_flag("--failure-slice", failure_slice,
                  "Print minimal failure slices showing only instructions that contributed to errors")
-        ->group("Verbosity");
+        ->group("Verbosity")
+        ->excludes(all_opt);
 
     size_t failure_slice_depth = 200;
     app.add_option("--failure-slice-depth", failure_slice_depth,
@@ -146,11 +249,18 @@ int main(int argc, char** argv) {
         ->group("Verbosity");
 
     std::string asmfile;
-    app.add_option("--asm", asmfile, "Print disassembly to FILE")->group("CFG output")->type_name("FILE");
+    app.add_option("--asm", asmfile, "Print disassembly to FILE")
+        ->group("CFG output")
+        ->type_name("FILE")
+        ->excludes(all_opt);
     std::string dotfile;
-    app.add_option("--dot", dotfile, "Export control-flow graph to dot FILE")->group("CFG output")->type_name("FILE");
+    app.add_option("--dot", dotfile, "Export control-flow graph to dot FILE")
+        ->group("CFG output")
+        ->type_name("FILE")
+        ->excludes(all_opt);
 
     CLI11_PARSE(app, argc, argv);
+    ebpf_verifier_options.limits.time_limit = std::chrono::milliseconds{time_limit_ms};
 
     // Enable default conformance groups, which don't include callx or packet.
     ebpf_platform_t platform = g_ebpf_platform_linux;
@@ -165,6 +275,18 @@ int main(int argc, char** argv) {
     // Main program
 
     ElfObject elf{filename, ebpf_verifier_options, &platform};
+    if (all) {
+        try {
+            return verify_all_programs(elf, ebpf_verifier_options, jobs, quiet);
+        } catch (const InternalError& e) {
+            std::cerr << "internal error: " << e.what() << std::endl;
+            std::cerr << "this is a bug in Prevail; please file an issue." << std::endl;
+            return 2;
+        } catch (const std::exception& e) {
+            std::cerr << "error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
     vector<RawProgram> raw_progs;
     std::optional<std::string> load_error;
     if (!list) {
@@ -288,7 +410,13 @@ int main(int argc, char** argv) {
                 if (ebpf_verifier_options.runtime.check_for_termination) {
                     std::cout << " (terminates within " << result.max_loop_count << " loop iterations)";
                 }
+                if (ebpf_verifier_options.interval_pre_pass) {
+                    std::cout << " {" << to_string(result.tier) << "}";
+                }
                 std::cout << "\n";
+            } else if (result.interruption) {
+                std::cout << "TIMEOUT: " << label << "\n";
+                print_interruption(std::cout, *result.interruption);
             } else {
                 std::cout << "FAIL: " << label << "\n";
                 // Print the first error if not already printed by -v or -f.
@@ -1,6 +1,7 @@
 // Copyright (c) Prevail Verifier contributors.
 // SPDX-License-Identifier: MIT
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -134,7 +135,7 @@ struct DetailedPrinter : LineInfoPrinter {
     DetailedPrinter(std::ostream& os, const Program& prog, const bool print_line_info = false)
         : LineInfoPrinter{os, prog.info().line_info, print_line_info}, prog(prog) {}
 
-    void print_labels(const std::string& direction, const std::set<Label>& labels) {
+    void print_labels(const std::string& direction, const std::ranges::input_range auto& labels) {
         auto [it, et] = std::pair{labels.begin(), labels.end()};
         if (it != et) {
             os << "  " << direction << " ";
@@ -253,6 +254,40 @@ void print_unreachable(std::ostream& os, const Program& prog, const AnalysisResu
     os << "\n";
 }
 
+static const char* describe(const InterruptionReason reason) {
+    switch (reason) {
+    case InterruptionReason::cancelled: return "analysis cancelled";
+    case InterruptionReason::deadline: return "time limit exceeded";
+    case InterruptionReason::step_budget: return "step budget exhausted";
+    }
+    std::unreachable();
+}
+
+std::string to_string(const AnalysisInterruption& interruption) {
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(interruption.elapsed);
+    std::stringstream ss;
+    ss << describe(interruption.reason) << " at " << interruption.where << " after " << interruption.steps
+       << " steps, " << ms.count() << " ms";
+    return ss.str();
+}
+
+std::string to_string(const AnalysisTier tier) {
+    switch (tier) {
+    case AnalysisTier::intervals: return "intervals";
+    case AnalysisTier::zones: return "zones";
+    }
+    std::unreachable();
+}
+
+void print_interruption(std::ostream& os, const AnalysisInterruption& interruption) {
+    os << to_string(interruption) << "\n";
+    for (const auto& [head, steps] : interruption.steps_by_loop) {
+        os << "  loop at " << head << ": " << steps << " steps\n";
+    }
+    os << "  outside loops: " << interruption.steps_outside_loops << " steps\n";
+    os << "\n";
+}
+
 std::string to_string(const VerificationError& error) {
     std::stringstream ss;
     if (const auto& label = error.where) {
@@ -784,9 +819,9 @@ void print_invariants_filtered(std::ostream& os, const Program& prog, const Anal
     auto get_parent_post_invariant = [&](const Label& parent) -> const EbpfDomain* {
         const auto leader_it = label_to_block_leader.find(parent);
         const Label& lookup_label = (leader_it != label_to_block_leader.end()) ? leader_it->second : parent;
-        const auto inv_it = result.invariants.find(lookup_label);
-        if (inv_it != result.invariants.end() && !inv_it->second.post.is_bottom()) {
-            return &inv_it->second.post;
+        const auto* inv_pair = result.invariants.find(lookup_label);
+        if (inv_pair && !inv_pair->post.is_bottom()) {
+            return &inv_pair->post;
         }
         return nullptr;
     };
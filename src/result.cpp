@@ -1,14 +1,21 @@
 // Copyright (c) Prevail Verifier contributors.
 // SPDX-License-Identifier: MIT
 #include <algorithm>
+#include <cctype>
 #include <map>
 #include <ranges>
 #include <regex>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
+#include "analysis_context.hpp"
+#include "cfg/wto.hpp"
 #include "config.hpp"
 #include "crab/ebpf_domain.hpp"
+#include "crab_utils/prevail_errors.hpp"
 #include "ir/program.hpp"
 #include "result.hpp"
 #include "spec/ebpf_base.h"
@@ -117,11 +124,11 @@ bool RelevantState::is_relevant_constraint(const std::string& constraint) const
 ObservationCheckResult AnalysisResult::check_observation_at_label(const Label& label, const InvariantPoint point,
                                                                   const EbpfDomain& observation,
                                                                   const ObservationCheckMode mode) const {
-    const auto it = invariants.find(label);
-    if (it == invariants.end()) {
+    const InvariantMapPair* const inv_pair_ptr = invariants.find(label);
+    if (!inv_pair_ptr) {
         return {.ok = false, .message = "No invariant available for label " + to_string(label)};
     }
-    const auto& inv_pair = it->second;
+    const auto& inv_pair = *inv_pair_ptr;
     const EbpfDomain& abstract_state = (point == InvariantPoint::pre) ? inv_pair.pre : inv_pair.post;
 
     if (observation.is_bottom()) {
@@ -160,8 +167,190 @@ bool AnalysisResult::is_consistent_after(const Label& label, const EbpfDomain& o
 
 StringInvariant AnalysisResult::invariant_at(const Label& label) const { return invariants.at(label).post.to_set(); }
 
+namespace {
+// 64-bit FNV-1a over a sequence of strings, each followed by a separator.
+struct Fnv1a {
+    uint64_t hash = 0xcbf29ce484222325;
+
+    void mix(const std::string& s) {
+        for (const char c : s) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+        }
+        hash = (hash ^ 0xff) * 0x100000001b3;
+    }
+};
+} // namespace
+
+// The labels of a call-frame prefix ("3", "3/7:9", ...) with every index shifted by -`base`.
+static std::string relative_prefix(const std::string& prefix, const int base) {
+    std::string res;
+    size_t start = 0;
+    while (start < prefix.size()) {
+        size_t end = prefix.find_first_of(":/", start);
+        if (end == std::string::npos) {
+            end = prefix.size();
+        }
+        const std::string part = prefix.substr(start, end - start);
+        const bool is_index = !part.empty() && std::ranges::all_of(part, [](const char c) { return std::isdigit(c); });
+        res += is_index ? std::to_string(std::stoll(part) - base) : part;
+        if (end < prefix.size()) {
+            res += prefix[end];
+        }
+        start = end + 1;
+    }
+    return res;
+}
+
+// `label` as an offset from the instruction at `base`.
+static Label relative_label(const Label& label, const int base) {
+    if (label == Label::entry || label == Label::exit) {
+        return label;
+    }
+    Label res{label.from - base, label.to == -1 ? -1 : label.to - base,
+              relative_prefix(label.stack_frame_prefix, base)};
+    res.special_label = label.special_label;
+    return res;
+}
+
+// `ins` with the labels and call-frame prefixes it names taken relative to `base`.
+static Instruction relative_instruction(Instruction ins, const int base) {
+    std::visit(
+        [&]<typename T>(T& v) {
+            if constexpr (std::is_same_v<T, Jmp>) {
+                v.target = relative_label(v.target, base);
+            } else if constexpr (std::is_same_v<T, CallLocal>) {
+                v.target = relative_label(v.target, base);
+                v.stack_frame_prefix = relative_prefix(v.stack_frame_prefix, base);
+            } else if constexpr (std::is_same_v<T, Exit>) {
+                v.stack_frame_prefix = relative_prefix(v.stack_frame_prefix, base);
+            } else if constexpr (std::is_same_v<T, IncrementLoopCounter>) {
+                v.name = relative_label(v.name, base);
+            }
+        },
+        ins);
+    return ins;
+}
+
+uint64_t loop_structure_hash(const Program& prog, const WtoCycle& cycle) {
+    std::set<Label> labels;
+    for (const auto& component : cycle) {
+        for_each_component_label(component, [&](const Label& label) { labels.insert(label); });
+    }
+    // Over the printed labels and instructions, in label order, with every label taken relative to
+    // the head, so that a loop moved by code inserted before it keeps its hash.
+    const int base = cycle.head().from;
+    Fnv1a fnv;
+    for (const Label& label : labels) {
+        fnv.mix(to_string(relative_label(label, base)));
+        fnv.mix(to_string(relative_instruction(prog.instruction_at(label), base)));
+    }
+    return fnv.hash;
+}
+
+uint64_t certificate_hash(const AnalysisContext& context) {
+    Fnv1a fnv;
+    const Program& prog = context.program;
+    for (const Label& label : prog.labels()) {
+        fnv.mix(to_string(label));
+        fnv.mix(to_string(prog.instruction_at(label)));
+        for (const Assertion& assertion : prog.assertions_at(label)) {
+            fnv.mix(to_string(assertion));
+        }
+    }
+    const EbpfProgramType& type = context.program_info().type;
+    fnv.mix(std::to_string(type.platform_specific_data));
+    fnv.mix(std::to_string(type.is_privileged) + std::to_string(type.is_sleepable));
+    if (const ebpf_ctx_descriptor_t* ctx = type.ctx_descriptor) {
+        for (const int field : {ctx->size, ctx->data, ctx->end, ctx->meta}) {
+            fnv.mix(std::to_string(field));
+        }
+    }
+    for (const EbpfMapDescriptor& map : context.program_info().map_descriptors) {
+        for (const int64_t field : {int64_t{map.original_fd}, int64_t{map.type}, int64_t{map.key_size},
+                                    int64_t{map.value_size}, int64_t{map.max_entries}, int64_t{map.inner_map_fd}}) {
+            fnv.mix(std::to_string(field));
+        }
+    }
+    const RuntimeConfig& runtime = context.runtime();
+    for (const int field : {int{runtime.strict}, int{runtime.allow_division_by_zero}, int{runtime.setup_constraints},
+                            int{runtime.big_endian}, int{runtime.check_for_termination},
+                            runtime.subprogram_stack_size, runtime.max_call_stack_frames, runtime.max_packet_size}) {
+        fnv.mix(std::to_string(field));
+    }
+    return fnv.hash;
+}
+
+// The first line holds the program hash; each loop head then starts with a line naming its label,
+// followed by the lines of its pre-state.
+std::string serialize_certificate(const InvariantCertificate& certificate) {
+    std::ostringstream os;
+    os << "certificate " << certificate.program_hash << '\n';
+    for (const auto& [head, inv] : certificate.loop_heads) {
+        os << "head " << head << '\n';
+        for (const std::string& line : inv.to_text()) {
+            os << line << '\n';
+        }
+    }
+    return os.str();
+}
+
+InvariantCertificate parse_certificate(const std::string_view text, const AnalysisContext& context) {
+    std::map<std::string, Label> label_of;
+    for (const Label& label : context.program.labels()) {
+        label_of.emplace(to_string(label), label);
+    }
+    InvariantCertificate certificate;
+    std::istringstream is{std::string{text}};
+    std::string line;
+    if (!std::getline(is, line) || !line.starts_with("certificate ")) {
+        throw RuntimeInputError("Certificate does not start with its program hash");
+    }
+    std::istringstream hash{line.substr(std::string_view{"certificate "}.size())};
+    if (!(hash >> certificate.program_hash) || !hash.eof()) {
+        throw RuntimeInputError("Malformed certificate hash: " + line);
+    }
+    std::optional<Label> head;
+    std::vector<std::string> lines;
+    const auto flush = [&] {
+        if (head) {
+            certificate.loop_heads.insert_or_assign(*head, EbpfDomain::from_text(lines, context));
+        }
+        lines.clear();
+    };
+    while (std::getline(is, line)) {
+        if (!line.starts_with("head ")) {
+            if (!head) {
+                throw RuntimeInputError("Certificate invariant before any loop head: " + line);
+            }
+            lines.push_back(std::move(line));
+            continue;
+        }
+        flush();
+        const auto it = label_of.find(line.substr(std::string_view{"head "}.size()));
+        if (it == label_of.end()) {
+            throw RuntimeInputError("Certificate names a label the program does not have: " + line);
+        }
+        head = it->second;
+    }
+    flush();
+    return certificate;
+}
+
+LoopHeadInvariants AnalysisResult::loop_head_invariants(const Program& prog) const {
+    LoopHeadInvariants res;
+    for (const auto& component : Wto{prog.cfg()}) {
+        if (const auto pcycle = std::get_if<std::shared_ptr<WtoCycle>>(&component)) {
+            const EbpfDomain& pre = invariants.at((*pcycle)->head()).pre;
+            if (!pre.is_bottom()) {
+                res.insert_or_assign(loop_structure_hash(prog, **pcycle), pre);
+            }
+        }
+    }
+    return res;
+}
+
 std::optional<VerificationError> AnalysisResult::find_first_error() const {
-    for (const auto& inv_pair : invariants | std::views::values) {
+    for (const auto& inv_pair : invariants.values()) {
         if (inv_pair.pre.is_bottom()) {
             continue;
         }
@@ -386,9 +575,8 @@ FailureSlice AnalysisResult::compute_slice_from_label(const Program& prog, const
     };
 
     // Copy error if present at this label.
-    const auto label_it = invariants.find(label);
-    if (label_it != invariants.end() && label_it->second.error) {
-        slice.error = *label_it->second.error;
+    if (const auto* inv_pair = invariants.find(label); inv_pair && inv_pair->error) {
+        slice.error = *inv_pair->error;
     }
 
     // `visited` tracks all explored labels for deduplication during backward traversal.
@@ -456,9 +644,9 @@ FailureSlice AnalysisResult::compute_slice_from_label(const Program& prog, const
         // Starts as a copy of relevant_after; the two branches below either
         // modify it or leave it unchanged.
         RelevantState relevant_before = relevant_after;
-        const auto inv_it = invariants.find(current_label);
-        if (inv_it != invariants.end() && inv_it->second.deps) {
-            const auto& deps = *inv_it->second.deps;
+        const auto* inv_pair = invariants.find(current_label);
+        if (inv_pair && inv_pair->deps) {
+            const auto& deps = *inv_pair->deps;
 
             // Remove registers that are written by this instruction
             // (they weren't relevant before their definition)
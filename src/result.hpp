@@ -2,11 +2,17 @@
 // SPDX-License-Identifier: MIT
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <optional>
 #include <ranges>
 #include <set>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "crab/ebpf_domain.hpp"
@@ -140,11 +146,184 @@ struct FailureSlice {
     }
 };
 
+/// Per-label invariants of one analysis, stored densely by the analyzed Cfg's LabelId.
+/// The fixpoint iterator indexes by LabelId directly; the Label-keyed accessors are a
+/// binary search over the shared LabelIndex and serve callers outside the analyzer.
+/// Iteration visits labels in LabelId (i.e. Label) order and yields (label, invariants) pairs.
+class InvariantTable {
+    std::shared_ptr<const LabelIndex> m_index;
+    std::vector<InvariantMapPair> m_entries;
+
+    class ConstIterator {
+        const InvariantTable* table;
+        LabelId id;
+
+      public:
+        using value_type = std::pair<const Label&, const InvariantMapPair&>;
+        using difference_type = std::ptrdiff_t;
+
+        ConstIterator(const InvariantTable* table, const LabelId id) : table(table), id(id) {}
+
+        value_type operator*() const { return {table->label_of(id), (*table)[id]}; }
+        ConstIterator& operator++() {
+            ++id;
+            return *this;
+        }
+        bool operator==(const ConstIterator& other) const { return id == other.id; }
+    };
+
+  public:
+    InvariantTable() = default;
+    InvariantTable(std::shared_ptr<const LabelIndex> index, const InvariantMapPair& initial)
+        : m_index(std::move(index)), m_entries(m_index->size(), initial) {}
+
+    [[nodiscard]]
+    size_t size() const {
+        return m_entries.size();
+    }
+
+    [[nodiscard]]
+    const Label& label_of(const LabelId id) const {
+        return m_index->label_of(id);
+    }
+
+    InvariantMapPair& operator[](const LabelId id) { return m_entries[id]; }
+    const InvariantMapPair& operator[](const LabelId id) const { return m_entries[id]; }
+
+    [[nodiscard]]
+    const InvariantMapPair& at(const Label& label) const {
+        return m_entries.at(m_index->id_of(label));
+    }
+
+    /// nullptr when the label is not part of the analyzed Cfg.
+    [[nodiscard]]
+    const InvariantMapPair* find(const Label& label) const {
+        if (!m_index) {
+            return nullptr;
+        }
+        const auto id = m_index->find(label);
+        return id ? &m_entries[*id] : nullptr;
+    }
+
+    [[nodiscard]]
+    std::span<const InvariantMapPair> values() const {
+        return m_entries;
+    }
+
+    [[nodiscard]]
+    std::span<InvariantMapPair> values() {
+        return m_entries;
+    }
+
+    [[nodiscard]]
+    ConstIterator begin() const {
+        return {this, 0};
+    }
+
+    [[nodiscard]]
+    ConstIterator end() const {
+        return {this, gsl::narrow<LabelId>(m_entries.size())};
+    }
+};
+
+class WtoCycle;
+
+/// Stabilized pre-states of outermost loop heads, keyed by loop_structure_hash().
+/// Exported by AnalysisResult::loop_head_invariants() and fed back to
+/// analyze(context, warm_start) to seed the same loops in a later analysis.
+/// The states name variables of the current thread's VariableRegistry.
+using LoopHeadInvariants = std::map<uint64_t, EbpfDomain>;
+
+/// Hash of a loop's labels and instructions, with labels and jump targets taken relative to the loop
+/// head. Loops with equal hashes have the same code, wherever it starts, so an invariant of one is a
+/// candidate for the other.
+[[nodiscard]]
+uint64_t loop_structure_hash(const Program& prog, const WtoCycle& cycle);
+
+/// Loop-head invariants from which check_certificate() verifies a program again in a single pass,
+/// without widening or narrowing (VerifierOptions::emit_certificate). Like LoopHeadInvariants,
+/// the states name variables of the current thread's VariableRegistry; serialize_certificate()
+/// writes them by name instead.
+struct InvariantCertificate {
+    /// certificate_hash() of the program and options the invariants were computed for.
+    uint64_t program_hash{};
+    /// Pre-states of the loop heads, nested loops included. Heads that are never reached are omitted.
+    std::map<Label, EbpfDomain> loop_heads;
+};
+
+/// Hash of a program's labels, instructions and assertions, of its program type and maps, and of
+/// the RuntimeConfig it is analyzed with: everything a certificate's invariants depend on.
+[[nodiscard]]
+uint64_t certificate_hash(const AnalysisContext& context);
+
+/// A certificate as text that names labels and variables (see EbpfDomain::to_text()), so that it
+/// can be stored, or sent to another process, and read back by parse_certificate() on any thread.
+[[nodiscard]]
+std::string serialize_certificate(const InvariantCertificate& certificate);
+
+/// Read back a certificate written by serialize_certificate() for the program of `context`, with
+/// the variables of the current thread's VariableRegistry. Throws RuntimeInputError if the text
+/// is malformed or names a label the program does not have.
+[[nodiscard]]
+InvariantCertificate parse_certificate(std::string_view text, const AnalysisContext& context);
+
+enum class InterruptionReason {
+    cancelled,   ///< AnalysisLimits::cancellation was cancelled.
+    deadline,    ///< AnalysisLimits::time_limit elapsed.
+    step_budget, ///< AnalysisLimits::max_steps transfer functions were applied.
+};
+
+/// Where an analysis stopped by one of its AnalysisLimits spent its budget.
+struct AnalysisInterruption {
+    InterruptionReason reason{};
+    uint64_t steps{};                   ///< Transfer functions applied before the analysis stopped.
+    std::chrono::nanoseconds elapsed{}; ///< Wall-clock time from the start of the analysis.
+    Label where = Label::entry;         ///< The label whose transfer function was not applied.
+    /// Steps spent in each outermost loop, keyed by its head, largest first.
+    std::vector<std::pair<Label, uint64_t>> steps_by_loop;
+    uint64_t steps_outside_loops{};
+};
+
+/// The numerical domain an analysis ran with (VerifierOptions::interval_pre_pass).
+enum class AnalysisTier {
+    intervals, ///< Bounds of each variable only.
+    zones,     ///< Bounds and differences between variables.
+};
+
 struct AnalysisResult {
-    std::map<Label, InvariantMapPair> invariants;
+    InvariantTable invariants;
     bool failed = false;
     int max_loop_count{};
     Interval exit_value = Interval::top();
+    /// Number of loops whose warm-start candidate proved inductive and seeded the fixpoint.
+    int warm_started_loops{};
+    /// Number of inlined calls whose results were reused from an earlier call with the same
+    /// calling context (VerifierOptions::summarize_local_calls).
+    int reused_call_summaries{};
+    /// Transfer functions applied, over all labels, iterations and passes.
+    uint64_t steps{};
+    /// Joins, widenings and inclusion checks answered from the cache of
+    /// VerifierOptions::memoize_lattice_operations.
+    uint64_t memo_hits{};
+    /// The tier that decided the result: `intervals` if the interval pre-pass accepted the program
+    /// (or was stopped by a limit), `zones` otherwise.
+    AnalysisTier tier = AnalysisTier::zones;
+    /// True if the analysis stopped at its first error (VerifierOptions::stop_on_first_error) or
+    /// exceeded one of its VerifierOptions::limits. Only `failed`, `find_first_error()`,
+    /// `interruption` and the counts of the work done before the analysis stopped (`steps`,
+    /// `memo_hits`, `warm_started_loops` and `reused_call_summaries`) are meaningful then;
+    /// `exit_value` is left at top and `max_loop_count` at 0.
+    bool partial = false;
+    /// Set if the analysis was stopped by one of its limits; `failed` is then set as well, since
+    /// the program was not shown safe.
+    std::optional<AnalysisInterruption> interruption;
+    /// Set if the program was accepted under VerifierOptions::emit_certificate.
+    std::optional<InvariantCertificate> certificate;
+
+    /// Pre-states of the outermost loop heads, to warm-start the analysis of a later build.
+    /// Empty for loops whose states were released (VerifierOptions::retain_invariants).
+    [[nodiscard]]
+    LoopHeadInvariants loop_head_invariants(const Program& prog) const;
 
     [[nodiscard]]
     ObservationCheckResult check_observation_at_label(const Label& label, InvariantPoint point,
@@ -196,6 +375,9 @@ struct AnalysisResult {
 
 void print_error(std::ostream& os, const VerificationError& error, const Program& prog,
                  const VerbosityOptions& verbosity);
+std::string to_string(const AnalysisInterruption& interruption);
+std::string to_string(AnalysisTier tier);
+void print_interruption(std::ostream& os, const AnalysisInterruption& interruption);
 void print_invariants(std::ostream& os, const Program& prog, const AnalysisResult& result,
                       const VerbosityOptions& verbosity);
 void print_unreachable(std::ostream& os, const Program& prog, const AnalysisResult& result);
@@ -0,0 +1,106 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+//
+// Analysis limits (VerifierOptions::limits): an analysis over its step budget, or whose token is
+// cancelled, stops with a partial result that reports where the budget was spent.
+
+#include <catch2/catch_all.hpp>
+
+#include "test/test_programs.hpp"
+
+using namespace prevail;
+using namespace program_test;
+
+TEST_CASE("an analysis over its step budget stops and reports where the steps went", "[limits]") {
+    VerifierOptions options;
+    options.limits.max_steps = 5;
+    const AnalysisResult result = analyze_sequence(counting_loop(), options);
+    REQUIRE(result.failed);
+    REQUIRE(result.partial);
+    REQUIRE(result.interruption.has_value());
+    const AnalysisInterruption& interruption = *result.interruption;
+    REQUIRE(interruption.reason == InterruptionReason::step_budget);
+    REQUIRE(interruption.steps == 5);
+    REQUIRE(interruption.steps_by_loop.size() == 1);
+    REQUIRE(interruption.steps_by_loop.front().first == Label{1});
+    REQUIRE(interruption.steps_by_loop.front().second + interruption.steps_outside_loops == interruption.steps);
+
+    options.analysis_threads = 4;
+    const AnalysisResult parallel = analyze_sequence(counting_loop(), options);
+    REQUIRE(parallel.partial);
+    REQUIRE(parallel.interruption.has_value());
+    REQUIRE(parallel.interruption->reason == InterruptionReason::step_budget);
+    REQUIRE(parallel.interruption->steps == 5);
+    REQUIRE(parallel.steps == 5);
+}
+
+TEST_CASE("an interrupted analysis counts the work it did, but has no exit value", "[limits]") {
+    VerifierOptions options;
+    options.memoize_lattice_operations = true;
+    const AnalysisResult complete = analyze_sequence(nested_loops(), options);
+    REQUIRE(!complete.failed);
+    REQUIRE(complete.memo_hits > 0);
+
+    options.limits.max_steps = complete.steps - 1;
+    const AnalysisResult limited = analyze_sequence(nested_loops(), options);
+    REQUIRE(limited.partial);
+    REQUIRE(limited.steps == options.limits.max_steps);
+    REQUIRE(limited.memo_hits > 0);
+    REQUIRE(limited.memo_hits <= complete.memo_hits);
+    REQUIRE(limited.exit_value == Interval::top());
+    REQUIRE(limited.max_loop_count == 0);
+}
+
+TEST_CASE("a cancelled analysis stops before its first step", "[limits]") {
+    VerifierOptions options;
+    const CancellationToken token = options.limits.cancellation;
+    token.cancel();
+    const AnalysisResult result = analyze_sequence(counting_loop(), options);
+    REQUIRE(result.failed);
+    REQUIRE(result.partial);
+    REQUIRE(result.interruption.has_value());
+    REQUIRE(result.interruption->reason == InterruptionReason::cancelled);
+    REQUIRE(result.interruption->steps == 0);
+}
+
+TEST_CASE("limits that are not reached do not change the result", "[limits]") {
+    VerifierOptions options;
+    const AnalysisResult unlimited = analyze_sequence(counting_loop(), options);
+    options.limits.max_steps = 1'000'000;
+    options.limits.time_limit = std::chrono::hours{1};
+    const AnalysisResult limited = analyze_sequence(counting_loop(), options);
+    REQUIRE(!limited.failed);
+    REQUIRE(!limited.partial);
+    REQUIRE(!limited.interruption.has_value());
+    REQUIRE(limited.exit_value == unlimited.exit_value);
+    REQUIRE(limited.exit_value == Interval{10});
+}
+
+TEST_CASE("the limits cover all the passes of an analysis", "[limits]") {
+    // Without limits, the failing program is analyzed four times: the interval pre-pass and the zone
+    // pass each run a pass without narrowing, then one with it.
+    VerifierOptions options;
+    const uint64_t single_pass = analyze_sequence(failing_loop(), options).steps;
+    options.interval_pre_pass = true;
+    options.lazy_narrowing = true;
+    const AnalysisResult unlimited = analyze_sequence(failing_loop(), options);
+    REQUIRE(unlimited.failed);
+    REQUIRE(!unlimited.interruption.has_value());
+    REQUIRE(unlimited.tier == AnalysisTier::zones);
+    REQUIRE(unlimited.steps > 2 * single_pass);
+
+    // A budget above any single pass, but below their sum, stops the analysis.
+    options.limits.max_steps = unlimited.steps - 1;
+    REQUIRE(options.limits.max_steps > single_pass);
+    const AnalysisResult limited = analyze_sequence(failing_loop(), options);
+    REQUIRE(limited.partial);
+    REQUIRE(limited.interruption.has_value());
+    REQUIRE(limited.interruption->reason == InterruptionReason::step_budget);
+    REQUIRE(limited.steps <= options.limits.max_steps);
+    REQUIRE(limited.interruption->steps == limited.steps);
+    uint64_t by_component = limited.interruption->steps_outside_loops;
+    for (const auto& [head, steps] : limited.interruption->steps_by_loop) {
+        by_component += steps;
+    }
+    REQUIRE(by_component == limited.steps);
+}
@@ -0,0 +1,133 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+//
+// Summary mode (VerifierOptions::summarize_local_calls): an inlined call whose calling context
+// is covered by an earlier call of the same subprogram reuses that call's results.
+
+#include <catch2/catch_all.hpp>
+
+#include "test/test_programs.hpp"
+
+using namespace prevail;
+using namespace program_test;
+
+namespace {
+
+// With r6 = 3 saved across both calls, calls <sub> first with r1 = 0, then with r1 = `second_arg`.
+// <sub> returns r1 + r6.
+InstructionSeq two_calls(const uint64_t second_arg) {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(6, Imm{3})));
+    seq.push_back(at(1, mov(0, Imm{0})));
+    seq.push_back(at(2, mov(1, Imm{0})));
+    seq.push_back(at(3, CallLocal{.target = Label{9}}));
+    seq.push_back(at(4, mov(0, Imm{0})));
+    seq.push_back(at(5, mov(1, Imm{second_arg})));
+    seq.push_back(at(6, CallLocal{.target = Label{9}}));
+    seq.push_back(at(7, add(0, Reg{6})));
+    seq.push_back(at(8, Exit{}));
+    seq.push_back(at(9, mov(0, Reg{1})));
+    seq.push_back(at(10, add(0, Reg{6})));
+    seq.push_back(at(11, Exit{}));
+    return seq;
+}
+
+// Calls <g> with r6 = 1, then with r6 = 2. <g> sets r6 to 0 and calls <f>, so the two calls of
+// <f> differ only in the r6 that <g> saved. <f> returns r6 + 1; the program returns r0 + r6.
+InstructionSeq nested_calls() {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(6, Imm{1})));
+    seq.push_back(at(1, mov(0, Imm{0})));
+    seq.push_back(at(2, mov(1, Imm{0})));
+    seq.push_back(at(3, CallLocal{.target = Label{9}}));
+    seq.push_back(at(4, mov(6, Imm{2})));
+    seq.push_back(at(5, mov(1, Imm{0})));
+    seq.push_back(at(6, CallLocal{.target = Label{9}}));
+    seq.push_back(at(7, add(0, Reg{6})));
+    seq.push_back(at(8, Exit{}));
+    seq.push_back(at(9, mov(6, Imm{0})));
+    seq.push_back(at(10, mov(0, Imm{0})));
+    seq.push_back(at(11, CallLocal{.target = Label{13}}));
+    seq.push_back(at(12, Exit{}));
+    seq.push_back(at(13, mov(0, Reg{6})));
+    seq.push_back(at(14, add(0, Imm{1})));
+    seq.push_back(at(15, Exit{}));
+    return seq;
+}
+
+// Like two_calls, but the first call has r1 in [0, 1] and the second r1 = 0.
+InstructionSeq narrowing_calls() {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(6, Imm{3})));
+    seq.push_back(at(1, Call{.func = 7})); // bpf_get_prandom_u32
+    seq.push_back(at(2, mov(1, Reg{0})));
+    seq.push_back(at(3, Bin{.op = Bin::Op::AND, .dst = Reg{1}, .v = Imm{1}, .is64 = true}));
+    seq.push_back(at(4, mov(0, Imm{0})));
+    seq.push_back(at(5, CallLocal{.target = Label{11}}));
+    seq.push_back(at(6, mov(0, Imm{0})));
+    seq.push_back(at(7, mov(1, Imm{0})));
+    seq.push_back(at(8, CallLocal{.target = Label{11}}));
+    seq.push_back(at(9, add(0, Reg{6})));
+    seq.push_back(at(10, Exit{}));
+    seq.push_back(at(11, mov(0, Reg{1})));
+    seq.push_back(at(12, add(0, Reg{6})));
+    seq.push_back(at(13, Exit{}));
+    return seq;
+}
+
+struct Outcome {
+    AnalysisResult inlined;
+    AnalysisResult summarized;
+};
+
+// Analyze `seq` with and without summaries. Every state of the summarized analysis must cover
+// the inlined one, and equal it when `same_invariants`.
+Outcome analyze_both(const InstructionSeq& seq, const bool same_invariants = true) {
+    VerifierOptions options;
+    const Program prog = Program::from_sequence(seq, default_info(), options);
+    Outcome outcome{.inlined = analyze(AnalysisContext{prog, options})};
+    options.summarize_local_calls = true;
+    outcome.summarized = analyze(AnalysisContext{prog, options});
+    for (const auto& [label, inv] : outcome.inlined.invariants) {
+        const InvariantMapPair* other = outcome.summarized.invariants.find(label);
+        REQUIRE(other != nullptr);
+        REQUIRE(other->error.has_value() == inv.error.has_value());
+        REQUIRE(inv.pre <= other->pre);
+        REQUIRE(inv.post <= other->post);
+        if (same_invariants) {
+            REQUIRE(outcome.summarized.invariant_at(label) == outcome.inlined.invariant_at(label));
+        }
+    }
+    return outcome;
+}
+
+} // namespace
+
+TEST_CASE("a call with the calling context of an earlier call reuses its summary", "[summaries]") {
+    const Outcome outcome = analyze_both(two_calls(0));
+    REQUIRE(outcome.inlined.reused_call_summaries == 0);
+    REQUIRE(outcome.summarized.reused_call_summaries == 1);
+    REQUIRE(!outcome.summarized.failed);
+    REQUIRE(outcome.summarized.exit_value == Interval{6});
+}
+
+TEST_CASE("a call with a different calling context is analyzed again", "[summaries]") {
+    const Outcome outcome = analyze_both(two_calls(5));
+    REQUIRE(outcome.summarized.reused_call_summaries == 0);
+    REQUIRE(outcome.summarized.exit_value == Interval{11});
+}
+
+TEST_CASE("a call differing only in the registers its callers saved reuses its summary", "[summaries]") {
+    const Outcome outcome = analyze_both(nested_calls());
+    REQUIRE(outcome.summarized.reused_call_summaries == 1);
+    REQUIRE(!outcome.summarized.failed);
+    REQUIRE(outcome.summarized.exit_value == Interval{3});
+}
+
+TEST_CASE("a call with a narrower calling context than an earlier call reuses its summary", "[summaries]") {
+    const Outcome outcome = analyze_both(narrowing_calls(), false);
+    REQUIRE(outcome.inlined.exit_value == Interval{6});
+    REQUIRE(outcome.summarized.reused_call_summaries == 1);
+    REQUIRE(!outcome.summarized.failed);
+    REQUIRE(outcome.summarized.exit_value == Interval{6, 7});
+}
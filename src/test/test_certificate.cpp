@@ -0,0 +1,137 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+//
+// Invariant certificates (VerifierOptions::emit_certificate): the loop-head invariants of an accepted
+// program, checked again by check_certificate() in a single pass.
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include "crab_utils/prevail_errors.hpp"
+#include "test/test_programs.hpp"
+
+using namespace prevail;
+using namespace program_test;
+
+namespace {
+
+AnalysisContext certifying_context(const InstructionSeq& seq, VerifierOptions options = {}) {
+    options.emit_certificate = true;
+    return context_of(seq, options);
+}
+
+// for (r0 = 0; r0 < 10; r0++) { *(r10 - 8) = r0; r0 = *(r10 - 8); }
+InstructionSeq stack_loop() {
+    const Deref slot{.width = 8, .basereg = Reg{R10_STACK_POINTER}, .offset = -8};
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(0, Imm{0})));
+    seq.push_back(at(1, jump_if_ge(0, 10, 6)));
+    seq.push_back(at(2, Mem{.access = slot, .value = Reg{0}, .is_load = false}));
+    seq.push_back(at(3, Mem{.access = slot, .value = Reg{0}, .is_load = true}));
+    seq.push_back(at(4, add(0, Imm{1})));
+    seq.push_back(at(5, Jmp{.target = Label{1}}));
+    seq.push_back(at(6, Exit{}));
+    return seq;
+}
+
+} // namespace
+
+TEST_CASE("certificate of an accepted program checks in one pass", "[certificate]") {
+    const AnalysisContext context = certifying_context(nested_loops());
+    const AnalysisResult analyzed = analyze(context);
+    REQUIRE(!analyzed.failed);
+    REQUIRE(analyzed.certificate.has_value());
+    REQUIRE(analyzed.certificate->loop_heads.size() == 2);
+
+    const AnalysisResult checked = check_certificate(context, *analyzed.certificate);
+    REQUIRE(!checked.failed);
+    REQUIRE(checked.steps < analyzed.steps);
+    REQUIRE(checked.steps <= context.program.cfg().size());
+}
+
+TEST_CASE("certificate is kept in verdict mode", "[certificate]") {
+    VerifierOptions options;
+    options.retain_invariants = false;
+    const AnalysisContext context = certifying_context(nested_loops(), options);
+    const AnalysisResult analyzed = analyze(context);
+    REQUIRE(analyzed.certificate.has_value());
+    REQUIRE(analyzed.certificate->loop_heads.size() == 2);
+    REQUIRE(!check_certificate(context, *analyzed.certificate).failed);
+}
+
+TEST_CASE("failing program has no certificate", "[certificate]") {
+    const AnalysisResult analyzed = analyze(certifying_context(failing_loop()));
+    REQUIRE(analyzed.failed);
+    REQUIRE(!analyzed.certificate.has_value());
+}
+
+TEST_CASE("certificate without the invariant of a loop head is rejected", "[certificate]") {
+    const AnalysisContext context = certifying_context(nested_loops());
+    InvariantCertificate certificate = *analyze(context).certificate;
+    certificate.loop_heads.erase(certificate.loop_heads.begin());
+    const AnalysisResult checked = check_certificate(context, certificate);
+    REQUIRE(checked.failed);
+    REQUIRE(checked.find_first_error().has_value());
+}
+
+TEST_CASE("certificate of another program is rejected", "[certificate]") {
+    const InvariantCertificate certificate = *analyze(certifying_context(nested_loops())).certificate;
+    const AnalysisContext other = certifying_context(nested_loops(6));
+    REQUIRE(certificate_hash(other) != certificate.program_hash);
+    const AnalysisResult checked = check_certificate(other, certificate);
+    REQUIRE(checked.failed);
+    REQUIRE(checked.find_first_error()->where == Label::entry);
+}
+
+TEST_CASE("states read back from their text are equal to the states written", "[certificate]") {
+    const AnalysisContext context = certifying_context(stack_loop());
+    const AnalysisResult analyzed = analyze(context);
+    REQUIRE(!analyzed.failed);
+    bool has_cells = false;
+    for (const auto& [label, inv] : analyzed.invariants) {
+        const EbpfDomain back = EbpfDomain::from_text(inv.pre.to_text(), context);
+        REQUIRE(back <= inv.pre);
+        REQUIRE(inv.pre <= back);
+        // The same constraints and stack cells, in whatever order.
+        const std::vector<std::string> text = inv.pre.to_text();
+        const std::vector<std::string> back_text = back.to_text();
+        REQUIRE(std::set(back_text.begin(), back_text.end()) == std::set(text.begin(), text.end()));
+        has_cells |= std::ranges::any_of(text, [](const std::string& line) { return line.starts_with("cell"); });
+    }
+    REQUIRE(has_cells);
+}
+
+TEST_CASE("certificate read back from its text on another thread checks", "[certificate]") {
+    for (const InstructionSeq& seq : {nested_loops(), stack_loop()}) {
+        const AnalysisResult analyzed = analyze(certifying_context(seq));
+        REQUIRE(analyzed.certificate.has_value());
+        const std::string text = serialize_certificate(*analyzed.certificate);
+
+        // A new thread starts with its own VariableRegistry, which numbers variables in the order
+        // it meets them.
+        size_t heads = 0;
+        bool accepted = false;
+        std::thread{[&] {
+            const AnalysisContext context = certifying_context(seq);
+            const InvariantCertificate certificate = parse_certificate(text, context);
+            heads = certificate.loop_heads.size();
+            const AnalysisResult checked = check_certificate(context, certificate);
+            accepted = !checked.failed && checked.steps <= context.program.cfg().size();
+        }}.join();
+        REQUIRE(heads == analyzed.certificate->loop_heads.size());
+        REQUIRE(accepted);
+    }
+}
+
+TEST_CASE("malformed certificate text is rejected", "[certificate]") {
+    const AnalysisContext context = certifying_context(nested_loops());
+    const std::string text = serialize_certificate(*analyze(context).certificate);
+    REQUIRE_THROWS_AS(parse_certificate("head 1\n" + text, context), RuntimeInputError);
+    REQUIRE_THROWS_AS(parse_certificate(text + "head 42\n", context), RuntimeInputError);
+    REQUIRE_THROWS_AS(parse_certificate(text + "value\t<=0\tx\n", context), RuntimeInputError);
+}
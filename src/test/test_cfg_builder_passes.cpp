@@ -5,6 +5,7 @@
 // Each test exercises an invariant that is otherwise implicit in the pipeline and
 // would silently break if a pass were reordered, skipped, or modified.
 
+#include <algorithm>
 #include <optional>
 
 #include <catch2/catch_all.hpp>
@@ -220,3 +221,27 @@ TEST_CASE("pass_extract_assertions populates assertions for every label in the C
         REQUIRE_NOTHROW(prog.assertions_at(label));
     }
 }
+
+TEST_CASE("finalized Program interns labels to dense ids in Label order", "[passes]") {
+    const ProgramInfo info = default_info();
+    InstructionSeq seq;
+    seq.push_back(at(0, Jmp{.cond = eq0_zero_is64(), .target = Label{2}}));
+    seq.push_back(at(1, Exit{}));
+    seq.push_back(at(2, Exit{}));
+
+    const Program prog = Program::from_sequence(seq, info, {});
+    const Cfg& cfg = prog.cfg();
+    REQUIRE(cfg.size() == prog.labels().size());
+    REQUIRE(std::ranges::is_sorted(prog.labels()));
+    for (LabelId id = 0; id < cfg.size(); ++id) {
+        const Label& label = cfg.label_of(id);
+        REQUIRE(cfg.id_of(label) == id);
+        REQUIRE(&prog.instruction_at(id) == &prog.instruction_at(label));
+        for (const LabelId child : cfg.children_of(id)) {
+            REQUIRE(std::ranges::find(cfg.parents_of(child), id) != cfg.parents_of(child).end());
+        }
+    }
+    REQUIRE(cfg.label_of(cfg.entry_id()) == Label::entry);
+    REQUIRE(cfg.label_of(cfg.exit_id()) == Label::exit);
+    REQUIRE_FALSE(cfg.contains(Label{7}));
+}
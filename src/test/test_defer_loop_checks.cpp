@@ -0,0 +1,154 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+//
+// Deferred checking (VerifierOptions::defer_loop_checks): the assertions of loop labels are checked
+// once, after their outermost loop has stabilized.
+
+#include <catch2/catch_all.hpp>
+
+#include "crab/var_registry.hpp"
+#include "test/test_programs.hpp"
+
+using namespace prevail;
+using namespace program_test;
+
+namespace {
+
+// for (r0 = 0; r0 < 10; r0++) { for (r1 = 0; r1 < 5; r1++) { r1 += r3; } } where r3 has no known type.
+InstructionSeq failing_inner_loop() {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(0, Imm{0})));
+    seq.push_back(at(1, jump_if_ge(0, 10, 8)));
+    seq.push_back(at(2, mov(1, Imm{0})));
+    seq.push_back(at(3, jump_if_ge(1, 5, 6)));
+    seq.push_back(at(4, add(1, Reg{3})));
+    seq.push_back(at(5, Jmp{.target = Label{3}}));
+    seq.push_back(at(6, add(0, Imm{1})));
+    seq.push_back(at(7, Jmp{.target = Label{1}}));
+    seq.push_back(at(8, Exit{}));
+    return seq;
+}
+
+struct Outcome {
+    AnalysisResult eager;
+    AnalysisResult deferred;
+};
+
+Outcome analyze_both(const InstructionSeq& seq, VerifierOptions options = {}) {
+    const Program prog = Program::from_sequence(seq, default_info(), options);
+    Outcome outcome{.eager = analyze(AnalysisContext{prog, options})};
+    options.defer_loop_checks = true;
+    outcome.deferred = analyze(AnalysisContext{prog, options});
+    REQUIRE(outcome.deferred.failed == outcome.eager.failed);
+    return outcome;
+}
+
+} // namespace
+
+TEST_CASE("deferred checks leave the invariants of a safe program unchanged", "[defer_loop_checks]") {
+    const Outcome outcome = analyze_both(nested_loops());
+    REQUIRE(!outcome.deferred.failed);
+    for (const auto& [label, inv] : outcome.eager.invariants) {
+        REQUIRE(outcome.deferred.invariant_at(label) == outcome.eager.invariant_at(label));
+    }
+    REQUIRE(outcome.deferred.exit_value == Interval{10});
+}
+
+TEST_CASE("deferred checks report the error of a loop once it has stabilized", "[defer_loop_checks]") {
+    const Outcome outcome = analyze_both(failing_inner_loop());
+    REQUIRE(outcome.deferred.failed);
+    // The failing addition still computes a post-state, so the head of the inner loop, which
+    // compares r1, fails as well.
+    const auto eager = outcome.eager.find_first_error();
+    REQUIRE(eager.has_value());
+    REQUIRE(eager->where.has_value());
+    REQUIRE(outcome.deferred.invariants.find(*eager->where)->error.has_value());
+    REQUIRE(outcome.deferred.invariants.find(Label{3})->error.has_value());
+}
+
+TEST_CASE("deferred checks work in verdict mode and with parallel analysis", "[defer_loop_checks]") {
+    VerifierOptions options;
+    options.retain_invariants = false;
+    options.analysis_threads = 2;
+    REQUIRE(analyze_both(failing_inner_loop(), options).deferred.failed);
+    REQUIRE(!analyze_both(nested_loops(), options).deferred.failed);
+}
+
+TEST_CASE("deferred checks of a long loop body give the same errors on any number of threads",
+          "[defer_loop_checks]") {
+    // for (r0 = 0; r0 < 10; r0++) { r1 += 1; r2 += r3; ... } with 400 instructions in the body,
+    // so that the checks of the loop are split into several tasks.
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(0, Imm{0})));
+    seq.push_back(at(1, mov(1, Imm{0})));
+    seq.push_back(at(2, jump_if_ge(0, 10, 405)));
+    for (int i = 3; i < 403; ++i) {
+        seq.push_back(at(i, i % 50 == 0 ? add(2, Reg{3}) : add(1, Imm{1})));
+    }
+    seq.push_back(at(403, add(0, Imm{1})));
+    seq.push_back(at(404, Jmp{.target = Label{2}}));
+    seq.push_back(at(405, Exit{}));
+
+    VerifierOptions options;
+    options.defer_loop_checks = true;
+    const Program prog = Program::from_sequence(seq, default_info(), options);
+    const AnalysisResult sequential = analyze(AnalysisContext{prog, options});
+    options.analysis_threads = 4;
+    const AnalysisResult parallel = analyze(AnalysisContext{prog, options});
+    REQUIRE(sequential.failed);
+    REQUIRE(parallel.failed);
+    for (const auto& [label, inv] : sequential.invariants) {
+        REQUIRE(parallel.invariants.find(label)->error.has_value() == inv.error.has_value());
+    }
+    REQUIRE(parallel.find_first_error()->where == sequential.find_first_error()->where);
+}
+
+TEST_CASE("deferred checks of loops on both sides of a branch give the same errors on any number of threads",
+          "[defer_loop_checks]") {
+    // if (r1 == 0) { loop } else { loop }, each loop with 200 instructions in its body, so that both
+    // loops stabilize concurrently and split their checks into tasks of the same pool. Only the
+    // second loop fails, on r2 += r3.
+    constexpr int body = 200;
+    constexpr int second = 1 + body + 6;
+    InstructionSeq seq;
+    seq.push_back(at(0, Jmp{.cond = Condition{.op = Condition::Op::EQ, .left = Reg{1}, .right = Imm{0}, .is64 = true},
+                            .target = Label{second}}));
+    const auto append_loop = [&](const int first, const bool failing) {
+        const int head = first + 2;
+        const int exit = head + body + 3;
+        seq.push_back(at(first, mov(2, Imm{0})));
+        seq.push_back(at(first + 1, mov(0, Imm{0})));
+        seq.push_back(at(head, jump_if_ge(0, 10, exit)));
+        for (int i = head + 1; i <= head + body; ++i) {
+            seq.push_back(at(i, failing && i % 50 == 0 ? add(2, Reg{3}) : add(2, Imm{1})));
+        }
+        seq.push_back(at(head + body + 1, add(0, Imm{1})));
+        seq.push_back(at(head + body + 2, Jmp{.target = Label{head}}));
+        seq.push_back(at(exit, Exit{}));
+    };
+    append_loop(1, false);
+    append_loop(second, true);
+
+    VerifierOptions options;
+    options.defer_loop_checks = true;
+    const auto analyze_on = [&](const size_t threads) {
+        options.analysis_threads = threads;
+        const EbpfDomain entry =
+            EbpfDomain::from_constraints({{variable_registry.type_reg(1), TypeSet{T_NUM}}}, {});
+        return analyze(entry, context_of(seq, options));
+    };
+    const AnalysisResult sequential = analyze_on(1);
+    REQUIRE(sequential.failed);
+    for (const auto& [label, inv] : sequential.invariants) {
+        if (label.from < second) {
+            REQUIRE(!inv.error.has_value());
+        }
+    }
+    for (int run = 0; run < 4; ++run) {
+        const AnalysisResult parallel = analyze_on(4);
+        REQUIRE(parallel.failed);
+        for (const auto& [label, inv] : sequential.invariants) {
+            REQUIRE(parallel.invariants.find(label)->error.has_value() == inv.error.has_value());
+        }
+    }
+}
@@ -0,0 +1,56 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+//
+// Worklist engine (VerifierOptions::incremental_loops): loop iterations transform only the labels
+// whose inputs changed, with the same invariants as the default engine.
+
+#include <catch2/catch_all.hpp>
+
+#include "test/test_programs.hpp"
+
+using namespace prevail;
+using namespace program_test;
+
+namespace {
+
+struct Outcome {
+    AnalysisResult plain;
+    AnalysisResult incremental;
+};
+
+Outcome analyze_both(const InstructionSeq& seq, VerifierOptions options = {}) {
+    const Program prog = Program::from_sequence(seq, default_info(), options);
+    Outcome outcome{.plain = analyze(AnalysisContext{prog, options})};
+    options.incremental_loops = true;
+    outcome.incremental = analyze(AnalysisContext{prog, options});
+    REQUIRE(outcome.incremental.failed == outcome.plain.failed);
+    for (const auto& [label, inv] : outcome.plain.invariants) {
+        const InvariantMapPair* other = outcome.incremental.invariants.find(label);
+        REQUIRE(other != nullptr);
+        REQUIRE(other->error.has_value() == inv.error.has_value());
+        REQUIRE(outcome.incremental.invariant_at(label) == outcome.plain.invariant_at(label));
+    }
+    return outcome;
+}
+
+} // namespace
+
+TEST_CASE("the worklist engine computes the same invariants with fewer transfer functions", "[incremental]") {
+    const Outcome outcome = analyze_both(nested_loops());
+    REQUIRE(!outcome.incremental.failed);
+    REQUIRE(outcome.incremental.exit_value == Interval{10});
+    REQUIRE(outcome.incremental.steps < outcome.plain.steps);
+}
+
+TEST_CASE("the worklist engine reports the same errors", "[incremental]") {
+    const Outcome outcome = analyze_both(failing_loop());
+    REQUIRE(outcome.incremental.failed);
+    REQUIRE(outcome.incremental.steps <= outcome.plain.steps);
+}
+
+TEST_CASE("the worklist engine agrees with the default engine under termination checking", "[incremental]") {
+    VerifierOptions options;
+    options.runtime.check_for_termination = true;
+    const Outcome outcome = analyze_both(nested_loops(), options);
+    REQUIRE(outcome.incremental.max_loop_count == outcome.plain.max_loop_count);
+}
@@ -0,0 +1,85 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+//
+// Interval pre-pass (VerifierOptions::interval_pre_pass): a program is first analyzed with intervals
+// only, and again with zones only if that pass reports an error.
+
+#include <catch2/catch_all.hpp>
+
+#include "arith/dsl_syntax.hpp"
+#include "crab/ebpf_domain.hpp"
+#include "crab/zone_domain.hpp"
+#include "test/test_programs.hpp"
+
+using namespace prevail;
+using namespace program_test;
+
+namespace {
+
+// for (r0 = 0, r1 = 0; r0 < 10; r0++, r1++) {} *(u64*)(r10 - r1 - 16) = 0;
+// Only the relation r0 == r1 bounds r1 after the loop, and with it the stack access.
+InstructionSeq two_counters() {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(0, Imm{0})));
+    seq.push_back(at(1, mov(1, Imm{0})));
+    seq.push_back(at(2, jump_if_ge(0, 10, 6)));
+    seq.push_back(at(3, add(0, Imm{1})));
+    seq.push_back(at(4, add(1, Imm{1})));
+    seq.push_back(at(5, Jmp{.target = Label{2}}));
+    seq.push_back(at(6, mov(2, Reg{10})));
+    seq.push_back(at(7, Bin{.op = Bin::Op::SUB, .dst = Reg{2}, .v = Reg{1}, .is64 = true}));
+    seq.push_back(at(8, Mem{.access = Deref{.width = 8, .basereg = Reg{2}, .offset = -16}, .value = Imm{0}}));
+    seq.push_back(at(9, mov(0, Imm{0})));
+    seq.push_back(at(10, Exit{}));
+    return seq;
+}
+
+// The same loop without the store: intervals are enough.
+InstructionSeq no_access() {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(0, Imm{0})));
+    seq.push_back(at(1, mov(1, Imm{0})));
+    seq.push_back(at(2, jump_if_ge(0, 10, 6)));
+    seq.push_back(at(3, add(0, Imm{1})));
+    seq.push_back(at(4, add(1, Imm{1})));
+    seq.push_back(at(5, Jmp{.target = Label{2}}));
+    seq.push_back(at(6, mov(0, Imm{0})));
+    seq.push_back(at(7, Exit{}));
+    return seq;
+}
+
+} // namespace
+
+TEST_CASE("the interval pre-pass decides a program that intervals verify", "[interval_pre_pass]") {
+    VerifierOptions options;
+    options.interval_pre_pass = true;
+    const AnalysisResult result = analyze_sequence(no_access(), options);
+    REQUIRE(!result.failed);
+    REQUIRE(result.tier == AnalysisTier::intervals);
+    REQUIRE(result.exit_value == Interval{0});
+}
+
+TEST_CASE("the interval pre-pass defers to zones when a relation is needed", "[interval_pre_pass]") {
+    VerifierOptions options;
+    REQUIRE(!analyze_sequence(two_counters(), options).failed);
+
+    options.interval_pre_pass = true;
+    const AnalysisResult result = analyze_sequence(two_counters(), options);
+    REQUIRE(!result.failed);
+    REQUIRE(result.tier == AnalysisTier::zones);
+}
+
+TEST_CASE("an interval-only zone domain records no relation", "[interval_pre_pass]") {
+    using namespace dsl_syntax;
+    const Variable x = reg_pack(0).svalue;
+    const Variable y = reg_pack(1).svalue;
+    const auto x_bound_after = [&](const bool intervals_only) {
+        const ZoneDomain::IntervalsOnly scope{intervals_only};
+        ZoneDomain dom;
+        REQUIRE(dom.add_constraint(x <= y));
+        REQUIRE(dom.add_constraint(y <= 5));
+        return dom.eval_interval(x).ub();
+    };
+    REQUIRE(x_bound_after(false) == Bound{5});
+    REQUIRE(x_bound_after(true).is_infinite());
+}
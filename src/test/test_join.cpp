@@ -1,10 +1,13 @@
 // Copyright (c) Prevail Verifier contributors.
 // SPDX-License-Identifier: MIT
+#include <array>
+
 #include <catch2/catch_all.hpp>
 
 #include "arith/dsl_syntax.hpp"
 #include "crab/ebpf_domain.hpp"
 #include "crab/splitdbm/split_dbm.hpp"
+#include "crab/zone_domain.hpp"
 
 using namespace prevail;
 
@@ -374,6 +377,46 @@ TEST_CASE("join preserves multi-register per-type field", "[join][lattice]") {
                  {r6.packet_offset == 4, r7.stack_offset == 128});
 }
 
+TEST_CASE("n-ary join agrees with pairwise joins on numbers", "[join][lattice]") {
+    using namespace dsl_syntax;
+    const TypeRestrictions nums{{r0_type, TypeSet{T_NUM}}, {r1_type, TypeSet{T_NUM}}};
+    const EbpfDomain a = EbpfDomain::from_constraints(nums, {r0.svalue == 1, r1.svalue >= 0, r1.svalue <= 4});
+    const EbpfDomain b = EbpfDomain::from_constraints(nums, {r0.svalue == 2, r1.svalue == 7, r0.svalue <= r1.svalue});
+    const EbpfDomain c = EbpfDomain::from_constraints(nums, {r0.svalue == 3, r1.svalue == 3});
+    const EbpfDomain bot = EbpfDomain::bottom();
+
+    const std::array doms{&a, &bot, &b, &c};
+    const EbpfDomain joined = EbpfDomain::join(doms);
+    const EbpfDomain folded = (a | b) | c;
+    REQUIRE(joined <= folded);
+    REQUIRE(folded <= joined);
+
+    const std::array single{&bot, &b};
+    REQUIRE(EbpfDomain::join(single) <= b);
+    REQUIRE(b <= EbpfDomain::join(single));
+    const std::array none{&bot};
+    REQUIRE(EbpfDomain::join(none).is_bottom());
+}
+
+TEST_CASE("n-ary join keeps type-dependent offsets of every operand", "[join][lattice]") {
+    using namespace dsl_syntax;
+    const EbpfDomain a = EbpfDomain::from_constraints({{r0_type, TypeSet{T_NUM}}, {r1_type, TypeSet{T_NUM}}},
+                                                      {r0.svalue == 1, r1.svalue >= 0, r1.svalue <= 4});
+    const EbpfDomain b = EbpfDomain::from_constraints({{r0_type, TypeSet{T_PACKET}}, {r1_type, TypeSet{T_NUM}}},
+                                                      {r0.packet_offset == 8, r1.svalue == 7});
+    const EbpfDomain c = EbpfDomain::from_constraints({{r0_type, TypeSet{T_PACKET}}, {r1_type, TypeSet{T_NUM}}},
+                                                      {r0.packet_offset == 12, r1.svalue == 3});
+
+    const std::array doms{&a, &b, &c};
+    const EbpfDomain joined = EbpfDomain::join(doms);
+    REQUIRE(a <= joined);
+    REQUIRE(b <= joined);
+    REQUIRE(c <= joined);
+    REQUIRE(joined <= EbpfDomain::from_constraints({{r0_type, TypeSet{T_NUM, T_PACKET}}, {r1_type, TypeSet{T_NUM}}},
+                                                   {r0.svalue == 1, r0.packet_offset >= 8, r0.packet_offset <= 12,
+                                                    r1.svalue >= 0, r1.svalue <= 7}));
+}
+
 // 22) SplitDBM widen closure
 TEST_CASE("close_after_widen recovers transitive edge through unstable vertex", "[widen][splitdbm]") {
     using namespace splitdbm;
@@ -0,0 +1,66 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+//
+// Lazy narrowing (VerifierOptions::lazy_narrowing): loops stop at the post-fixpoint of their widening
+// sequence, and are narrowed only when an error of that pass is reachable from them.
+
+#include <catch2/catch_all.hpp>
+
+#include "test/test_programs.hpp"
+
+using namespace prevail;
+using namespace program_test;
+
+namespace {
+
+// for (r1 = 0; r1 < 10; r1++) {} *(u64*)(r10 + r1 - 26) = 0;
+// After widening, r1 has no upper bound at the exit of the loop; narrowing brings it back to 10.
+InstructionSeq access_after_loop() {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(1, Imm{0})));
+    seq.push_back(at(1, jump_if_ge(1, 10, 4)));
+    seq.push_back(at(2, add(1, Imm{1})));
+    seq.push_back(at(3, Jmp{.target = Label{1}}));
+    seq.push_back(at(4, mov(2, Reg{10})));
+    seq.push_back(at(5, add(2, Reg{1})));
+    seq.push_back(at(6, Mem{.access = Deref{.width = 8, .basereg = Reg{2}, .offset = -26}, .value = Imm{0}}));
+    seq.push_back(at(7, mov(0, Imm{0})));
+    seq.push_back(at(8, Exit{}));
+    return seq;
+}
+
+struct Outcome {
+    AnalysisResult eager;
+    AnalysisResult lazy;
+};
+
+Outcome analyze_both(const InstructionSeq& seq) {
+    VerifierOptions options;
+    const Program prog = Program::from_sequence(seq, default_info(), options);
+    Outcome outcome{.eager = analyze(AnalysisContext{prog, options})};
+    options.lazy_narrowing = true;
+    outcome.lazy = analyze(AnalysisContext{prog, options});
+    REQUIRE(outcome.lazy.failed == outcome.eager.failed);
+    return outcome;
+}
+
+} // namespace
+
+TEST_CASE("lazy narrowing accepts a safe program without descending iterations", "[lazy_narrowing]") {
+    const Outcome outcome = analyze_both(nested_loops());
+    REQUIRE(!outcome.lazy.failed);
+    REQUIRE(outcome.lazy.steps < outcome.eager.steps);
+}
+
+TEST_CASE("lazy narrowing narrows a loop whose widened invariant leaves an error", "[lazy_narrowing]") {
+    const Outcome outcome = analyze_both(access_after_loop());
+    REQUIRE(!outcome.lazy.failed);
+}
+
+TEST_CASE("lazy narrowing reports the errors of a failing loop", "[lazy_narrowing]") {
+    const Outcome outcome = analyze_both(failing_loop());
+    REQUIRE(outcome.lazy.failed);
+    for (const auto& [label, inv] : outcome.eager.invariants) {
+        REQUIRE(outcome.lazy.invariants.find(label)->error.has_value() == inv.error.has_value());
+    }
+}
@@ -0,0 +1,97 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+//
+// Liveness of registers and stack slots, and its use by the analysis to forget dead variables at
+// joins and loop heads (VerifierOptions::forget_dead_variables).
+
+#include <ranges>
+
+#include <catch2/catch_all.hpp>
+#include <gsl/narrow>
+
+#include "ir/liveness.hpp"
+#include "test/test_programs.hpp"
+
+using namespace prevail;
+using namespace program_test;
+
+namespace {
+
+Instruction stack_access(const bool is_load, const uint8_t reg, const int32_t offset) {
+    return Mem{.access = Deref{.width = 8, .basereg = Reg{R10_STACK_POINTER}, .offset = offset},
+               .value = Reg{reg},
+               .is_load = is_load};
+}
+
+Program build(const InstructionSeq& seq) {
+    VerifierOptions options;
+    options.forget_dead_variables = true;
+    return Program::from_sequence(seq, default_info(), options);
+}
+
+bool mentions(const StringInvariant& inv, const std::string& reg) {
+    return std::ranges::any_of(inv.value(), [&](const std::string& cst) { return cst.starts_with(reg + "."); });
+}
+
+} // namespace
+
+TEST_CASE("a register is live from its last write to its reads", "[liveness]") {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(1, Imm{1})));
+    seq.push_back(at(1, mov(2, Imm{2})));
+    seq.push_back(at(2, mov(0, Reg{1})));
+    seq.push_back(at(3, Exit{}));
+    const Program prog = build(seq);
+    REQUIRE(prog.liveness() != nullptr);
+    const Liveness& liveness = *prog.liveness();
+    const auto live = [&](const int label, const uint8_t reg) {
+        return liveness.is_live(prog.cfg().id_of(Label{label}), Reg{reg});
+    };
+    REQUIRE(!live(0, 1));
+    REQUIRE(live(1, 1));
+    REQUIRE(live(2, 1));
+    REQUIRE(!live(2, 2));
+    REQUIRE(!live(2, 0));
+    REQUIRE(live(3, 0));
+    REQUIRE(live(3, R10_STACK_POINTER));
+    REQUIRE(liveness.is_live(prog.cfg().exit_id(), Reg{R0_RETURN_VALUE}));
+}
+
+TEST_CASE("a stack slot is live from a store at a constant offset to its loads", "[liveness]") {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(1, Imm{1})));
+    seq.push_back(at(1, stack_access(false, 1, -8)));
+    seq.push_back(at(2, stack_access(true, 0, -8)));
+    seq.push_back(at(3, Exit{}));
+    const Program prog = build(seq);
+    const Liveness& liveness = *prog.liveness();
+    const size_t slot = (gsl::narrow<size_t>(RuntimeConfig{}.total_stack_size()) - 8) / Liveness::SLOT_SIZE;
+    REQUIRE(liveness.slot_count() == gsl::narrow<size_t>(RuntimeConfig{}.total_stack_size()) / Liveness::SLOT_SIZE);
+    REQUIRE(!liveness.is_live_slot(prog.cfg().id_of(Label{1}), slot));
+    REQUIRE(liveness.is_live_slot(prog.cfg().id_of(Label{2}), slot));
+    REQUIRE(!liveness.is_live_slot(prog.cfg().id_of(Label{2}), slot - 1));
+    REQUIRE(!liveness.is_live_slot(prog.cfg().id_of(Label{3}), slot));
+}
+
+TEST_CASE("dead registers are forgotten at loop heads without changing the verdict", "[liveness]") {
+    // r3 = 7; for (r0 = 0; r0 < 10; r0++) { r3 = r0; }: r3 is dead at the loop head.
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(0, Imm{0})));
+    seq.push_back(at(1, mov(3, Imm{7})));
+    seq.push_back(at(2, jump_if_ge(0, 10, 6)));
+    seq.push_back(at(3, mov(3, Reg{0})));
+    seq.push_back(at(4, add(0, Imm{1})));
+    seq.push_back(at(5, Jmp{.target = Label{2}}));
+    seq.push_back(at(6, Exit{}));
+
+    VerifierOptions options;
+    const AnalysisResult kept = analyze_sequence(seq, options);
+    options.forget_dead_variables = true;
+    const AnalysisResult forgotten = analyze_sequence(seq, options);
+
+    REQUIRE(!forgotten.failed);
+    REQUIRE(forgotten.exit_value == kept.exit_value);
+    REQUIRE(mentions(kept.invariant_at(Label{2}), "r3"));
+    REQUIRE(!mentions(forgotten.invariant_at(Label{2}), "r3"));
+    REQUIRE(mentions(forgotten.invariant_at(Label{2}), "r0"));
+}
@@ -0,0 +1,92 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#pragma once
+
+// Small programs built instruction by instruction, shared by the tests of the analysis options.
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "analysis_context.hpp"
+#include "ir/program.hpp"
+#include "ir/syntax.hpp"
+#include "platform.hpp"
+#include "verifier.hpp"
+
+namespace program_test {
+
+using namespace prevail;
+
+inline ProgramInfo default_info() {
+    return ProgramInfo{
+        .platform = &g_ebpf_platform_linux,
+        .type = g_ebpf_platform_linux.get_program_type("unspec", "unspec"),
+    };
+}
+
+inline LabeledInstruction at(const int index, Instruction ins) {
+    return {Label{index}, std::move(ins), std::nullopt};
+}
+
+inline Instruction mov(const uint8_t dst, const Value& v) {
+    return Bin{.op = Bin::Op::MOV, .dst = Reg{dst}, .v = v, .is64 = true};
+}
+
+inline Instruction add(const uint8_t dst, const Value& v) {
+    return Bin{.op = Bin::Op::ADD, .dst = Reg{dst}, .v = v, .is64 = true};
+}
+
+inline Instruction jump_if_ge(const uint8_t reg, const int32_t bound, const int target) {
+    return Jmp{.cond = Condition{.op = Condition::Op::GE, .left = Reg{reg}, .right = Imm{static_cast<uint64_t>(bound)},
+                                 .is64 = true},
+               .target = Label{target}};
+}
+
+// for (r0 = `start`; r0 < 10; r0++) {}
+inline InstructionSeq counting_loop(const uint64_t start = 0) {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(0, Imm{start})));
+    seq.push_back(at(1, jump_if_ge(0, 10, 4)));
+    seq.push_back(at(2, add(0, Imm{1})));
+    seq.push_back(at(3, Jmp{.target = Label{1}}));
+    seq.push_back(at(4, Exit{}));
+    return seq;
+}
+
+// for (r0 = 0; r0 < 10; r0++) { for (r1 = 0; r1 < `inner_bound`; r1++) {} }
+inline InstructionSeq nested_loops(const int32_t inner_bound = 5) {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(0, Imm{0})));
+    seq.push_back(at(1, jump_if_ge(0, 10, 8)));
+    seq.push_back(at(2, mov(1, Imm{0})));
+    seq.push_back(at(3, jump_if_ge(1, inner_bound, 6)));
+    seq.push_back(at(4, add(1, Imm{1})));
+    seq.push_back(at(5, Jmp{.target = Label{3}}));
+    seq.push_back(at(6, add(0, Imm{1})));
+    seq.push_back(at(7, Jmp{.target = Label{1}}));
+    seq.push_back(at(8, Exit{}));
+    return seq;
+}
+
+// for (r0 = 0; r0 < 10; r0++) { r0 += r3; } where r3 has no known type.
+inline InstructionSeq failing_loop() {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(0, Imm{0})));
+    seq.push_back(at(1, jump_if_ge(0, 10, 5)));
+    seq.push_back(at(2, add(0, Reg{3})));
+    seq.push_back(at(3, add(0, Imm{1})));
+    seq.push_back(at(4, Jmp{.target = Label{1}}));
+    seq.push_back(at(5, Exit{}));
+    return seq;
+}
+
+inline AnalysisContext context_of(const InstructionSeq& seq, const VerifierOptions& options = {}) {
+    return AnalysisContext{Program::from_sequence(seq, default_info(), options), options};
+}
+
+inline AnalysisResult analyze_sequence(const InstructionSeq& seq, const VerifierOptions& options = {}) {
+    return analyze(context_of(seq, options));
+}
+
+} // namespace program_test
@@ -0,0 +1,136 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+//
+// Hash-consing of states and the cache of lattice operations (StateMemo,
+// VerifierOptions::memoize_lattice_operations).
+
+#include <array>
+
+#include <catch2/catch_all.hpp>
+
+#include "arith/dsl_syntax.hpp"
+#include "crab/state_memo.hpp"
+#include "test/test_programs.hpp"
+
+using namespace prevail;
+using namespace program_test;
+
+namespace {
+
+const RegPack r0 = reg_pack(0);
+const RegPack r1 = reg_pack(1);
+const Variable r0_type = reg_type(Reg{0});
+const Variable r1_type = reg_type(Reg{1});
+
+EbpfDomain numbers(const std::vector<LinearConstraint>& csts) {
+    return EbpfDomain::from_constraints({{r0_type, TypeSet{T_NUM}}, {r1_type, TypeSet{T_NUM}}}, csts);
+}
+
+} // namespace
+
+TEST_CASE("identical states are interned once", "[memo]") {
+    using namespace dsl_syntax;
+    // Built in a different order, so the packs and DSU ids differ.
+    const EbpfDomain a = numbers({r0.svalue >= 0, r0.svalue <= 5, r1.svalue == 3});
+    const EbpfDomain b = numbers({r1.svalue == 3, r0.svalue <= 5, r0.svalue >= 0});
+    const EbpfDomain c = numbers({r0.svalue >= 0, r0.svalue <= 6, r1.svalue == 3});
+    REQUIRE(a.identical(b));
+    REQUIRE(a.hash() == b.hash());
+    REQUIRE(!a.identical(c));
+
+    StateMemo memo;
+    REQUIRE(memo.intern(a) == memo.intern(b));
+    REQUIRE(memo.intern(a) != memo.intern(c));
+    REQUIRE(memo.intern(EbpfDomain::bottom()) != memo.intern(a));
+}
+
+TEST_CASE("states that list different stack cells are interned apart", "[memo]") {
+    // The same values and the same numeric bytes; only the cells the stack registry lists differ.
+    NumAbsDomain values = NumAbsDomain::top();
+    const auto with_cell = [&] {
+        ArrayDomain stack{512};
+        REQUIRE(stack.store(values, DataKind::svalues, Interval{8}, Interval{8}, false).has_value());
+        return stack;
+    };
+    const ArrayDomain first = with_cell();
+    const ArrayDomain second = with_cell();
+    const EbpfDomain plain{TypeToNumDomain{TypeDomain{}, values}, ArrayDomain{512}};
+    const EbpfDomain a{TypeToNumDomain{TypeDomain{}, values}, first};
+    const EbpfDomain b{TypeToNumDomain{TypeDomain{}, values}, second};
+    REQUIRE(plain <= a);
+    REQUIRE(a <= plain);
+    REQUIRE(!plain.identical(a));
+
+    // Registries with the same cells are interchangeable, even when they are different objects.
+    REQUIRE(a.identical(b));
+    REQUIRE(a.hash() == b.hash());
+
+    StateMemo memo;
+    REQUIRE(memo.intern(plain) != memo.intern(a));
+    REQUIRE(memo.intern(a) == memo.intern(b));
+}
+
+TEST_CASE("cached lattice operations agree with the direct ones", "[memo]") {
+    using namespace dsl_syntax;
+    const EbpfDomain a = numbers({r0.svalue >= 0, r0.svalue <= 5});
+    const EbpfDomain b = numbers({r0.svalue >= 3, r0.svalue <= 9});
+    const EbpfDomain b_again = numbers({r0.svalue <= 9, r0.svalue >= 3});
+
+    StateMemo memo;
+    const std::array doms{&a, &b};
+    const std::array doms_again{&a, &b_again};
+    const EbpfDomain joined = memo.join(doms);
+    REQUIRE(memo.hits() == 0);
+    REQUIRE(memo.join(doms_again).identical(joined));
+    REQUIRE(memo.hits() == 1);
+    REQUIRE(joined.identical(EbpfDomain::join(doms)));
+
+    REQUIRE(memo.leq(a, joined) == (a <= joined));
+    REQUIRE(memo.leq(joined, a) == (joined <= a));
+    REQUIRE(memo.leq(b_again, joined));
+    REQUIRE(memo.widen(a, b).identical(a.widen(b)));
+    REQUIRE(memo.widen(a, b_again).identical(a.widen(b)));
+    REQUIRE(memo.hits() == 2);
+}
+
+TEST_CASE("states from different widenings are interned apart", "[memo]") {
+    using namespace dsl_syntax;
+    const Variable x = r0.svalue;
+    const Variable y = r1.svalue;
+    const Variable z = r1.uvalue;
+    // The widening drops x - z <= 1, and closing it derives x - z <= 10 through y. The next widening
+    // starts from the graph as the widening left it, without that edge.
+    const EbpfDomain left = numbers({x - z <= 1, x - y <= 5, y - z <= 5});
+    const EbpfDomain right = numbers({x - z <= 3, x - y <= 5, y - z <= 5});
+    const EbpfDomain widened = left.widen(right);
+    const EbpfDomain plain = numbers({x - z <= 10, x - y <= 5, y - z <= 5});
+    REQUIRE(widened <= plain);
+    REQUIRE(plain <= widened);
+    REQUIRE(!widened.identical(plain));
+
+    // Once x - y grows, only the graph that had x - z <= 10 of its own keeps it.
+    const EbpfDomain next = numbers({x - z <= 10, x - y <= 6, y - z <= 5});
+    REQUIRE(plain.widen(next) <= widened.widen(next));
+    REQUIRE(!(widened.widen(next) <= plain.widen(next)));
+
+    StateMemo memo;
+    REQUIRE(memo.intern(widened) != memo.intern(plain));
+    REQUIRE(memo.widen(plain, next).identical(plain.widen(next)));
+    REQUIRE(memo.widen(widened, next).identical(widened.widen(next)));
+    REQUIRE(memo.hits() == 0);
+}
+
+TEST_CASE("a memoized analysis computes the same invariants", "[memo]") {
+    VerifierOptions options;
+    const Program prog = Program::from_sequence(nested_loops(), default_info(), options);
+    const AnalysisResult plain = analyze(AnalysisContext{prog, options});
+    options.memoize_lattice_operations = true;
+    const AnalysisResult memoized = analyze(AnalysisContext{prog, options});
+
+    REQUIRE(!memoized.failed);
+    REQUIRE(memoized.memo_hits > 0);
+    REQUIRE(plain.memo_hits == 0);
+    for (const auto& [label, inv] : plain.invariants) {
+        REQUIRE(memoized.invariant_at(label) == plain.invariant_at(label));
+    }
+}
@@ -0,0 +1,80 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+//
+// Fail-fast analysis (VerifierOptions::stop_on_first_error): the analysis stops at the first
+// failing assertion and marks its result as partial.
+
+#include <catch2/catch_all.hpp>
+
+#include "crab/var_registry.hpp"
+#include "test/test_programs.hpp"
+
+using namespace prevail;
+using namespace program_test;
+
+namespace {
+
+// if (r1 == 0) { r0 += r4 } else { r0 += r3 }; both additions fail, r3 and r4 having no known type.
+InstructionSeq two_failing_branches() {
+    InstructionSeq seq;
+    seq.push_back(
+        at(0, Jmp{.cond = Condition{.op = Condition::Op::EQ, .left = Reg{1}, .right = Imm{0}, .is64 = true},
+                  .target = Label{3}}));
+    seq.push_back(at(1, add(0, Reg{3})));
+    seq.push_back(at(2, Exit{}));
+    seq.push_back(at(3, add(0, Reg{4})));
+    seq.push_back(at(4, Exit{}));
+    return seq;
+}
+
+size_t count_errors(const AnalysisResult& result) {
+    size_t errors = 0;
+    for (const auto& inv : result.invariants.values()) {
+        errors += inv.error.has_value();
+    }
+    return errors;
+}
+
+AnalysisResult analyze_with(const InstructionSeq& seq, const VerifierOptions& options) {
+    const AnalysisContext context = context_of(seq, options);
+    const EbpfDomain entry = EbpfDomain::from_constraints({{variable_registry.type_reg(1), TypeSet{T_NUM}}}, {});
+    return analyze(entry, context);
+}
+
+} // namespace
+
+TEST_CASE("stop_on_first_error stops at the first error and marks the result partial", "[stop_on_first_error]") {
+    VerifierOptions options;
+    const AnalysisResult full = analyze_with(two_failing_branches(), options);
+    REQUIRE(full.failed);
+    REQUIRE(!full.partial);
+    REQUIRE(count_errors(full) == 2);
+
+    options.stop_on_first_error = true;
+    const AnalysisResult partial = analyze_with(two_failing_branches(), options);
+    REQUIRE(partial.failed);
+    REQUIRE(partial.partial);
+    REQUIRE(count_errors(partial) == 1);
+    const auto error = partial.find_first_error();
+    REQUIRE(error.has_value());
+    REQUIRE(error->where.has_value());
+    REQUIRE(full.invariants.find(*error->where)->error.has_value());
+
+    options.analysis_threads = 4;
+    const AnalysisResult parallel = analyze_with(two_failing_branches(), options);
+    REQUIRE(parallel.failed);
+    REQUIRE(parallel.partial);
+    REQUIRE(parallel.find_first_error().has_value());
+}
+
+TEST_CASE("stop_on_first_error does not change the result of a passing program", "[stop_on_first_error]") {
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(0, Imm{0})));
+    seq.push_back(at(1, Exit{}));
+    VerifierOptions options;
+    options.stop_on_first_error = true;
+    const AnalysisResult result = analyze_with(seq, options);
+    REQUIRE(!result.failed);
+    REQUIRE(!result.partial);
+    REQUIRE(result.exit_value == Interval{0});
+}
@@ -128,3 +128,23 @@ TEST_CASE("Edge case subsumption with bottom and mixed types", "[subsumption][la
     require_not_subsumes({{r0_type, TypeSet{T_NUM, T_CTX, T_PACKET, T_STACK, T_SHARED}}}, {},
                          {{r0_type, TypeSet{T_SHARED}}}, {});
 }
+
+TEST_CASE("Subsumption of copies and of bounds in other packs", "[subsumption][lattice]") {
+    using namespace dsl_syntax;
+    const TypeRestrictions nums{{r0_type, TypeSet{T_NUM}}, {r1_type, TypeSet{T_NUM}}};
+    const EbpfDomain a = EbpfDomain::from_constraints(nums, {r0.svalue >= 0, r0.svalue <= 10, r1.svalue <= r0.svalue});
+    // A copy shares its state with the original.
+    const EbpfDomain copy = a;
+    REQUIRE(copy <= a);
+    REQUIRE(a <= copy);
+
+    // Same relation, narrower range: rejected by the bounds alone.
+    require_not_subsumes(nums, {r0.svalue >= 0, r0.svalue <= 10, r1.svalue <= r0.svalue}, nums,
+                         {r0.svalue >= 0, r0.svalue <= 5, r1.svalue <= r0.svalue});
+    require_subsumes(nums, {r0.svalue >= 0, r0.svalue <= 5, r1.svalue <= r0.svalue}, nums,
+                     {r0.svalue >= 0, r0.svalue <= 10, r1.svalue <= r0.svalue});
+
+    // Same bounds, missing relation: only the aligned packs tell them apart.
+    require_not_subsumes(nums, {r0.svalue >= 0, r0.svalue <= 10, r1.svalue >= 0, r1.svalue <= 10}, nums,
+                         {r0.svalue >= 0, r0.svalue <= 10, r1.svalue >= 0, r1.svalue <= 10, r1.svalue <= r0.svalue});
+}
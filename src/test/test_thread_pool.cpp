@@ -0,0 +1,65 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#include "crab/var_registry.hpp"
+#include "crab_utils/thread_pool.hpp"
+
+using namespace prevail;
+
+TEST_CASE("thread pool runs every task, including tasks submitted by tasks", "[thread_pool]") {
+    ThreadPool pool{4};
+    std::atomic<int> count{0};
+    // A binary fan-out of depth 8: 2^9 - 1 tasks, most of them submitted from workers.
+    std::function<void(int)> spawn = [&](const int depth) {
+        ++count;
+        if (depth > 0) {
+            pool.submit([&, depth] { spawn(depth - 1); });
+            pool.submit([&, depth] { spawn(depth - 1); });
+        }
+    };
+    pool.submit([&] { spawn(8); });
+    pool.wait();
+    REQUIRE(count == 511);
+
+    // The pool is reusable after wait().
+    pool.submit([&] { ++count; });
+    pool.wait();
+    REQUIRE(count == 512);
+}
+
+TEST_CASE("thread pool rethrows the first task exception from wait", "[thread_pool]") {
+    ThreadPool pool{2};
+    std::atomic<int> count{0};
+    pool.submit([] { throw std::runtime_error("task failed"); });
+    for (int i = 0; i < 16; ++i) {
+        pool.submit([&] { ++count; });
+    }
+    REQUIRE_THROWS_WITH(pool.wait(), "task failed");
+    REQUIRE(count == 16);
+    REQUIRE_NOTHROW(pool.wait());
+}
+
+TEST_CASE("worker threads bound to a registry intern into it", "[thread_pool]") {
+    VariableRegistry& registry = variable_registry;
+    const size_t counters_before = registry.get_loop_counters().size();
+    {
+        const VariableRegistrySharing sharing{registry};
+        ThreadPool pool{4};
+        for (int i = 0; i < 64; ++i) {
+            pool.submit([&registry, i] {
+                const VariableRegistryBinding binding{registry};
+                (void)variable_registry.loop_counter("pool-test-" + std::to_string(i % 8));
+            });
+        }
+        pool.wait();
+    }
+    // Every worker interned into the caller's registry, and concurrent interning of one name
+    // yielded a single variable.
+    REQUIRE(registry.get_loop_counters().size() == counters_before + 8);
+}
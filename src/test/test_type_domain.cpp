@@ -3,6 +3,8 @@
 
 // Unit tests for the DSU-based TypeDomain.
 
+#include <array>
+
 #include <catch2/catch_all.hpp>
 
 #include "crab/type_domain.hpp"
@@ -71,6 +73,25 @@ TEST_CASE("havoc detaches from equality class", "[type_domain]") {
     REQUIRE(td.get_type(r0) == T_CTX); // r0 unchanged
 }
 
+TEST_CASE("copies share state until one of them changes", "[type_domain]") {
+    TypeDomain td;
+    td.assign_type(r0, T_STACK);
+    td.assign_type(r1, r0);
+
+    TypeDomain copy = td;
+    copy.havoc_type(r1);
+    copy.assign_type(r2, T_NUM);
+    REQUIRE(td.same_type(r0, r1));
+    REQUIRE(!td.get_type(r2).has_value());
+    REQUIRE(!copy.same_type(r0, r1));
+    REQUIRE(copy.get_type(r2) == T_NUM);
+
+    copy = td;
+    copy.restrict_to(reg_type(r0), TypeSet{T_NUM});
+    REQUIRE(copy.is_bottom());
+    REQUIRE(td.get_type(r1) == T_STACK);
+}
+
 // ============================================================================
 // iterate_types
 // ============================================================================
@@ -340,6 +361,31 @@ TEST_CASE("join with bottom is identity", "[type_domain][join]") {
     REQUIRE(j.get_type(r0) == T_CTX);
 }
 
+TEST_CASE("n-ary join keeps equalities common to all operands", "[type_domain][join]") {
+    // A: r0=r1={num}; B: r0=r1={ctx}, r2={num}; C: r0=r1=r2={stack}
+    TypeDomain a, b, c;
+    a.assign_type(r0, T_NUM);
+    a.assign_type(r1, r0);
+    b.assign_type(r0, T_CTX);
+    b.assign_type(r1, r0);
+    b.assign_type(r2, T_NUM);
+    c.assign_type(r0, T_STACK);
+    c.assign_type(r1, r0);
+    c.assign_type(r2, r0);
+    TypeDomain bot;
+    bot.assign_type(r0, T_CTX);
+    bot.restrict_to(reg_type(r0), TypeSet{T_NUM});
+
+    const std::array doms{&a, &bot, &b, &c};
+    const TypeDomain j = TypeDomain::join(doms);
+    REQUIRE(j.same_type(r0, r1));
+    REQUIRE(!j.same_type(r0, r2));
+    REQUIRE(j.iterate_types(r0).size() == 3);
+    const TypeDomain folded = (a | b) | c;
+    REQUIRE(j <= folded);
+    REQUIRE(folded <= j);
+}
+
 // ============================================================================
 // Meet
 // ============================================================================
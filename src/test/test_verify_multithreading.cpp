@@ -3,6 +3,8 @@
 
 #include <string>
 #include <thread>
+#include <variant>
+#include <vector>
 
 #include "test_verify.hpp"
 
@@ -147,3 +149,26 @@ TEST_CASE("multi-program parallel via AnalysisContext", "[verify][multithreading
     REQUIRE(res2);
     REQUIRE(res3);
 }
+
+// verify_all analyzes the programs of one object on a thread pool; each program must get the
+// verdict a sequential verify() gives it, reported in object order whatever the completion order.
+TEST_CASE("verify_all matches sequential verification in object order", "[verify][multithreading]") {
+    prevail::ElfObject elf{"ebpf-samples/bpf_cilium_test/bpf_netdev.o", {}, &prevail::g_ebpf_platform_linux};
+    const std::vector<prevail::ProgramVerification> results = prevail::verify_all(elf, {}, 4);
+    const std::vector<prevail::RawProgram>& raw_progs = elf.get_programs();
+    REQUIRE(results.size() == raw_progs.size());
+    REQUIRE(results.size() > 1);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const prevail::ProgramVerification& res = results[i];
+        INFO(res.section_name << "/" << res.function_name);
+        REQUIRE(res.section_name == raw_progs[i].section_name);
+        REQUIRE(res.function_name == raw_progs[i].function_name);
+        REQUIRE_FALSE(res.load_error);
+
+        auto prog_or_error = prevail::unmarshal(raw_progs[i], {});
+        const auto inst_seq = std::get_if<prevail::InstructionSeq>(&prog_or_error);
+        REQUIRE(inst_seq);
+        const auto prog = prevail::Program::from_sequence(*inst_seq, raw_progs[i].info, {});
+        REQUIRE(res.failed == !prevail::verify(prog, {}));
+    }
+}
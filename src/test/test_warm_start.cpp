@@ -0,0 +1,70 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+//
+// Warm-started analysis: loop-head invariants exported from one analysis seed the
+// matching loops of a later one, which must reach the same verdict and exit state.
+
+#include <catch2/catch_all.hpp>
+
+#include "test/test_programs.hpp"
+
+using namespace prevail;
+using namespace program_test;
+
+TEST_CASE("a stable loop invariant warm-starts an identical loop", "[warm_start]") {
+    const AnalysisContext context = context_of(counting_loop());
+    const AnalysisResult cold = analyze(context);
+    const LoopHeadInvariants exported = cold.loop_head_invariants(context.program);
+    REQUIRE(exported.size() == 1);
+    REQUIRE(cold.warm_started_loops == 0);
+
+    const AnalysisResult warm = analyze(context, exported);
+    REQUIRE(warm.warm_started_loops == 1);
+    REQUIRE(warm.failed == cold.failed);
+    REQUIRE(warm.exit_value == cold.exit_value);
+    REQUIRE(warm.invariant_at(Label{4}) == cold.invariant_at(Label{4}));
+}
+
+TEST_CASE("a warm-start candidate that is not inductive falls back to normal iteration", "[warm_start]") {
+    // Same loop at the same labels, but entered with r0 = 50: the exported head state does not
+    // cover the new entry state and must be rejected.
+    const AnalysisContext original = context_of(counting_loop());
+    const LoopHeadInvariants exported = analyze(original).loop_head_invariants(original.program);
+
+    const AnalysisContext changed = context_of(counting_loop(50));
+    const AnalysisResult cold = analyze(changed);
+    const AnalysisResult warm = analyze(changed, exported);
+    REQUIRE(warm.warm_started_loops == 0);
+    REQUIRE(warm.failed == cold.failed);
+    REQUIRE(warm.exit_value == cold.exit_value);
+    REQUIRE(warm.invariant_at(Label{4}) == cold.invariant_at(Label{4}));
+}
+
+TEST_CASE("a loop moved by code inserted before it still warm-starts", "[warm_start]") {
+    const AnalysisContext original = context_of(counting_loop());
+    const LoopHeadInvariants exported = analyze(original).loop_head_invariants(original.program);
+
+    // The counting loop two instructions further down, with its jump targets moved with it. The
+    // inserted instructions only write r0, which the loop overwrites, so its entry state is the same.
+    InstructionSeq seq;
+    seq.push_back(at(0, mov(0, Imm{7})));
+    seq.push_back(at(1, add(0, Imm{1})));
+    seq.push_back(at(2, mov(0, Imm{0})));
+    seq.push_back(at(3, jump_if_ge(0, 10, 6)));
+    seq.push_back(at(4, add(0, Imm{1})));
+    seq.push_back(at(5, Jmp{.target = Label{3}}));
+    seq.push_back(at(6, Exit{}));
+    const AnalysisContext shifted = context_of(seq);
+    REQUIRE(shifted.program.cfg().size() != original.program.cfg().size());
+
+    const AnalysisResult cold = analyze(shifted);
+    const LoopHeadInvariants reexported = cold.loop_head_invariants(shifted.program);
+    REQUIRE(reexported.size() == 1);
+    REQUIRE(reexported.begin()->first == exported.begin()->first);
+
+    const AnalysisResult warm = analyze(shifted, exported);
+    REQUIRE(warm.warm_started_loops == 1);
+    REQUIRE(warm.failed == cold.failed);
+    REQUIRE(warm.exit_value == cold.exit_value);
+    REQUIRE(warm.invariant_at(Label{6}) == cold.invariant_at(Label{6}));
+}
@@ -47,3 +47,62 @@ YAML_CASE("test-data/uninit.yaml")
 YAML_CASE("test-data/unop.yaml")
 YAML_CASE("test-data/unsigned.yaml")
 YAML_CASE("test-data/nonconvex.yaml")
+
+// The analysis modes below must reproduce the verdict, messages and invariants that each case expects
+// of the default analysis. YAML_CASE_WITH(mode, path) runs a suite with its options changed by `mode`.
+// Cases with observations read interior invariants, so they are skipped in modes that do not retain them.
+namespace {
+
+// VerifierOptions::retain_invariants == false: only the verdict and the exit invariant are kept.
+void verdict_mode(prevail::VerifierOptions& options) { options.retain_invariants = false; }
+
+// The parallel engine (VerifierOptions::analysis_threads > 1).
+void parallel_analysis(prevail::VerifierOptions& options) { options.analysis_threads = 4; }
+
+// VerifierOptions::summarize_local_calls: inlined calls may copy the results of an earlier call.
+void call_summaries(prevail::VerifierOptions& options) { options.summarize_local_calls = true; }
+
+// VerifierOptions::defer_loop_checks: the invalid states of a failing loop must not flow out of it.
+void deferred_loop_checks(prevail::VerifierOptions& options) { options.defer_loop_checks = true; }
+
+} // namespace
+
+#define YAML_CASE_WITH(mode, path)                                                                \
+    TEST_CASE("YAML suite with " #mode ": " path, "[yaml][" #mode "]") {                          \
+        prevail::foreach_suite(path, [&](const prevail::TestCase& test_case) {                    \
+            prevail::TestCase changed = test_case;                                                \
+            mode(changed.options);                                                                \
+            if (!changed.options.retain_invariants && !changed.observations.empty()) {            \
+                return;                                                                           \
+            }                                                                                     \
+            DYNAMIC_SECTION(test_case.name) {                                                     \
+                std::optional<prevail::Failure> failure = prevail::run_yaml_test_case(changed);   \
+                if (failure) {                                                                    \
+                    std::cout << "test case: " << test_case.name << "\n";                         \
+                    prevail::print_failure(*failure);                                             \
+                }                                                                                 \
+                REQUIRE(!failure);                                                                \
+            }                                                                                     \
+        });                                                                                       \
+    }
+
+YAML_CASE_WITH(verdict_mode, "test-data/calllocal.yaml")
+YAML_CASE_WITH(verdict_mode, "test-data/jump.yaml")
+YAML_CASE_WITH(verdict_mode, "test-data/loop.yaml")
+YAML_CASE_WITH(verdict_mode, "test-data/packet.yaml")
+YAML_CASE_WITH(verdict_mode, "test-data/uninit.yaml")
+
+YAML_CASE_WITH(parallel_analysis, "test-data/calllocal.yaml")
+YAML_CASE_WITH(parallel_analysis, "test-data/jump.yaml")
+YAML_CASE_WITH(parallel_analysis, "test-data/loop.yaml")
+YAML_CASE_WITH(parallel_analysis, "test-data/observe.yaml")
+YAML_CASE_WITH(parallel_analysis, "test-data/packet.yaml")
+
+YAML_CASE_WITH(call_summaries, "test-data/calllocal.yaml")
+
+YAML_CASE_WITH(deferred_loop_checks, "test-data/calllocal.yaml")
+YAML_CASE_WITH(deferred_loop_checks, "test-data/jump.yaml")
+YAML_CASE_WITH(deferred_loop_checks, "test-data/loop.yaml")
+YAML_CASE_WITH(deferred_loop_checks, "test-data/observe.yaml")
+YAML_CASE_WITH(deferred_loop_checks, "test-data/packet.yaml")
+YAML_CASE_WITH(deferred_loop_checks, "test-data/uninit.yaml")
@@ -0,0 +1,163 @@
+// Copyright (c) Prevail Verifier contributors.
+// SPDX-License-Identifier: MIT
+#include <catch2/catch_all.hpp>
+
+#include <optional>
+#include <vector>
+
+#include "arith/dsl_syntax.hpp"
+#include "crab/type_to_num.hpp"
+#include "crab/zone_domain.hpp"
+
+using namespace prevail;
+
+static const RegPack r0 = reg_pack(0);
+static const RegPack r1 = reg_pack(1);
+static const RegPack r2 = reg_pack(2);
+
+// ZoneDomain packs: unrelated variables do not share a graph
+TEST_CASE("zone domain keeps unrelated variables in separate packs", "[zone][packs]") {
+    using namespace dsl_syntax;
+
+    ZoneDomain a;
+    REQUIRE(a.add_constraint(r0.svalue >= 0));
+    REQUIRE(a.add_constraint(r1.svalue <= 10));
+    REQUIRE(a.add_constraint(r2.svalue == 3));
+    CHECK(a.pack_count() == 3);
+
+    // A relation merges the packs of its variables.
+    REQUIRE(a.add_constraint(r0.svalue <= r1.svalue));
+    CHECK(a.pack_count() == 2);
+    CHECK(a.entail(r0.svalue <= 10));
+
+    // The join drops the relation. r0 and r1 stay in one pack, related through their bounds.
+    ZoneDomain b;
+    REQUIRE(b.add_constraint(r0.svalue >= 0));
+    REQUIRE(b.add_constraint(r1.svalue <= 10));
+    REQUIRE(b.add_constraint(r2.svalue == 4));
+    REQUIRE(b.add_constraint(r1.svalue <= r0.svalue));
+    const ZoneDomain j = a | b;
+    CHECK(j.pack_count() == 2);
+    CHECK(a <= j);
+    CHECK(b <= j);
+    CHECK(j.entail(r2.svalue >= 3));
+    CHECK(j.entail(r2.svalue <= 4));
+    CHECK(!j.entail(r0.svalue <= r1.svalue));
+
+    // Copies share their packs, and modifying one leaves the other unchanged.
+    ZoneDomain c = a;
+    c.havoc(r2.svalue);
+    CHECK(c.pack_count() == 1);
+    CHECK(a.entail(r2.svalue == 3));
+}
+
+// ZoneDomain decides difference constraints from its graph, without copying itself
+TEST_CASE("zone domain entailment of difference constraints", "[zone][entail]") {
+    using namespace dsl_syntax;
+
+    ZoneDomain a;
+    REQUIRE(a.add_constraint(r0.svalue >= 0));
+    REQUIRE(a.add_constraint(r1.svalue <= 100));
+    REQUIRE(a.add_constraint(r0.svalue - r1.svalue <= 3));
+    REQUIRE(a.add_constraint(r1.svalue - r0.svalue <= 5));
+    REQUIRE(a.add_constraint(r2.svalue >= 0));
+    REQUIRE(a.add_constraint(r2.svalue <= 1));
+
+    // The difference of two variables of a pack is bounded by the edges between them.
+    CHECK(a.entail(r0.svalue <= r1.svalue + 3));
+    CHECK(a.entail(r1.svalue >= r0.svalue - 3));
+    CHECK(!a.entail(r0.svalue <= r1.svalue + 2));
+    CHECK(!a.entail(r0.svalue < r1.svalue + 3));
+    CHECK(a.entail(r0.svalue < r1.svalue + 4));
+    CHECK(a.entail(r0.svalue != r1.svalue + 4));
+    CHECK(!a.entail(r0.svalue - r1.svalue != 0));
+    CHECK(a.intersect(r0.svalue == r1.svalue + 3));
+    CHECK(!a.intersect(r0.svalue > r1.svalue + 3));
+    CHECK(!a.intersect(r1.svalue == r0.svalue + 6));
+    CHECK(a.intersect(r0.svalue - r1.svalue != 0));
+
+    // Variables of different packs are related through their intervals only.
+    CHECK(a.entail(r2.svalue - r0.svalue <= 1 + 5));
+    CHECK(!a.entail(r2.svalue - r0.svalue <= 0));
+    CHECK(a.intersect(r2.svalue - r0.svalue == 0));
+
+    // Other expressions are decided by adding their negation to a copy.
+    CHECK(a.entail(r0.svalue + r2.svalue - r1.svalue <= 4));
+    CHECK(!a.entail(r0.svalue + r2.svalue - r1.svalue <= 3));
+    CHECK(a.pack_count() == 2);
+}
+
+// ZoneDomain answers several entailment queries at once, and implications from its graph
+TEST_CASE("zone domain batch entailment and implication", "[zone][entail]") {
+    using namespace dsl_syntax;
+
+    ZoneDomain a;
+    REQUIRE(a.add_constraint(r0.svalue >= 0));
+    REQUIRE(a.add_constraint(r0.svalue <= 10));
+    REQUIRE(a.add_constraint(r1.svalue - r0.svalue <= 4));
+    REQUIRE(a.add_constraint(r2.svalue >= 1));
+
+    // The index of the first constraint that does not hold, in order, whichever way each is decided.
+    const std::vector all_hold{r0.svalue >= 0, r1.svalue <= r0.svalue + 4, r0.svalue + r2.svalue >= 1};
+    CHECK(a.first_not_entailed(all_hold) == std::nullopt);
+    const std::vector second_fails{r0.svalue <= 10, r1.svalue <= 13, r0.svalue >= 1};
+    CHECK(a.first_not_entailed(second_fails) == std::optional<std::size_t>(1));
+    const std::vector first_fails{r0.svalue + r2.svalue <= 5, r1.svalue <= r0.svalue};
+    CHECK(a.first_not_entailed(first_fails) == std::optional<std::size_t>(0));
+    CHECK(a.first_not_entailed(std::vector<LinearConstraint>{}) == std::nullopt);
+
+    // Premises on the same expression as the conclusion, up to a constant.
+    CHECK(a.implies(r0.svalue >= 5, r0.svalue > 4));
+    CHECK(!a.implies(r0.svalue >= 5, r0.svalue > 5));
+    CHECK(a.implies(r0.svalue == 3, r0.svalue != 4));
+    CHECK(a.implies(r1.svalue - r0.svalue >= 4, r1.svalue == r0.svalue + 4));
+    CHECK(!a.implies(r1.svalue - r0.svalue >= 3, r1.svalue == r0.svalue + 4));
+    // A premise that cannot hold implies anything; one that always holds implies what is entailed.
+    CHECK(a.implies(r0.svalue > 10, r2.svalue <= 0));
+    CHECK(a.implies(r1.svalue - r0.svalue >= 5, r2.svalue <= 0));
+    CHECK(a.implies(r0.svalue <= 20, r1.svalue <= 14));
+    CHECK(!a.implies(r0.svalue <= 20, r1.svalue <= 13));
+    // Other premises are added to a copy.
+    CHECK(a.implies(r0.svalue <= 2, r1.svalue <= 6));
+    CHECK(!a.implies(r0.svalue <= 2, r1.svalue <= 5));
+    CHECK(a.implies(r0.svalue + r2.svalue <= 2, r0.svalue <= 1));
+    CHECK(a.entail(r0.svalue <= 10));
+    CHECK(!a.entail(r0.svalue <= 9));
+}
+
+// The queries that read bounds and differences from the graph assume it is closed
+TEST_CASE("zone domain graphs are closed after each operation", "[zone][entail]") {
+    using namespace dsl_syntax;
+
+    ZoneDomain a;
+    REQUIRE(a.add_constraint(r0.svalue >= 0));
+    REQUIRE(a.add_constraint(r0.svalue <= 1));
+    REQUIRE(a.add_constraint(r1.svalue - r0.svalue <= 5));
+    REQUIRE(a.add_constraint(r2.svalue - r1.svalue <= 5));
+    CHECK(a.is_closed());
+    CHECK(a.entail(r2.svalue - r0.svalue <= 10));
+    CHECK(a.entail(r2.svalue <= 11));
+
+    ZoneDomain b;
+    REQUIRE(b.add_constraint(r0.svalue >= 0));
+    REQUIRE(b.add_constraint(r0.svalue <= 2));
+    REQUIRE(b.add_constraint(r1.svalue - r0.svalue <= 6));
+    REQUIRE(b.add_constraint(r2.svalue - r1.svalue <= 5));
+    REQUIRE(b.add_constraint(r2.svalue - r0.svalue <= 10));
+    CHECK(b.is_closed());
+
+    // The widening drops the bounds and differences that grew, and closes the vertices that lost them.
+    const ZoneDomain w = a.widen(b);
+    CHECK(w.is_closed());
+    CHECK(w.entail(r2.svalue - r0.svalue <= 10));
+    CHECK(!w.entail(r0.svalue <= 2));
+    const ZoneDomain ww = w.widen(b | w);
+    CHECK(ww.is_closed());
+    CHECK(ww.entail(r2.svalue - r0.svalue <= 10));
+
+    CHECK((a | b).is_closed());
+    const auto m = w.meet(a);
+    REQUIRE(m);
+    CHECK(m->is_closed());
+    CHECK(m->entail(r2.svalue <= 11));
+}
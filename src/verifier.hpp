@@ -13,6 +13,17 @@ namespace prevail {
 AnalysisResult analyze(const AnalysisContext& context);
 AnalysisResult analyze(const EbpfDomain& entry_invariant, const AnalysisContext& context);
 
+// Warm-started analysis: loops whose loop_structure_hash() matches an entry of `warm_start`
+// (typically AnalysisResult::loop_head_invariants() of a previous build) start from that
+// invariant when it is still inductive, skipping the widening phase.
+AnalysisResult analyze(const AnalysisContext& context, const LoopHeadInvariants& warm_start);
+
+// Single-pass check of a certificate (AnalysisResult::certificate, under
+// VerifierOptions::emit_certificate): each loop head starts from its certified invariant, which
+// must cover the states entering the loop and be preserved by its body, and every assertion is
+// checked once. Fails if the certificate was computed for another program or configuration.
+AnalysisResult check_certificate(const AnalysisContext& context, const InvariantCertificate& certificate);
+
 // Convenience overload that copies `prog` into a fresh AnalysisContext.
 // For repeated analysis of the same program, build one AnalysisContext and reuse it.
 AnalysisResult analyze(const Program& prog, const VerifierOptions& options);